@@ -0,0 +1,225 @@
+#include <string>
+
+#include "ast_visitor.h"
+#include "bench.h"
+#include "code_gen_visitor.h"
+#include "fused_semantic_visitor.h"
+#include "lexer.h"
+#include "logger.h"
+#include "mem_size_visitor.h"
+#include "parallel_semantic_pass.h"
+#include "parser.h"
+#include "program_gen.h"
+#include "source_buffer.h"
+#include "static_ast_visitor.h"
+#include "symbol_table_visitor.h"
+#include "token_array.h"
+#include "type_check_visitor.h"
+
+using namespace toy;
+
+// Counts the nodes of an AST in a plain depth-first traversal.
+class NodeCounter : public ASTVisitor {
+ public:
+  std::size_t count = 0;
+
+#define TOY_COUNT_NODE(Node)  \
+  void Visit(Node& node) override { \
+    ++count;                  \
+    DFS(node);                \
+  }
+  TOY_COUNT_NODE(AParamsNode)
+  TOY_COUNT_NODE(AddOpNode)
+  TOY_COUNT_NODE(ArithExprNode)
+  TOY_COUNT_NODE(IndiceList)
+  TOY_COUNT_NODE(AssignNode)
+  TOY_COUNT_NODE(ClassListNode)
+  TOY_COUNT_NODE(ClassNode)
+  TOY_COUNT_NODE(DimListNode)
+  TOY_COUNT_NODE(DimNode)
+  TOY_COUNT_NODE(FParamsListNode)
+  TOY_COUNT_NODE(FParamsNode)
+  TOY_COUNT_NODE(FloatNumNode)
+  TOY_COUNT_NODE(FuncBodyNode)
+  TOY_COUNT_NODE(FuncCallNode)
+  TOY_COUNT_NODE(FuncDefListNode)
+  TOY_COUNT_NODE(FuncDefNode)
+  TOY_COUNT_NODE(IdNode)
+  TOY_COUNT_NODE(IfStatNode)
+  TOY_COUNT_NODE(InheritListNode)
+  TOY_COUNT_NODE(IntNumNode)
+  TOY_COUNT_NODE(MainNode)
+  TOY_COUNT_NODE(MemberFuncDeclNode)
+  TOY_COUNT_NODE(MemberListNode)
+  TOY_COUNT_NODE(MemberVarDeclNode)
+  TOY_COUNT_NODE(MultOpNode)
+  TOY_COUNT_NODE(NotNode)
+  TOY_COUNT_NODE(ProgNode)
+  TOY_COUNT_NODE(ReadNode)
+  TOY_COUNT_NODE(RelExprNode)
+  TOY_COUNT_NODE(RelOpNode)
+  TOY_COUNT_NODE(ReturnNode)
+  TOY_COUNT_NODE(ScopeResNode)
+  TOY_COUNT_NODE(SignNode)
+  TOY_COUNT_NODE(StatListNode)
+  TOY_COUNT_NODE(TypeNode)
+  TOY_COUNT_NODE(VarDeclListNode)
+  TOY_COUNT_NODE(VarDeclNode)
+  TOY_COUNT_NODE(DataMemberNode)
+  TOY_COUNT_NODE(VarNode)
+  TOY_COUNT_NODE(WhileNode)
+  TOY_COUNT_NODE(WriteNode)
+#undef TOY_COUNT_NODE
+};
+
+// Counts the ids of an AST besides its nodes.
+class IdCounter : public NodeCounter {
+ public:
+  std::size_t ids = 0;
+
+  void Visit(IdNode& node) override {
+    ++ids;
+    NodeCounter::Visit(node);
+  }
+};
+
+// Counts the nodes like NodeCounter, dispatching on the node kinds.
+class StaticNodeCounter : public StaticASTVisitor<StaticNodeCounter> {
+ public:
+  std::size_t count = 0;
+
+  void DFS(ASTNode& node) {
+    ++count;
+    StaticASTVisitor<StaticNodeCounter>::DFS(node);
+  }
+};
+
+// Counts the ids like IdCounter, dispatching on the node kinds.
+class StaticIdCounter : public StaticASTVisitor<StaticIdCounter> {
+ public:
+  using StaticASTVisitor<StaticIdCounter>::Visit;
+  std::size_t count = 0;
+  std::size_t ids = 0;
+
+  void Visit(IdNode& node) {
+    ++ids;
+    DFS(node);
+  }
+
+  void DFS(ASTNode& node) {
+    ++count;
+    StaticASTVisitor<StaticIdCounter>::DFS(node);
+  }
+};
+
+// Traverses ast with virtual and with static dispatch, visiting every node
+// alike or ids apart.
+static void RunTraversals(const std::string& suffix, ASTNode& ast,
+                          std::size_t num_nodes) {
+  bench::Run("AST/traverse" + suffix, num_nodes, [&] {
+    NodeCounter counter;
+    ast.Accept(counter);
+    bench::DoNotOptimize(counter.count);
+  });
+  bench::Run("AST/traverse-static" + suffix, num_nodes, [&] {
+    StaticNodeCounter counter;
+    counter.Dispatch(ast);
+    bench::DoNotOptimize(counter.count);
+  });
+  bench::Run("AST/count-ids" + suffix, num_nodes, [&] {
+    IdCounter counter;
+    ast.Accept(counter);
+    bench::DoNotOptimize(counter.ids);
+  });
+  bench::Run("AST/count-ids-static" + suffix, num_nodes, [&] {
+    StaticIdCounter counter;
+    counter.Dispatch(ast);
+    bench::DoNotOptimize(counter.ids);
+  });
+}
+
+// Builds the AST of a large generated program, one item per node, then
+// traverses it, with virtual and with static dispatch, and runs the semantic
+// checks over it, likewise, the type checking and memory sizing either as two
+// traversals, fused in one or on a thread per core, then generates its code.
+int main() {
+  std::string text = bench::GenerateProgram(2000);
+  SourceBuffer src = SourceBuffer::FromString(text);
+  Lexer lexer(src, LexerMode::DFA);
+  TokenArray tokens = lexer.TokenizeAll();
+
+  NodeCounter counter;
+  Parser(tokens).Parse()->Accept(counter);
+  std::size_t num_nodes = counter.count;
+
+  bench::Run("AST/build", num_nodes, [&] {
+    Parser parser(tokens);
+    bench::DoNotOptimize(parser.Parse());
+  });
+  bench::Run("AST/build-recursive-descent", num_nodes, [&] {
+    Parser parser(tokens);
+    parser.SetMode(ParserMode::RECURSIVE_DESCENT);
+    bench::DoNotOptimize(parser.Parse());
+  });
+
+  auto ast = Parser(tokens).Parse();
+  RunTraversals("", *ast, num_nodes);
+  // Small enough for the nodes to stay in cache, which leaves the dispatch
+  // to be measured.
+  std::string small_text = bench::GenerateProgram(20);
+  SourceBuffer small_src = SourceBuffer::FromString(small_text);
+  auto small_ast =
+      Parser(Lexer(small_src, LexerMode::DFA).TokenizeAll()).Parse();
+  NodeCounter small_counter;
+  small_ast->Accept(small_counter);
+  RunTraversals("-small", *small_ast, small_counter.count);
+  bench::Run("AST/semantic-checks", num_nodes, [&] {
+    auto ast = Parser(tokens).Parse();
+    SymbolTableVisitor symtab_visitor;
+    ast->Accept(symtab_visitor);
+    TypeCheckVisitor typecheck_visitor;
+    ast->Accept(typecheck_visitor);
+    Logger::Clear();
+  });
+  bench::Run("AST/type-check-and-size", num_nodes, [&] {
+    auto ast = Parser(tokens).Parse();
+    SymbolTableVisitor symtab_visitor;
+    ast->Accept(symtab_visitor);
+    TypeCheckVisitor typecheck_visitor;
+    ast->Accept(typecheck_visitor);
+    MemSizeVisitor memsize_visitor;
+    ast->Accept(memsize_visitor);
+    Logger::Clear();
+  });
+  bench::Run("AST/type-check-and-size-fused", num_nodes, [&] {
+    auto ast = Parser(tokens).Parse();
+    SymbolTableVisitor symtab_visitor;
+    ast->Accept(symtab_visitor);
+    FusedSemanticVisitor fused_visitor;
+    ast->Accept(fused_visitor);
+    bench::DoNotOptimize(fused_visitor.Sized());
+    Logger::Clear();
+  });
+  bench::Run("AST/type-check-and-size-parallel", num_nodes, [&] {
+    auto ast = Parser(tokens).Parse();
+    SymbolTableVisitor symtab_visitor;
+    ast->Accept(symtab_visitor);
+    ParallelSemanticPass parallel_pass(0);
+    parallel_pass.Run(*ast);
+    bench::DoNotOptimize(parallel_pass.Sized());
+    Logger::Clear();
+  });
+
+  SymbolTableVisitor symtab_visitor;
+  ast->Accept(symtab_visitor);
+  TypeCheckVisitor typecheck_visitor;
+  ast->Accept(typecheck_visitor);
+  MemSizeVisitor memsize_visitor;
+  ast->Accept(memsize_visitor);
+  Logger::Clear();
+  bench::Run("AST/code-gen", num_nodes, [&] {
+    CodeGenVisitor codegen_visitor;
+    ast->Accept(codegen_visitor);
+  });
+  return 0;
+}
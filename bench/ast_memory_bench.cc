@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "lexer.h"
+#include "logger.h"
+#include "parser.h"
+#include "program_gen.h"
+#include "source_buffer.h"
+#include "symbol_table_visitor.h"
+#include "token_array.h"
+#include "type_check_visitor.h"
+
+using namespace toy;
+
+// Bytes allocated with operator new and not freed yet.
+static std::size_t live_bytes = 0;
+
+// Every block starts with its size, padded to keep the alignment of new.
+static const std::size_t HEADER_SIZE = alignof(std::max_align_t);
+
+void* operator new(std::size_t size) {
+  char* block = static_cast<char*>(std::malloc(HEADER_SIZE + size));
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<std::size_t*>(block) = size;
+  live_bytes += size;
+  return block + HEADER_SIZE;
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  char* block = static_cast<char*>(ptr) - HEADER_SIZE;
+  live_bytes -= *reinterpret_cast<std::size_t*>(block);
+  std::free(block);
+}
+
+static std::size_t CountNodes(const ASTNode& node) {
+  std::size_t count = 1;
+  for (const auto& child : node.Children()) {
+    count += CountNodes(*child);
+  }
+  return count;
+}
+
+static void Report(const std::string& name, std::size_t bytes,
+                   std::size_t nodes) {
+  std::cout << std::left << std::setw(40) << name << std::right
+            << std::setw(12) << std::fixed << std::setprecision(2)
+            << static_cast<double>(bytes) / nodes << " bytes/node"
+            << std::setw(12) << bytes / 1024 << " KiB" << std::endl;
+}
+
+// Reports the heap memory taken by the AST of a generated program of about
+// 100k lines, once built and once its types are checked.
+int main() {
+  std::string text = bench::GenerateProgram(3700);
+  SourceBuffer src = SourceBuffer::FromString(text);
+  Lexer lexer(src, LexerMode::DFA);
+  TokenArray tokens = lexer.TokenizeAll();
+
+  std::size_t before = live_bytes;
+  auto ast = Parser(tokens).Parse();
+  std::size_t parsed = live_bytes;
+  std::size_t num_nodes = CountNodes(*ast);
+  std::cout << std::count(text.begin(), text.end(), '\n') << " lines, "
+            << num_nodes << " nodes" << std::endl;
+  Report("AST/memory-parsed", parsed - before, num_nodes);
+
+  {
+    SymbolTableVisitor symtab_visitor;
+    ast->Accept(symtab_visitor);
+    TypeCheckVisitor typecheck_visitor;
+    ast->Accept(typecheck_visitor);
+  }
+  Logger::Clear();
+  Report("AST/memory-type-checked", live_bytes - before, num_nodes);
+  return 0;
+}
@@ -0,0 +1,55 @@
+#ifndef TOY_BENCH_BENCH_H_
+#define TOY_BENCH_BENCH_H_
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace toy {
+namespace bench {
+
+// Keeps the compiler from optimizing away the computation of val.
+template <typename T>
+inline void DoNotOptimize(const T& val) {
+  asm volatile("" : : "r"(&val) : "memory");
+}
+
+// Calls fn, which processes items items per call, repeatedly in several
+// rounds of at least 200ms each, and prints the time per item and the
+// throughput of the fastest round, which is the least disturbed by noise.
+template <typename Fn>
+void Run(const std::string& name, std::size_t items, Fn fn) {
+  using Clock = std::chrono::steady_clock;
+  const int ROUNDS = 5;
+  fn();  // Warm up caches and any lazily built state.
+  double best_ns_per_item = 0;
+  std::size_t total_iters = 0;
+  for (int round = 0; round < ROUNDS; ++round) {
+    std::size_t iters = 0;
+    Clock::duration elapsed(0);
+    Clock::time_point start = Clock::now();
+    while (elapsed < std::chrono::milliseconds(200)) {
+      fn();
+      ++iters;
+      elapsed = Clock::now() - start;
+    }
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    double ns_per_item = ns / (iters * items);
+    if (round == 0 || ns_per_item < best_ns_per_item) {
+      best_ns_per_item = ns_per_item;
+    }
+    total_iters += iters;
+  }
+  std::cout << std::left << std::setw(40) << name << std::right
+            << std::setw(12) << std::fixed << std::setprecision(2)
+            << best_ns_per_item << " ns/item" << std::setw(12)
+            << 1e3 / best_ns_per_item << " M items/s" << std::setw(10)
+            << total_iters << " iters" << std::endl;
+}
+
+}  // namespace bench
+}  // namespace toy
+
+#endif  // TOY_BENCH_BENCH_H_
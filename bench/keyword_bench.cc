@@ -0,0 +1,68 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "lexer.h"
+#include "source_buffer.h"
+
+using namespace toy;
+
+// The string compare chain Lexer::IsReserved used before the keyword switch.
+static bool IsReservedCompareChain(const std::string& word) {
+  return word == "if" || word == "then" || word == "else" || word == "while" ||
+         word == "class" || word == "integer" || word == "float" ||
+         word == "do" || word == "end" || word == "public" ||
+         word == "private" || word == "or" || word == "and" || word == "not" ||
+         word == "read" || word == "write" || word == "return" ||
+         word == "main" || word == "inherits" || word == "local" ||
+         word == "void";
+}
+
+// A mix of identifiers and reserved words, roughly one keyword in four.
+static std::vector<std::string> MakeWords(std::size_t n) {
+  const std::vector<std::string> ids = {
+      "x",       "idx",    "counter", "result",  "arr",  "node",
+      "integer_", "tmp1",  "value",   "i",       "sum",  "polynomial",
+      "evaluate", "coef",  "len",     "writer",  "ends", "floats"};
+  const std::vector<std::string> kws = {"if",    "then",  "else", "while",
+                                        "do",    "end",   "read", "write",
+                                        "local", "float", "integer"};
+  std::vector<std::string> words;
+  for (std::size_t i = 0; i < n; ++i) {
+    words.push_back(i % 4 == 0 ? kws[i % kws.size()] : ids[i % ids.size()]);
+  }
+  return words;
+}
+
+int main() {
+  std::vector<std::string> words = MakeWords(4096);
+
+  bench::Run("IsReserved/compare-chain", words.size(), [&] {
+    std::size_t n = 0;
+    for (const auto& word : words) {
+      n += IsReservedCompareChain(word);
+    }
+    bench::DoNotOptimize(n);
+  });
+  bench::Run("IsReserved/switch", words.size(), [&] {
+    std::size_t n = 0;
+    for (const auto& word : words) {
+      n += Lexer::IsReserved(word);
+    }
+    bench::DoNotOptimize(n);
+  });
+
+  std::ostringstream oss;
+  for (const auto& word : words) {
+    oss << word << ' ';
+  }
+  SourceBuffer src = SourceBuffer::FromString(oss.str());
+  bench::Run("Lexer/identifier-heavy source", words.size(), [&] {
+    Lexer lexer(src);
+    while (lexer.HasNext()) {
+      bench::DoNotOptimize(lexer.NextToken());
+    }
+  });
+  return 0;
+}
@@ -0,0 +1,36 @@
+#include <sstream>
+#include <string>
+
+#include "bench.h"
+#include "lexer.h"
+#include "program_gen.h"
+#include "source_buffer.h"
+
+using namespace toy;
+
+// Lexes the whole source, one item per byte.
+int main() {
+  std::string text = bench::GenerateProgram(2000);
+  SourceBuffer src = SourceBuffer::FromString(text);
+
+  bench::Run("Lexer/stream", text.size(), [&] {
+    std::istringstream is(text);
+    Lexer lexer(is);
+    while (lexer.HasNext()) {
+      bench::DoNotOptimize(lexer.NextToken());
+    }
+  });
+  bench::Run("Lexer/buffer", text.size(), [&] {
+    Lexer lexer(src);
+    while (lexer.HasNext()) {
+      bench::DoNotOptimize(lexer.NextToken());
+    }
+  });
+  bench::Run("Lexer/buffer-dfa", text.size(), [&] {
+    Lexer lexer(src, LexerMode::DFA);
+    while (lexer.HasNext()) {
+      bench::DoNotOptimize(lexer.NextToken());
+    }
+  });
+  return 0;
+}
@@ -0,0 +1,172 @@
+#include <cstdio>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "grammar.h"
+#include "lexer.h"
+#include "parse_table.h"
+#include "parser.h"
+#include "parser_gen.h"
+#include "program_gen.h"
+#include "source_buffer.h"
+#include "token_array.h"
+#include "trace_sink.h"
+
+using namespace toy;
+
+// Runs an LL(1) recognizer over tokens driven by the generator's table and
+// returns whether the tokens were accepted.
+static bool Recognize(const ParserGenerator& pgen, const TokenArray& tokens) {
+  std::stack<Symbol> stack;
+  stack.push(Symbol(SymbolType::END));
+  stack.push(Symbol(SymbolType::START));
+  std::size_t pos = 0;
+  while (stack.top().Type() != SymbolType::END) {
+    Symbol top = stack.top();
+    Token tk = tokens.At(pos);
+    if (top.Type() == SymbolType::ACTION ||
+        top.Type() == SymbolType::EPSILON) {
+      stack.pop();
+    } else if (top.Type() == SymbolType::TERM) {
+      if (top != tk) {
+        return false;
+      }
+      stack.pop();
+      ++pos;
+    } else {
+      Symbol col(tk);
+      if (!pgen.TableValid(top, col)) {
+        return false;
+      }
+      const Production& prod = pgen.TableAt(top, col);
+      stack.pop();
+      for (auto it = prod.second.rbegin(); it != prod.second.rend(); ++it) {
+        stack.push(*it);
+      }
+    }
+  }
+  return true;
+}
+
+// Runs an LL(1) recognizer over tokens driven by table, expanding
+// productions by reversing their rhs onto a std::stack.
+static bool RecognizeRhs(const ParseTable& table, const TokenArray& tokens) {
+  std::stack<int> stack;
+  stack.push(table.End());
+  stack.push(table.Start());
+  std::size_t pos = 0;
+  while (stack.top() != table.End()) {
+    int top = stack.top();
+    int term = table.TermOf(tokens.types[pos]);
+    if (table.IsAction(top)) {
+      stack.pop();
+    } else if (table.IsTerm(top)) {
+      if (top != term) {
+        return false;
+      }
+      stack.pop();
+      ++pos;
+    } else {
+      int prod = table.At(top, term);
+      if (prod == -1) {
+        return false;
+      }
+      stack.pop();
+      const int16_t* rhs = table.RhsBegin(prod);
+      for (long i = table.RhsEnd(prod) - rhs - 1; i >= 0; --i) {
+        if (rhs[i] != table.Epsilon()) stack.push(rhs[i]);
+      }
+    }
+  }
+  return true;
+}
+
+// Same as RecognizeRhs, pushing the table's expansions onto a vector.
+static bool RecognizeExpansion(const ParseTable& table,
+                               const TokenArray& tokens) {
+  std::vector<int16_t> stack;
+  stack.reserve(256);
+  stack.push_back(table.End());
+  stack.push_back(table.Start());
+  std::size_t pos = 0;
+  while (stack.back() != table.End()) {
+    int top = stack.back();
+    int term = table.TermOf(tokens.types[pos]);
+    if (table.IsAction(top)) {
+      stack.pop_back();
+    } else if (table.IsTerm(top)) {
+      if (top != term) {
+        return false;
+      }
+      stack.pop_back();
+      ++pos;
+    } else {
+      int prod = table.At(top, term);
+      if (prod == -1) {
+        return false;
+      }
+      stack.pop_back();
+      stack.insert(stack.end(), table.ExpansionBegin(prod),
+                   table.ExpansionEnd(prod));
+    }
+  }
+  return true;
+}
+
+// Builds the parser generator, one item per grammar rule, then parses a
+// generated program, one item per token.
+int main() {
+  Grammar grammar;
+  std::size_t num_rules = 0;
+  for (auto it = grammar.Begin(); it != grammar.End(); ++it) {
+    num_rules += it->second.size();
+  }
+  bench::Run("ParserGenerator/build", num_rules, [&] {
+    ParserGenerator pgen(grammar);
+    bench::DoNotOptimize(pgen);
+  });
+
+  std::string text = bench::GenerateProgram(500);
+  SourceBuffer src = SourceBuffer::FromString(text);
+  Lexer lexer(src);
+  TokenArray tokens = lexer.TokenizeAll();
+
+  ParserGenerator pgen(grammar);
+  if (!Recognize(pgen, tokens)) {
+    std::cerr << "Generated program was rejected" << std::endl;
+    return 1;
+  }
+  bench::Run("ParserGenerator/recognize", tokens.Size(), [&] {
+    bench::DoNotOptimize(Recognize(pgen, tokens));
+  });
+  const ParseTable& table = ParseTable::Embedded();
+  if (!RecognizeRhs(table, tokens) || !RecognizeExpansion(table, tokens)) {
+    std::cerr << "Generated program was rejected" << std::endl;
+    return 1;
+  }
+  bench::Run("ParseTable/recognize-rhs", tokens.Size(), [&] {
+    bench::DoNotOptimize(RecognizeRhs(table, tokens));
+  });
+  bench::Run("ParseTable/recognize-expansion", tokens.Size(), [&] {
+    bench::DoNotOptimize(RecognizeExpansion(table, tokens));
+  });
+  bench::Run("Parser/parse", tokens.Size(), [&] {
+    Parser parser(tokens);
+    bench::DoNotOptimize(parser.Parse());
+  });
+  bench::Run("Parser/parse-derivation-log", tokens.Size(), [&] {
+    TraceSink sink("parse_bench_derivation");
+    Parser parser(tokens);
+    parser.SetDerivationLog(&sink);
+    bench::DoNotOptimize(parser.Parse());
+  });
+  std::remove("parse_bench_derivation");
+  bench::Run("Parser/parse-recursive-descent", tokens.Size(), [&] {
+    Parser parser(tokens);
+    parser.SetMode(ParserMode::RECURSIVE_DESCENT);
+    bench::DoNotOptimize(parser.Parse());
+  });
+  return 0;
+}
@@ -0,0 +1,98 @@
+#ifndef TOY_BENCH_PROGRAM_GEN_H_
+#define TOY_BENCH_PROGRAM_GEN_H_
+
+#include <string>
+
+namespace toy {
+namespace bench {
+
+// Returns a valid toy program with num_funcs free functions, each with a
+// comment banner, locals, a loop, a conditional and some arithmetic, and a
+// main that calls all of them.
+inline std::string GenerateProgram(int num_funcs) {
+  std::string src;
+  for (int i = 0; i < num_funcs; ++i) {
+    std::string name = "func" + std::to_string(i);
+    src += "/* =========================================================\n";
+    src += " * " + name + ": sums a series into an array and scales x.\n";
+    src += " * ========================================================= */\n";
+    src += name + "(integer n, float x) : integer\n";
+    src += "  local\n";
+    src += "    integer idx;\n";
+    src += "    integer acc;\n";
+    src += "    float scaled;\n";
+    src += "    integer series[16];\n";
+    src += "  do\n";
+    src += "    // Accumulate the series.\n";
+    src += "    acc = 0;\n";
+    src += "    idx = 0;\n";
+    src += "    while (idx < n)\n";
+    src += "    do\n";
+    src += "      acc = acc + idx * 2 - 1;\n";
+    src += "      series[idx] = acc;\n";
+    src += "      idx = idx + 1;\n";
+    src += "    end;\n";
+    src += "    if (acc > n * 100)\n";
+    src += "    then\n";
+    src += "      scaled = x * 1.5 + 0.25;\n";
+    src += "    else\n";
+    src += "      scaled = x - 2.0;\n";
+    src += "    ;\n";
+    src += "    return (acc + series[0]);\n";
+    src += "  end\n\n";
+  }
+  src += "main\n";
+  src += "  local\n";
+  src += "    integer res;\n";
+  src += "  do\n";
+  for (int i = 0; i < num_funcs; ++i) {
+    src += "    res = func" + std::to_string(i) + "(10, 1.5);\n";
+  }
+  src += "    write(res);\n";
+  src += "  end\n";
+  return src;
+}
+
+// Returns a valid toy program with a single free function whose body is
+// num_stats assignments and conditionals over a few locals, called by main.
+inline std::string GenerateLongFunction(int num_stats) {
+  std::string src;
+  src += "body(integer n, float x) : integer\n";
+  src += "  local\n";
+  src += "    integer a;\n";
+  src += "    integer b;\n";
+  src += "    float f;\n";
+  src += "    integer arr[8];\n";
+  src += "  do\n";
+  for (int i = 0; i < num_stats; ++i) {
+    switch (i % 4) {
+      case 0:
+        src += "    a = a + b * 2;\n";
+        break;
+      case 1:
+        src += "    b = arr[a] - 1;\n";
+        break;
+      case 2:
+        src += "    f = f * 1.5 + x;\n";
+        break;
+      case 3:
+        src += "    if (a < n) then a = a + 1; else b = b - 1;;\n";
+        break;
+    }
+  }
+  src += "    return (a);\n";
+  src += "  end\n\n";
+  src += "main\n";
+  src += "  local\n";
+  src += "    integer res;\n";
+  src += "  do\n";
+  src += "    res = body(10, 1.5);\n";
+  src += "    write(res);\n";
+  src += "  end\n";
+  return src;
+}
+
+}  // namespace bench
+}  // namespace toy
+
+#endif  // TOY_BENCH_PROGRAM_GEN_H_
@@ -0,0 +1,79 @@
+#include <cctype>
+#include <string>
+
+#include "bench.h"
+#include "char_scan.h"
+
+using namespace toy;
+
+// The byte at a time loop Lexer::SkipBufferWs used before the vector scan.
+static const char* SkipWhitespaceScalar(const char* p, const char* end,
+                                        int& lines) {
+  while (p != end && isspace(static_cast<unsigned char>(*p))) {
+    if (*p++ == '\n') {
+      lines++;
+    }
+  }
+  return p;
+}
+
+static const char* FindCharScalar(const char* p, const char* end, char c,
+                                  int& lines) {
+  while (p != end && *p != c) {
+    if (*p++ == '\n') {
+      lines++;
+    }
+  }
+  return p;
+}
+
+int main() {
+  // Indentation-like whitespace runs of 1 to 48 chars between tokens.
+  std::string ws_text;
+  for (int i = 0; i < 20000; ++i) {
+    ws_text += "\n" + std::string(1 + i % 48, ' ') + "x";
+  }
+  const char* ws_end = ws_text.data() + ws_text.size();
+
+  bench::Run("SkipWhitespace/scalar", ws_text.size(), [&] {
+    int lines = 0;
+    for (const char* p = ws_text.data(); p != ws_end;) {
+      p = SkipWhitespaceScalar(p, ws_end, lines);
+      p += p != ws_end;
+    }
+    bench::DoNotOptimize(lines);
+  });
+  bench::Run("SkipWhitespace/vector", ws_text.size(), [&] {
+    int lines = 0;
+    for (const char* p = ws_text.data(); p != ws_end;) {
+      p = scan::SkipWhitespace(p, ws_end, lines);
+      p += p != ws_end;
+    }
+    bench::DoNotOptimize(lines);
+  });
+
+  // A block comment banner with a '*' at the start of every line.
+  std::string cmt_text;
+  for (int i = 0; i < 20000; ++i) {
+    cmt_text += " * Explains what the function below does, in some detail.\n";
+  }
+  const char* cmt_end = cmt_text.data() + cmt_text.size();
+
+  bench::Run("FindChar('*')/scalar", cmt_text.size(), [&] {
+    int lines = 0;
+    for (const char* p = cmt_text.data(); p != cmt_end;) {
+      p = FindCharScalar(p, cmt_end, '*', lines);
+      p += p != cmt_end;
+    }
+    bench::DoNotOptimize(lines);
+  });
+  bench::Run("FindChar('*')/vector", cmt_text.size(), [&] {
+    int lines = 0;
+    for (const char* p = cmt_text.data(); p != cmt_end;) {
+      p = scan::FindChar(p, cmt_end, '*', lines);
+      p += p != cmt_end;
+    }
+    bench::DoNotOptimize(lines);
+  });
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "lexer.h"
+#include "logger.h"
+#include "mem_size_visitor.h"
+#include "parser.h"
+#include "program_gen.h"
+#include "source_buffer.h"
+#include "symbol_table.h"
+#include "symbol_table_visitor.h"
+#include "token_array.h"
+#include "type_check_visitor.h"
+
+using namespace toy;
+
+static const int NUM_STATS = 10000;
+
+// Builds the symbol tables of the program and sizes them, which adds an entry
+// per temporary and literal to the function table.
+static std::shared_ptr<ASTNode> RunSemanticChecks(const TokenArray& tokens) {
+  auto ast = Parser(tokens).Parse();
+  SymbolTableVisitor symtab_visitor;
+  ast->Accept(symtab_visitor);
+  TypeCheckVisitor typecheck_visitor;
+  ast->Accept(typecheck_visitor);
+  MemSizeVisitor memsize_visitor;
+  ast->Accept(memsize_visitor);
+  Logger::Clear();
+  return ast;
+}
+
+// Runs the semantic checks over a function of NUM_STATS statements, then looks
+// up every entry of its table by name and by kind and name, and the entries
+// of the global table from it.
+int main() {
+  std::string text = bench::GenerateLongFunction(NUM_STATS);
+  SourceBuffer src = SourceBuffer::FromString(text);
+  Lexer lexer(src, LexerMode::DFA);
+  TokenArray tokens = lexer.TokenizeAll();
+
+  bench::Run("SymbolTable/semantic-checks-10k", NUM_STATS, [&] {
+    bench::DoNotOptimize(RunSemanticChecks(tokens));
+  });
+
+  auto ast = RunSemanticChecks(tokens);
+  auto functab =
+      ast->symtab->GetEntry(EntryKind::FUNC, "::body(integer, float)")->Link();
+  std::vector<std::string> names;
+  for (auto it = functab->Begin(); it != functab->End(); ++it) {
+    names.push_back((*it)->Name());
+  }
+  bench::Run("SymbolTable/lookup-name", names.size(), [&] {
+    for (const std::string& name : names) {
+      bench::DoNotOptimize(functab->GetEntry(name));
+    }
+  });
+  bench::Run("SymbolTable/lookup-kind-name", names.size(), [&] {
+    for (const std::string& name : names) {
+      bench::DoNotOptimize(functab->GetEntry(EntryKind::LOCAL, name));
+    }
+  });
+  // The entries of the enclosing table, as looked up over and over again
+  // from the function table, e.g. for every call in its body
+  std::vector<std::pair<EntryKind, std::string>> ids;
+  for (auto it = ast->symtab->Begin(); it != ast->symtab->End(); ++it) {
+    auto func = EntryCast<FreeFuncEntry>(*it);
+    ids.emplace_back((*it)->Kind(),
+                     func != nullptr ? func->Signature() : (*it)->Name());
+  }
+  const int REPEATS = 1000;
+  bench::Run("SymbolTable/lookup-enclosing", ids.size() * REPEATS, [&] {
+    for (int i = 0; i < REPEATS; ++i) {
+      for (const auto& id : ids) {
+        bench::DoNotOptimize(functab->GetEntry(id.first, id.second));
+      }
+    }
+  });
+  return 0;
+}
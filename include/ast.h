@@ -1,42 +1,121 @@
 #ifndef TOY_AST_H_
 #define TOY_AST_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "func_table.h"
+#include "node_kind.h"
+#include "string_table.h"
 #include "symbol_table.h"
+#include "token.h"
+#include "type_table.h"
 
 namespace toy {
 
+class ASTArena;
+class ASTNode;
 class ASTVisitor;
 
+// Operator of an addOp, multOp, relOp or sign node.
+enum class Operator : uint8_t {
+  NONE,
+  PLUS,
+  MINUS,
+  OR,
+  MULT,
+  DIV,
+  AND,
+  EQ,
+  NEQ,
+  LT,
+  GT,
+  LEQ,
+  GEQ
+};
+
+// Returns the operator spelled lexeme, or NONE.
+Operator OperatorOf(const std::string& lexeme);
+
 /**
- * Base class for all AST nodes.
+ * View of the children of an AST node, which are stored contiguously.
  */
-class ASTNode : public std::enable_shared_from_this<ASTNode> {
+class ChildSpan {
  public:
-  // Non-leaf node ctor
-  ASTNode();
-  // Leaf node ctor
-  ASTNode(std::string val, int line);
+  typedef ASTNode* const* iterator;
 
-  std::vector<std::shared_ptr<ASTNode>> Children() const;
-  std::shared_ptr<ASTNode> ChildAt(int idx) const;
-  void AddChild(const std::shared_ptr<ASTNode>& child);
+  ChildSpan(iterator begin, std::size_t size);
 
-  std::string Type() const;
-  std::string Val() const;
-  int Line() const;
+  iterator begin() const;
+  iterator end() const;
+  std::size_t size() const;
+  bool empty() const;
+  ASTNode* operator[](std::size_t idx) const;
+  // Throws std::out_of_range if idx is not less than size().
+  ASTNode* at(std::size_t idx) const;
+
+ private:
+  iterator begin_;
+  std::size_t size_;
+};
 
-  void SetType(std::string type);
-  void SetVal(std::string val);
+/**
+ * Base class for all AST nodes.
+ *
+ * Nodes are owned by the ASTArena they were made in and live as long as it,
+ * so nodes refer to each other by plain pointers.
+ */
+class ASTNode {
+ public:
+  // Non-leaf node ctor
+  explicit ASTNode(NodeKind kind);
+  // Leaf node ctor. The value must be interned in the node's arena.
+  ASTNode(NodeKind kind, const std::string* val, int line);
+  ASTNode(const ASTNode&) = delete;
+  ASTNode& operator=(const ASTNode&) = delete;
+  virtual ~ASTNode() = default;
+
+  ChildSpan Children() const;
+  // Throws std::out_of_range if there is no such child.
+  ASTNode* ChildAt(int idx) const;
+  // The child must be made in the same arena as this node.
+  void AddChild(ASTNode* child);
+  // Makes room for n children in total, so that adding them needs no more
+  // allocations.
+  void ReserveChildren(std::size_t n);
+
+  // The kind of the node, telling its class, e.g. ADD_OP for an AddOpNode.
+  NodeKind Kind() const;
+  const std::string& Type() const;
+  // The id of Type() in Types().
+  TypeId TypeID() const;
+  const std::string& Val() const;
+  int Line() const;
+  // NONE but for operator nodes.
+  Operator Op() const;
+  // The table of the types of the nodes of this node's arena.
+  TypeTable& Types() const;
+  // The table of the functions defined in this node's arena.
+  FuncTable& Funcs() const;
+  // The table of the values of the leaves of this node's arena.
+  StringTable& Strings() const;
+
+  void SetType(const std::string& type);
+  void SetTypeID(TypeId type);
+  void SetVal(const std::string& val);
   void SetLine(int line);
 
   // Introduced for semantic analysis and code generation
   std::shared_ptr<SymbolTable> symtab;
   std::shared_ptr<Entry> symtab_entry;
-  // Register used for array offset calculations.
-  // By default this is r0, meaning no offset.
-  std::string regist = "r0";
+  // Number of the register used for array offset calculations.
+  // By default this is 0, i.e. r0, meaning no offset.
+  uint8_t regist = 0;
 
   // Print this AST to a dot file to view with graphviz
   void ToDotFile(std::string filepath);
@@ -44,26 +123,56 @@ class ASTNode : public std::enable_shared_from_this<ASTNode> {
 
   virtual void Accept(ASTVisitor& v) = 0;
 
-  // Factory method for non-leaf AST nodes
+  // Factory methods for single nodes, each made in an arena of its own which
+  // the returned pointer keeps alive. ASTs are built with ASTArena::MakeNode.
+  static std::shared_ptr<ASTNode> MakeNode(NodeKind kind);
   static std::shared_ptr<ASTNode> MakeNode(const std::string& kind);
-  // Factory method for leaf AST nodes
+  static std::shared_ptr<ASTNode> MakeNode(NodeKind kind,
+                                           const std::string& val, int line);
   static std::shared_ptr<ASTNode> MakeNode(const std::string& kind,
                                            const std::string& val, int line);
+  // Returns the kind of leaf built from a token of the given type, or NONE.
+  static NodeKind LeafKindOf(TokenType type);
 
   friend std::ostream& operator<<(std::ostream& os, const ASTNode& node);
 
+ protected:
+  Operator op_;
+
  private:
-  std::string val_;   // Lexical value (for leaf nodes)
-  int line_;          // Source code location (for leaf nhdes)
-  std::string type_;  // The type of the node (for type checking of expressions)
-  std::vector<std::shared_ptr<ASTNode>> children_;
+  friend class ASTArena;
+
+  NodeKind kind_;
+  const std::string* val_;  // Lexical value (for leaf nodes)
+  int line_;                // Source code location (for leaf nhdes)
+  TypeId type_;      // The type of the node (for type checking of expressions)
+  ASTArena* arena_;  // Owner, allocating the children arrays
+  ASTNode** children_;
+  uint32_t num_children_;
+  uint32_t children_capacity_;
 };
 std::ostream& operator<<(std::ostream& os, const ASTNode& node);
 
+// Defined here, as every traversal goes through them.
+inline ChildSpan::ChildSpan(iterator begin, std::size_t size)
+    : begin_(begin), size_(size) {}
+inline ChildSpan::iterator ChildSpan::begin() const { return begin_; }
+inline ChildSpan::iterator ChildSpan::end() const { return begin_ + size_; }
+inline std::size_t ChildSpan::size() const { return size_; }
+inline bool ChildSpan::empty() const { return size_ == 0; }
+inline ASTNode* ChildSpan::operator[](std::size_t idx) const {
+  return begin_[idx];
+}
+
+inline ChildSpan ASTNode::Children() const {
+  return ChildSpan(children_, num_children_);
+}
+inline NodeKind ASTNode::Kind() const { return kind_; }
+
 // Add operation, one of '+', '-', 'or'.
 class AddOpNode : public ASTNode {
  public:
-  AddOpNode(std::string val, int line);
+  AddOpNode(const std::string* val, int line);
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
 };
@@ -93,7 +202,7 @@ class IndiceList : public ASTNode {
 
 class AssignNode : public ASTNode {
  public:
-  AssignNode(std::string val, int line);
+  AssignNode(const std::string* val, int line);
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
 };
@@ -119,7 +228,7 @@ class DataMemberNode : public ASTNode {
   DataMemberNode();
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
-  std::string cls;
+  TypeId cls = TypeTable::NONE;  // Class of the lhs of the dot operator
 };
 
 // Variable (data member) or function call
@@ -129,7 +238,6 @@ class VarNode : public ASTNode {
   VarNode();
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
-  int mem_loc;
 };
 
 // Dimension list, used when declaring a new array.
@@ -143,7 +251,7 @@ class DimListNode : public ASTNode {
 // Dimension of an array, used when declaring a new array.
 class DimNode : public ASTNode {
  public:
-  DimNode(std::string val, int line);
+  DimNode(const std::string* val, int line);
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
 };
@@ -151,7 +259,7 @@ class DimNode : public ASTNode {
 // Float number, e.g. (floatNum, 2.0e10)
 class FloatNumNode : public ASTNode {
  public:
-  FloatNumNode(std::string val, int line);
+  FloatNumNode(const std::string* val, int line);
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
 };
@@ -185,7 +293,9 @@ class FuncCallNode : public ASTNode {
   FuncCallNode();
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
-  std::string cls;
+  TypeId cls = TypeTable::NONE;  // Class of the lhs of the dot operator
+  // The function called, in Funcs(), as resolved by type checking
+  FuncId func = FuncTable::NONE;
 };
 
 class FuncDefNode : public ASTNode {
@@ -204,7 +314,7 @@ class FuncDefListNode : public ASTNode {
 
 class IdNode : public ASTNode {
  public:
-  IdNode(std::string val, int line);
+  IdNode(const std::string* val, int line);
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
 };
@@ -225,7 +335,7 @@ class InheritListNode : public ASTNode {
 
 class IntNumNode : public ASTNode {
  public:
-  IntNumNode(std::string val, int line);
+  IntNumNode(const std::string* val, int line);
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
 };
@@ -261,7 +371,7 @@ class MemberVarDeclNode : public ASTNode {
 // Multiplication operation, one of '*', '/', 'and'.
 class MultOpNode : public ASTNode {
  public:
-  MultOpNode(std::string val, int line);
+  MultOpNode(const std::string* val, int line);
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
 };
@@ -302,7 +412,7 @@ class RelExprNode : public ASTNode {
 // Relational operation, one of 'eq', 'neq', 'lt', 'gt', 'leq', 'geq'.
 class RelOpNode : public ASTNode {
  public:
-  RelOpNode(std::string val, int line);
+  RelOpNode(const std::string* val, int line);
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
 };
@@ -324,7 +434,7 @@ class ScopeResNode : public ASTNode {
 // Sign, '+' or '-'
 class SignNode : public ASTNode {
  public:
-  SignNode(std::string val, int line);
+  SignNode(const std::string* val, int line);
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
 };
@@ -339,7 +449,7 @@ class StatListNode : public ASTNode {
 // Type, one of 'integer', 'float', 'id'
 class TypeNode : public ASTNode {
  public:
-  TypeNode(std::string val, int line);
+  TypeNode(const std::string* val, int line);
   void Accept(ASTVisitor& v) override;
   std::string ToStr() const override;
 };
@@ -374,6 +484,60 @@ class WriteNode : public ASTNode {
   std::string ToStr() const override;
 };
 
+/**
+ * Owns the nodes of an AST, their children arrays and the strings and types
+ * they refer to, for as long as the AST is used, e.g. for a compilation.
+ *
+ * Memory comes from large blocks handed out in order and released all at
+ * once with the arena, so making a node costs a pointer bump rather than a
+ * heap allocation.
+ */
+class ASTArena {
+ public:
+  ASTArena();
+  ASTArena(const ASTArena&) = delete;
+  ASTArena& operator=(const ASTArena&) = delete;
+  ~ASTArena();
+
+  // Makes a non-leaf node. Throws std::invalid_argument for leaf kinds.
+  ASTNode* MakeNode(NodeKind kind);
+  // Makes a leaf node. Throws std::invalid_argument for non-leaf kinds.
+  ASTNode* MakeNode(NodeKind kind, const std::string& val, int line);
+  // Makes a node of type T from args.
+  template <typename T, typename... Args>
+  T* New(Args&&... args);
+
+  std::size_t NumNodes() const;
+  // Bytes taken from the system, whether handed out yet or not.
+  std::size_t BytesReserved() const;
+  TypeTable& Types();
+  FuncTable& Funcs();
+
+ private:
+  friend class ASTNode;
+
+  StringTable strings_;  // Values of the leaves
+  TypeTable types_;
+  FuncTable funcs_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* cur_;  // Next free byte of the last block
+  char* end_;  // End of the last block
+  std::size_t bytes_reserved_;
+  std::vector<ASTNode*> nodes_;  // To destroy, in the order they were made
+
+  void* Allocate(std::size_t size, std::size_t align);
+  ASTNode** AllocateChildren(std::size_t n);
+};
+
+template <typename T, typename... Args>
+T* ASTArena::New(Args&&... args) {
+  T* node = new (Allocate(sizeof(T), alignof(T)))
+      T(std::forward<Args>(args)...);
+  node->arena_ = this;
+  nodes_.push_back(node);
+  return node;
+}
+
 }  // namespace toy
 
 #endif  // TOY_AST_H_
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef TOY_BIT_SET_H_
+#define TOY_BIT_SET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace toy {
+
+/**
+ * Set of the integers in [0, size), stored as one bit per possible element.
+ */
+class BitSet {
+ public:
+  BitSet() = default;
+  explicit BitSet(std::size_t size);
+
+  std::size_t Size() const;
+  bool Contains(std::size_t i) const;
+  void Insert(std::size_t i);
+  void Erase(std::size_t i);
+  // Adds the elements of other, which must have the same size. Returns true
+  // if any of them was not in the set yet.
+  bool UnionWith(const BitSet& other);
+  // Same as UnionWith, leaving out excluded.
+  bool UnionWithout(const BitSet& other, std::size_t excluded);
+  // Calls fn with each element, in increasing order.
+  template <typename Fn>
+  void ForEach(Fn fn) const;
+
+  friend bool operator==(const BitSet& set1, const BitSet& set2);
+
+ private:
+  std::size_t size_ = 0;
+  std::vector<uint64_t> words_;
+};
+
+template <typename Fn>
+void BitSet::ForEach(Fn fn) const {
+  for (std::size_t w = 0; w < words_.size(); ++w) {
+    for (uint64_t word = words_[w]; word != 0; word &= word - 1) {
+      fn(w * 64 + __builtin_ctzll(word));
+    }
+  }
+}
+
+bool operator==(const BitSet& set1, const BitSet& set2);
+
+}  // namespace toy
+
+#endif  // TOY_BIT_SET_H_
@@ -0,0 +1,21 @@
+#ifndef TOY_CHAR_SCAN_H_
+#define TOY_CHAR_SCAN_H_
+
+namespace toy {
+namespace scan {
+
+// Vectorized scans over a char range, used by the buffer lexer. They use
+// AVX2 when compiled with it (e.g. -mavx2), otherwise SSE2 where available,
+// and plain loops elsewhere and for the tail of the range.
+
+// Returns the first char in [p, end) that is not whitespace, or end. The
+// number of '\n' skipped is added to lines.
+const char* SkipWhitespace(const char* p, const char* end, int& lines);
+// Returns the first c in [p, end), or end. The number of '\n' before it is
+// added to lines.
+const char* FindChar(const char* p, const char* end, char c, int& lines);
+
+}  // namespace scan
+}  // namespace toy
+
+#endif  // TOY_CHAR_SCAN_H_
@@ -1,6 +1,7 @@
 #ifndef TOY_CODE_GEN_VISITOR_H_
 #define TOY_CODE_GEN_VISITOR_H_
 
+#include <cstdint>
 #include <stack>
 #include <unordered_map>
 
@@ -58,7 +59,7 @@ class CodeGenVisitor : public ASTVisitor {
 
  private:
   std::stack<std::string> register_pool_;
-  std::stack<std::string> offset_register_pool_;
+  std::stack<uint8_t> offset_register_pool_;  // Register numbers
   std::string exec_code_;
   std::string data_code_;
   std::string code_indent_;
@@ -71,7 +72,7 @@ class CodeGenVisitor : public ASTVisitor {
   void AddLibProcedure(const std::string& name);
   void StartOffsetIf(const ASTNode& node);
   void EndOffsetIf(ASTNode& node);
-  std::string GetInstructionFromOp(const std::string& tk);
+  std::string GetInstructionFromOp(Operator op);
   void HandleOr(AddOpNode& node);
   void HandleAnd(MultOpNode& node);
 
@@ -0,0 +1,53 @@
+#ifndef TOY_FUNC_TABLE_H_
+#define TOY_FUNC_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace toy {
+
+class FreeFuncEntry;
+
+// Id of a function defined in a FuncTable.
+typedef uint32_t FuncId;
+
+/**
+ * Numbers the functions defined in a program, free and member ones, so that
+ * the calls resolved to a function during type checking refer to it by id.
+ * A function is given the label of its code once, when it is added.
+ */
+class FuncTable {
+ public:
+  // Id of the calls not resolved to a defined function
+  static const FuncId NONE = 0;
+
+  FuncTable();
+  FuncTable(const FuncTable&) = delete;
+  FuncTable& operator=(const FuncTable&) = delete;
+
+  // Adds the function defined by entry, setting the id of the entry.
+  FuncId Add(std::shared_ptr<FreeFuncEntry> entry);
+  // Both throw std::out_of_range for NONE and ids not in the table.
+  const FreeFuncEntry& Func(FuncId id) const;
+  // The signature of the function without its punctuation, e.g. Aget2integer
+  // for A::get2(integer).
+  const std::string& Label(FuncId id) const;
+  // Returns the number of functions in the table.
+  std::size_t Size() const;
+
+ private:
+  struct Function {
+    std::shared_ptr<FreeFuncEntry> entry;
+    std::string label;
+  };
+  const Function& At(FuncId id) const;
+
+  std::vector<Function> funcs_;  // By id minus one
+};
+
+}  // namespace toy
+
+#endif  // TOY_FUNC_TABLE_H_
@@ -0,0 +1,110 @@
+#ifndef TOY_FUSED_SEMANTIC_VISITOR_H_
+#define TOY_FUSED_SEMANTIC_VISITOR_H_
+
+#include "ast_visitor.h"
+#include "mem_size_visitor.h"
+#include "type_check_visitor.h"
+
+namespace toy {
+
+/**
+ * Visitor to type check the AST and calculate the memory to be allocated in
+ * a single traversal, once the symbol tables are built. It gives the same
+ * results as a TypeCheckVisitor followed by a MemSizeVisitor, except in
+ * functions that have variables named like temps or literals, see below.
+ *
+ * Every node is type checked after its children and sized right after that,
+ * which is all the sizing needs, except for the class sizes that are still
+ * calculated before visiting the program. Sizing is skipped when the symbol
+ * tables have errors; once type checking reports one, the sizes are still
+ * calculated but must not be used for code generation.
+ *
+ * Since temps and literals are added to the symbol tables while the rest of
+ * the function is type checked, variables named like them (e.g. temp1 or
+ * lit1) clash with them, which is why this is not the default.
+ */
+class FusedSemanticVisitor : public ASTVisitor {
+ public:
+  FusedSemanticVisitor();
+  void Visit(AParamsNode& node) override;
+  void Visit(AddOpNode& node) override;
+  void Visit(ArithExprNode& node) override;
+  void Visit(AssignNode& node) override;
+  void Visit(ClassListNode& node) override;
+  void Visit(ClassNode& node) override;
+  void Visit(DataMemberNode& node) override;
+  void Visit(DimListNode& node) override;
+  void Visit(DimNode& node) override;
+  void Visit(FParamsListNode& node) override;
+  void Visit(FParamsNode& node) override;
+  void Visit(FloatNumNode& node) override;
+  void Visit(FuncBodyNode& node) override;
+  void Visit(FuncCallNode& node) override;
+  void Visit(FuncDefListNode& node) override;
+  void Visit(FuncDefNode& node) override;
+  void Visit(IdNode& node) override;
+  void Visit(IfStatNode& node) override;
+  void Visit(IndiceList& node) override;
+  void Visit(InheritListNode& node) override;
+  void Visit(IntNumNode& node) override;
+  void Visit(MainNode& node) override;
+  void Visit(MemberFuncDeclNode& node) override;
+  void Visit(MemberListNode& node) override;
+  void Visit(MemberVarDeclNode& node) override;
+  void Visit(MultOpNode& node) override;
+  void Visit(NotNode& node) override;
+  void Visit(ProgNode& node) override;
+  void Visit(ReadNode& node) override;
+  void Visit(RelExprNode& node) override;
+  void Visit(RelOpNode& node) override;
+  void Visit(ReturnNode& node) override;
+  void Visit(ScopeResNode& node) override;
+  void Visit(SignNode& node) override;
+  void Visit(StatListNode& node) override;
+  void Visit(TypeNode& node) override;
+  void Visit(VarDeclListNode& node) override;
+  void Visit(VarDeclNode& node) override;
+  void Visit(VarNode& node) override;
+  void Visit(WhileNode& node) override;
+  void Visit(WriteNode& node) override;
+
+  // Whether the memory sizes were calculated.
+  bool Sized() const;
+
+ private:
+  // Type checks a node, visiting its children with the fused visitor
+  class TypeCheckStep : public TypeCheckVisitor {
+   public:
+    explicit TypeCheckStep(FusedSemanticVisitor& fused);
+
+   protected:
+    void DFS(ASTNode& node) override;
+    void VisitChild(ASTNode& child) override;
+
+   private:
+    FusedSemanticVisitor& fused_;
+  };
+
+  // Sizes a node, after type checking it in place of visiting its children
+  class MemSizeStep : public MemSizeVisitor {
+   public:
+    explicit MemSizeStep(TypeCheckStep& type_check);
+
+   protected:
+    void DFS(ASTNode& node) override;
+
+   private:
+    TypeCheckStep& type_check_;
+  };
+
+  template <class T>
+  void VisitNode(T& node);
+
+  TypeCheckStep type_check_;
+  MemSizeStep mem_size_;
+  bool sizing_;
+};
+
+}  // namespace toy
+
+#endif  // TOY_FUSED_SEMANTIC_VISITOR_H_
@@ -24,7 +24,9 @@ std::string SymbolTypeToString(const SymbolType& type);
 SymbolType StringToSymbolType(const std::string& str);
 
 /**
- * Grammar symbol.
+ * Grammar symbol. The spelling of every symbol is interned once, so a symbol
+ * is just a dense integer id and comparing symbols compares ids. Ids are
+ * shared by all grammars; interning is not thread-safe.
  */
 class Symbol {
  public:
@@ -33,9 +35,13 @@ class Symbol {
   Symbol(SymbolType type);
   Symbol(Token tk);
   SymbolType Type() const;
-  std::string Str() const;
+  const std::string& Str() const;
   std::string RawStr() const;
   bool IsTerm() const;
+  // Returns the id the symbol's spelling is interned under.
+  int Id() const;
+  // Returns the number of ids handed out so far, all of them below it.
+  static int NumIds();
   bool operator<(const Symbol& rhs) const;
   friend bool operator==(const Symbol& symb1, const Symbol& symb2);
   friend bool operator!=(const Symbol& symb1, const Symbol& symb2);
@@ -45,14 +51,23 @@ class Symbol {
   friend std::ostream& operator<<(std::ostream& os, const Symbol& symb);
 
  private:
-  std::string s_;
+  int id_ = -1;
   SymbolType type_;
 };
 
+// Orders symbols by spelling rather than by id, for when the order must not
+// depend on the order symbols were interned in.
+struct SymbolNameLess {
+  bool operator()(const Symbol& symb1, const Symbol& symb2) const {
+    return symb1.Str() < symb2.Str();
+  }
+};
+
 namespace {
 typedef std::vector<Symbol> Rhs;
 typedef std::pair<Symbol, Rhs> Production;
-typedef std::map<Symbol, std::vector<Rhs>>::const_iterator GrammarIt;
+typedef std::map<Symbol, std::vector<Rhs>, SymbolNameLess>::const_iterator
+    GrammarIt;
 }  // namespace
 
 /**
@@ -62,6 +77,8 @@ class Grammar {
  public:
   Grammar();
   Grammar(std::string filepath);
+  // Reads the rules from is, in the same format as a grammar file.
+  Grammar(std::istream& is);
   GrammarIt Begin() const;
   GrammarIt End() const;
   // Get productions containing this symbol on the lhs.
@@ -72,8 +89,9 @@ class Grammar {
   friend std::ostream& operator<<(std::ostream& os, const Grammar& grm);
 
  private:
-  std::map<Symbol, std::vector<Rhs>> grm_;
-  void ReadGrammar(const std::string& filepath);
+  // Ordered by spelling, so rules are visited the same way in every process.
+  std::map<Symbol, std::vector<Rhs>, SymbolNameLess> grm_;
+  void ReadGrammar(std::istream& is);
 };
 std::ostream& operator<<(std::ostream& os, const Grammar& grm);
 
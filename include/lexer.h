@@ -1,41 +1,96 @@
 #ifndef TOY_LEXER_H_
 #define TOY_LEXER_H_
 
-#include <fstream>
 #include <memory>
+#include <string>
 
+#include "source_buffer.h"
+#include "string_table.h"
 #include "token.h"
+#include "token_array.h"
+#include "trace_sink.h"
 
 namespace toy {
 
+// How a Lexer reading from a SourceBuffer recognizes tokens.
+enum class LexerMode {
+  HAND_WRITTEN,  // Hand-written scanner mirroring the stream lexer
+  DFA,           // Table-driven DFA over character classes
+};
+
 /**
- * Extracts tokens from an input stream.
+ * Extracts tokens from an input stream, or directly from a source buffer.
  */
 class Lexer {
  public:
   Lexer() = delete;
   Lexer(std::istream& is);
+  // Lexes straight out of the buffer, which must outlive the lexer. Produces
+  // exactly the same tokens as lexing the buffer's text through a stream,
+  // whichever mode is used.
+  explicit Lexer(const SourceBuffer& src,
+                 LexerMode mode = LexerMode::HAND_WRITTEN);
 
   // Finds and returns the next token from the input stream.
   Token NextToken();
+  // Lexes the rest of the input in one pass and returns its tokens, without
+  // the comments. Offsets are relative to the start of the buffer, or to the
+  // stream position at the time of the call. Tokens are logged as usual.
+  TokenArray TokenizeAll();
+  // Replaces the removed chars at offset with inserted, then brings tokens,
+  // the result of this lexer's TokenizeAll(), up to date with the edited
+  // source. Only the tokens from just before the edit up to the first one
+  // lining up with an old token again are re-lexed. The offset counts from
+  // the same place as the token offsets. Throws std::out_of_range if the
+  // edit is not inside the text TokenizeAll() lexed.
+  void Relex(TokenArray& tokens, std::size_t offset, std::size_t removed,
+             const std::string& inserted);
   // Returns true if the lexer has another token in its input.
   bool HasNext();
   // Returns true if the word is a reserved word.
   static bool IsReserved(const std::string& word);
+  // Sends every token lexed from now on to the sink, which must outlive the
+  // lexer. Tokens are not logged by default, or if the sink is null.
+  void SetTokenLog(TraceSink* sink);
+  // Returns the table the lexemes of this lexer's tokens are interned in.
+  // Tokens stay valid for as long as the table is kept alive.
+  std::shared_ptr<StringTable> Strings() const;
 
  private:
-  std::istream& is_;
-  char c_;  // Holds the current char being lexed
+  std::shared_ptr<StringTable> strings_;
+  std::istream* is_;  // Null when lexing from a buffer
+  std::unique_ptr<SourceBuffer> owned_src_;  // Stream text read by TokenizeAll
+  char c_;             // Holds the current char being lexed
+  const char* begin_;  // Start of the buffer, which token offsets count from
+  const char* cur_;    // Next char to lex in the buffer
+  const char* end_;   // End of the buffer, always pointing at a '\0'
   int line_;
-  std::ofstream tokens_ofs_;
+  LexerMode mode_;
+  TraceSink* token_log_;
+  std::size_t tokenize_start_;  // Offset where TokenizeAll() began
+  int tokenize_line_;           // Line at tokenize_start_
 
+  Token NextArrayToken(std::size_t& offset);
+  Token NextStreamToken();
+  Token NextBufferToken();
+  Token NextDfaToken();
   Token HandleId(std::string& s);
   Token HandleNum(std::string& s);
   Token HandleFloatNum(std::string& s);
   Token HandleDivOrComment(std::string& s);
   TokenType GetIdOrReservedWordType(const std::string& str);
+  static TokenType GetIdOrReservedWordType(const char* s, std::size_t len);
   bool IsNumTerminatingChar(const char& c);
   void SkipWs();
+  Token MakeToken(TokenType type, const char* start);
+  Token MakeToken(TokenType type, const std::string& lexeme, int line);
+  Token ScanId(const char* start);
+  Token ScanNum(const char* start);
+  Token ScanFloatNum(const char* start);
+  Token ScanInvalidNum(const char* start);
+  Token ScanDivOrComment(const char* start);
+  Token ScanBlockComment(const char* start);
+  void SkipBufferWs();
   void LogToken(const Token& tk);
 };
 
@@ -12,9 +12,24 @@ enum class WarningType { LEXING, SYNTAX, SEMANTIC };
 /**
  * Logger singleton to keep track of errors and warnings
  * across different compilation stages.
+ *
+ * The logger is not thread-safe: threads other than the main one must
+ * redirect what they log to loggers of their own, to be merged in later.
  */
 class Logger {
  public:
+  // Redirects what the calling thread logs to another logger while alive.
+  class Redirect {
+   public:
+    explicit Redirect(Logger& log);
+    Redirect(const Redirect&) = delete;
+    Redirect& operator=(const Redirect&) = delete;
+    ~Redirect();
+
+   private:
+    Logger* previous_;
+  };
+
   static void Err(const std::string& msg, ErrorType type);
   static void Err(const std::string& msg, int line, ErrorType type);
   static bool HasErrors();
@@ -28,10 +43,16 @@ class Logger {
   static std::vector<std::string> GetWarnings();
 
   static void Clear();
+  // Appends the errors and warnings of log, in the order they were logged.
+  static void Merge(const Logger& log);
   static std::shared_ptr<Logger> Instance();
 
  private:
   static std::shared_ptr<Logger> instance_;
+  static thread_local Logger* redirect_;
+
+  // Returns the logger the calling thread logs to.
+  static Logger& Target();
   std::vector<std::pair<int, std::string>> errors_;
   std::vector<std::pair<int, std::string>> warnings_;
 };
@@ -1,7 +1,9 @@
 #ifndef TOY_MEM_SIZE_VISITOR_H_
 #define TOY_MEM_SIZE_VISITOR_H_
 
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "ast_visitor.h"
 
@@ -55,17 +57,39 @@ class MemSizeVisitor : public ASTVisitor {
   void Visit(WhileNode& node) override;
   void Visit(WriteNode& node) override;
 
+  // Numbers the next temp and literal from these, e.g. for a function sized
+  // on its own, after those before it in the program.
+  void SetCounters(int temp_var_counter, int lit_val_counter);
+  // Names of the nth temp and literal, from 1
+  static std::string TempVarName(int n);
+  static std::string LitValName(int n);
+
+  // In counting mode the visitor changes nothing, it only counts the temps
+  // and literals it would add and keeps the values signed numbers would get,
+  // e.g. "-1" for the literal of -1.
+  void SetCounting(bool counting);
+  // Numbers of the next temp and literal
+  int TempVarCounter() const;
+  int LitValCounter() const;
+  const std::vector<std::string>& SignedVals() const;
+
  private:
   std::unordered_map<std::string, int> type_sizes_;
   void InitTypeSizes(ProgNode& node);
+  int GetTypeSize(const std::string& type) const;
   int GetEntrySize(const Entry& entry);
 
   // Generate a unique tempvar name
   std::string GetTempVarName();
   // Generate a unique literal value name
   std::string GetLitValName();
+  // Add an entry for the temp or literal node stands for, unless counting
+  void AddTempVar(ASTNode& node, int line);
+  void AddLitVal(ASTNode& node);
   int temp_var_counter;
   int lit_val_counter;
+  bool counting_ = false;
+  std::vector<std::string> signed_vals_;
 };
 
 }  // namespace toy
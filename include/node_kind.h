@@ -0,0 +1,85 @@
+#ifndef TOY_NODE_KIND_H_
+#define TOY_NODE_KIND_H_
+
+#include <cstdint>
+#include <string>
+
+namespace toy {
+
+// Apply X to the enumerator, the class and the spelling in semantic actions of
+// every kind of node, in the order of NodeKind: the non-leaf kinds, then the
+// leaf ones. The enum and everything else listed by kind are generated from
+// them.
+#define TOY_NON_LEAF_NODES(X)                               \
+  X(APARAMS, AParamsNode, "aparams")                        \
+  X(ARITH_EXPR, ArithExprNode, "arithexpr")                 \
+  X(CLASS, ClassNode, "class")                              \
+  X(CLASS_LIST, ClassListNode, "classlist")                 \
+  X(DATA_MEMBER, DataMemberNode, "datamember")              \
+  X(DIM_LIST, DimListNode, "dimlist")                       \
+  X(FCALL, FuncCallNode, "fcall")                           \
+  X(FPARAMS, FParamsNode, "fparams")                        \
+  X(FPARAMS_LIST, FParamsListNode, "fparamslist")           \
+  X(FUNC_BODY, FuncBodyNode, "funcbody")                    \
+  X(FUNC_DEF, FuncDefNode, "funcdef")                       \
+  X(FUNC_DEF_LIST, FuncDefListNode, "funcdeflist")          \
+  X(IF_STAT, IfStatNode, "ifstat")                          \
+  X(INDICE_LIST, IndiceList, "indicelist")                  \
+  X(INHERIT_LIST, InheritListNode, "inheritlist")           \
+  X(MAIN, MainNode, "main")                                 \
+  X(MEMBER_FUNC_DECL, MemberFuncDeclNode, "memberfuncdecl") \
+  X(MEMBER_VAR_DECL, MemberVarDeclNode, "membervardecl")    \
+  X(MEMB_LIST, MemberListNode, "memblist")                  \
+  X(NOT, NotNode, "not")                                    \
+  X(PROG, ProgNode, "prog")                                 \
+  X(READ, ReadNode, "read")                                 \
+  X(REL_EXPR, RelExprNode, "relexpr")                       \
+  X(RETURN, ReturnNode, "return")                           \
+  X(SCOPE_RES, ScopeResNode, "scoperes")                    \
+  X(STAT_LIST, StatListNode, "statlist")                    \
+  X(VAR, VarNode, "var")                                    \
+  X(VAR_DECL, VarDeclNode, "vardecl")                       \
+  X(VAR_DECL_LIST, VarDeclListNode, "vardecllist")          \
+  X(WHILE, WhileNode, "while")                              \
+  X(WRITE, WriteNode, "write")
+
+#define TOY_LEAF_NODES(X)                \
+  X(SIGN, SignNode, "sign")              \
+  X(DIM, DimNode, "dim")                 \
+  X(TYPE, TypeNode, "type")              \
+  X(INT_NUM, IntNumNode, "intNum")       \
+  X(FLOAT_NUM, FloatNumNode, "floatNum") \
+  X(ID, IdNode, "id")                    \
+  X(ADD_OP, AddOpNode, "addOp")          \
+  X(MULT_OP, MultOpNode, "multOp")       \
+  X(ASSIGN, AssignNode, "assign")        \
+  X(REL_OP, RelOpNode, "relOp")
+
+#define TOY_AST_NODES(X) \
+  TOY_NON_LEAF_NODES(X)  \
+  TOY_LEAF_NODES(X)
+
+// Kinds of AST nodes, named after the node kinds used by the grammar's
+// semantic actions, e.g. !sem_end_funcdef! builds a FUNC_DEF node.
+enum class NodeKind : uint8_t {
+#define TOY_NODE_KIND(Kind, Node, name) Kind,
+  TOY_AST_NODES(TOY_NODE_KIND)
+#undef TOY_NODE_KIND
+  // No node
+  NONE
+};
+
+// The first leaf kind, every kind before it being a non-leaf one.
+#define TOY_COUNT_NODE_KIND(Kind, Node, name) +1
+const NodeKind FIRST_LEAF_KIND =
+    static_cast<NodeKind>(0 TOY_NON_LEAF_NODES(TOY_COUNT_NODE_KIND));
+#undef TOY_COUNT_NODE_KIND
+
+// Returns the kind as spelled in semantic actions, e.g. "funcdef".
+std::string NodeKindToString(NodeKind kind);
+// Returns the kind spelled str in semantic actions, or NONE if there is none.
+NodeKind StringToNodeKind(const std::string& str);
+
+}  // namespace toy
+
+#endif  // TOY_NODE_KIND_H_
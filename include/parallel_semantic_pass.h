@@ -0,0 +1,84 @@
+#ifndef TOY_PARALLEL_SEMANTIC_PASS_H_
+#define TOY_PARALLEL_SEMANTIC_PASS_H_
+
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ast.h"
+#include "logger.h"
+#include "mem_size_visitor.h"
+
+namespace toy {
+
+/**
+ * Type checks the AST and calculates the memory to be allocated, once the
+ * symbol tables are built, on several threads. It gives the same results as
+ * a TypeCheckVisitor followed by a MemSizeVisitor when there are no errors.
+ *
+ * The classes are visited first, on the calling thread. The bodies of the
+ * functions and of main only add to the symbol tables of their own scopes,
+ * so they are then type checked, and sized, in any order on a pool of
+ * threads. Each body logs to a logger of its own, merged in the order of the
+ * program once all are done, and its temps and literals are numbered from
+ * where those of the bodies before it end, counted by a MemSizeVisitor in
+ * counting mode once type checked. The names and types they add to the
+ * tables of the program are interned beforehand, so that the threads only
+ * read those tables; should one be missed, the bodies are checked again on
+ * the calling thread alone.
+ */
+class ParallelSemanticPass {
+ public:
+  // 0 threads stands for as many as the hardware runs at once.
+  explicit ParallelSemanticPass(unsigned num_threads);
+
+  // Throws std::invalid_argument if prog is not a program.
+  void Run(ASTNode& prog);
+  // Whether the memory sizes were calculated, i.e. type checking found no
+  // errors.
+  bool Sized() const;
+
+ private:
+  // A function or main, with what sizing it adds
+  struct Body {
+    ASTNode* node;
+    Logger log;
+    std::exception_ptr error;
+    int num_temps = 0;
+    int num_lits = 0;
+    std::vector<std::string> signed_vals;  // e.g. "-1" for the literal of -1
+    int first_temp = 1;
+    int first_lit = 1;
+  };
+
+  // Sizes the classes, then the bodies on the threads
+  class MemSizeStep : public MemSizeVisitor {
+   public:
+    explicit MemSizeStep(ParallelSemanticPass& pass);
+
+   protected:
+    void DFS(ASTNode& node) override;
+
+   private:
+    ParallelSemanticPass& pass_;
+  };
+
+  void TypeCheck(ASTNode& prog);
+  void InternNames(ASTNode& prog);
+  // Calls fn on every body from up to num_threads threads, with what it logs
+  // redirected to its own logger, then merges the loggers, or drops them and
+  // rethrows the first exception if any was thrown.
+  void ForEachBody(ASTNode& prog, unsigned num_threads,
+                   const std::function<void(Body&)>& fn);
+
+  unsigned num_threads_;
+  std::vector<Body> bodies_;
+  // The other children of the program, e.g. the class list
+  std::vector<ASTNode*> serial_;
+  bool sized_ = false;
+};
+
+}  // namespace toy
+
+#endif  // TOY_PARALLEL_SEMANTIC_PASS_H_
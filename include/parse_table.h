@@ -0,0 +1,123 @@
+#ifndef TOY_PARSE_TABLE_H_
+#define TOY_PARSE_TABLE_H_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "grammar.h"
+#include "node_kind.h"
+#include "parser_gen.h"
+#include "token.h"
+
+namespace toy {
+
+// What a semantic action does, decoded from its spelling in the grammar,
+// !sem_<type>_<node kind>!. See Parser::ExecuteSemanticAction.
+enum class ActionType { NONE, START, END, PUSH, OP, END_SIGN, END_SCOPERES };
+
+struct SemanticAction {
+  ActionType type;
+  // The node built by END and END_SCOPERES, or by PUSH if it is not built
+  // from the previous token, otherwise NONE.
+  NodeKind node_kind;
+};
+
+/**
+ * LL(1) parsing table over dense integer symbol IDs.
+ *
+ * Terminals are numbered first, '$' included, followed by the
+ * non-terminals, the semantic actions and finally EPSILON. The table used
+ * by the compiler is generated from etc/toy-ll1.g at build time and compiled
+ * in, so getting it involves no grammar I/O and no table construction.
+ */
+class ParseTable {
+ public:
+  ParseTable() = delete;
+  // Builds the table of a grammar analyzed by pgen.
+  ParseTable(const Grammar& grammar, const ParserGenerator& pgen);
+  ParseTable(const ParseTable&) = delete;
+  ParseTable& operator=(const ParseTable&) = delete;
+
+  // Returns the table generated from etc/toy-ll1.g.
+  static const ParseTable& Embedded();
+
+  int NumTerms() const;
+  int NumNonTerms() const;
+  int NumActions() const;
+  int NumSymbols() const;
+  int NumProductions() const;
+  bool IsTerm(int symb) const;
+  bool IsNonTerm(int symb) const;
+  bool IsAction(int symb) const;
+  int Start() const;
+  int End() const;
+  int Epsilon() const;
+  // Returns the symbol as spelled in the grammar, e.g. "'id'" or "<prog>".
+  const char* Name(int symb) const;
+  // Returns the decoded semantic action symb stands for.
+  const SemanticAction& Action(int symb) const;
+  // Returns the terminal matched by tokens of the given type, or -1 if the
+  // grammar has none.
+  int TermOf(TokenType type) const;
+  // Returns the production to expand non_term with when term is next, or -1
+  // if there is none. term may be -1.
+  int At(int non_term, int term) const;
+  // Whether term is in FIRST(non_term), or in FOLLOW(non_term). Used to
+  // synchronize on after a syntax error. term may be -1.
+  bool InFirst(int non_term, int term) const;
+  bool InFollow(int non_term, int term) const;
+  // The rhs of a production, in grammar order.
+  const int16_t* RhsBegin(int prod) const;
+  const int16_t* RhsEnd(int prod) const;
+  // The rhs of a production reversed and without EPSILON, i.e. the symbols
+  // to push on a parse stack when expanding with it, in push order.
+  const int16_t* ExpansionBegin(int prod) const;
+  const int16_t* ExpansionEnd(int prod) const;
+
+  // Writes C++ source defining Embedded() as this table.
+  void WriteSource(std::ostream& os) const;
+
+ private:
+  // Points the table at arrays that outlive it, as generated sources do.
+  ParseTable(int num_terms, int num_non_terms, int num_actions,
+             int num_prods, int start, int end, const char* const* names,
+             const int16_t* table, const uint8_t* sync_sets,
+             const int32_t* rhs_offsets, const int16_t* rhs,
+             const int32_t* expansion_offsets, const int16_t* expansions,
+             const int16_t* token_terms);
+
+  int num_terms_;
+  int num_non_terms_;
+  int num_actions_;
+  int num_prods_;
+  int start_;
+  int end_;
+  const char* const* names_;    // By symbol
+  const int16_t* table_;        // [non_term - num_terms_][term]
+  const uint8_t* sync_sets_;    // Likewise, IN_FIRST | IN_FOLLOW bits
+  const int32_t* rhs_offsets_;  // Start of each production in rhs_, plus end
+  const int16_t* rhs_;
+  const int32_t* expansion_offsets_;  // Likewise for expansions_
+  const int16_t* expansions_;
+  const int16_t* token_terms_;  // By TokenType
+  std::vector<SemanticAction> actions_;  // By symbol, less the first action
+
+  void DecodeActions();
+
+  // Storage of a table built at runtime.
+  std::vector<std::string> name_strs_;
+  std::vector<const char*> name_ptrs_;
+  std::vector<int16_t> table_vec_;
+  std::vector<uint8_t> sync_sets_vec_;
+  std::vector<int32_t> rhs_offsets_vec_;
+  std::vector<int16_t> rhs_vec_;
+  std::vector<int32_t> expansion_offsets_vec_;
+  std::vector<int16_t> expansions_vec_;
+  std::vector<int16_t> token_terms_vec_;
+};
+
+}  // namespace toy
+
+#endif  // TOY_PARSE_TABLE_H_
@@ -3,45 +3,102 @@
 
 #include <memory>
 #include <stack>
+#include <vector>
 
 #include "ast.h"
 #include "lexer.h"
-#include "parser_gen.h"
+#include "parse_table.h"
 #include "token.h"
+#include "token_array.h"
+#include "trace_sink.h"
 
 namespace toy {
 
+// How a Parser parses its tokens.
+enum class ParserMode {
+  TABLE,              // Driven by a ParseTable, recovering from errors
+  RECURSIVE_DESCENT,  // Generated from the grammar, stops at the first error
+};
+
+// Where parsing resumed after a syntax error.
+struct RecoveryPoint {
+  int error_line;   // Line of the token the error was reported at
+  int resume_line;  // Line of the token parsing resumed at
+  int skipped;      // Number of tokens skipped
+};
+
 /**
  *  LL(1) parser.
  *
- * Uses the parsing table generated by the ParserGenerator,
+ * Uses a ParseTable, by default the one compiled in from the grammar,
  * the result of the parse is an AST which is built by executing
  * semantic actions encoded in the grammar.
  */
 class Parser {
  public:
   Parser() = delete;
-  Parser(Lexer& lexer, const ParserGenerator& pgen);
+  // The table must outlive the parser.
+  Parser(Lexer& lexer, const ParseTable& table = ParseTable::Embedded());
+  // Parses pre-lexed tokens, e.g. from Lexer::TokenizeAll(). The array must
+  // outlive the parser.
+  Parser(const TokenArray& tokens,
+         const ParseTable& table = ParseTable::Embedded());
+  // Returns the AST, or nullptr if the tokens had syntax errors. All nodes
+  // of the AST live as long as the returned pointer or copies of it.
   std::shared_ptr<ASTNode> Parse();
+  // TABLE by default. Both modes build the same AST. The recursive-descent
+  // parser always follows the embedded table's grammar, reports only the
+  // first syntax error and logs no derivation.
+  void SetMode(ParserMode mode);
+  // Sends the derivation, the symbol on top of the parse stack at every
+  // step, to the sink, which must outlive the parser. The derivation is not
+  // logged by default, or if the sink is null.
+  void SetDerivationLog(TraceSink* sink);
+  // Stops parsing after max_errors syntax errors, 20 by default.
+  void SetMaxErrors(int max_errors);
+  // Where parsing resumed after each syntax error of the last parse.
+  const std::vector<RecoveryPoint>& RecoveryPoints() const;
 
  private:
-  Lexer& lexer_;
-  ParserGenerator pgen_;
+  Lexer* lexer_;              // Null when parsing a token array
+  const TokenArray* tokens_;  // Null when pulling tokens from a lexer
+  std::size_t pos_;           // Index of the next token in tokens_
+  const ParseTable& table_;
+  ParserMode mode_;
+  TraceSink* derivation_log_;
   Token prev_token_;
-  std::stack<Symbol> symbol_stack_;
-  void InverseRhsMultiplePush(Symbol top, Symbol tk);
-  void SkipErrors(Symbol& top, Token& tk);
+  Token NextToken();
+  bool HasNextToken();
+  std::vector<int16_t> symbol_stack_;  // Top at the back
+  void InverseRhsMultiplePush(int prod);
+
+  // Defined in the generated rd_parser.cc.
+  friend class RecursiveDescentParser;
+  std::shared_ptr<ASTNode> ParseRecursiveDescent();
+
+  int max_errors_;
+  int num_errors_;
+  // Whether no token was matched since the last syntax error. Errors are
+  // not reported then, as they are most likely caused by the last one.
+  bool recovering_;
+  std::vector<RecoveryPoint> recovery_points_;
+  void SkipErrors(int top, Token& tk);
+  bool ExpectedBelowTop(int term) const;
+  void EndRecovery(const Token& tk);
 
+  // Owner of the nodes of the last parse, kept alive by the AST returned
+  std::shared_ptr<ASTArena> arena_;
   // Stack holding AST nodes while semantic acitons are executed
   // If parsing is successful, contains only one node (ProgNode) on top
-  std::stack<std::shared_ptr<ASTNode>> semantic_stack_;
-  void ExecuteSemanticAction(const std::string& action);
+  std::stack<ASTNode*> semantic_stack_;
+  std::shared_ptr<ASTNode> Root() const;
+  void ExecuteSemanticAction(const SemanticAction& action);
   void StartAction();
-  void EndAction(std::string action);
-  void PushAction(const std::string& action);
+  void EndAction(NodeKind node_kind);
+  void PushAction(NodeKind node_kind);
   void OpAction();
   void EndSignAction();
-  void EndScopeResAction(std::string action);
+  void EndScopeResAction(NodeKind node_kind);
 };
 
 }  // namespace toy
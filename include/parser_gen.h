@@ -5,21 +5,26 @@
 #include <set>
 #include <vector>
 
+#include "bit_set.h"
 #include "grammar.h"
 
 namespace toy {
 
 namespace {
-typedef std::set<Symbol> Set;
-typedef std::map<Symbol, Set> Sets;
+// Ordered by spelling, so the sets print the same way in every process.
+typedef std::set<Symbol, SymbolNameLess> Set;
+typedef std::map<Symbol, Set, SymbolNameLess> Sets;
 typedef std::map<std::vector<Symbol>, Set> FirstSetsRhs;
-typedef std::map<Symbol, std::vector<Symbol>> Graph;
-typedef std::map<Symbol, std::map<Symbol, Production>> ParsingTable;
 }  // namespace
 
 /**
  * Generates and stores first sets, follow sets and the
  * LL(1) parsing table for the given grammar.
+ *
+ * Sets are bitsets over the grammar's terminals, computed by worklist
+ * fixed-point iteration, and the table is a 2D array of production indices
+ * indexed by [non-terminal][terminal]. The std::set views of the sets are
+ * only built for the accessors.
  */
 class ParserGenerator {
  public:
@@ -29,27 +34,42 @@ class ParserGenerator {
   const Sets& FirstSets() const;
   const Sets& FollowSets() const;
   const FirstSetsRhs& FirstSetsOfRhs() const;
-  Production TableAt(Symbol row, Symbol col);
-  bool TableValid(Symbol row, Symbol col);
+  const Production& TableAt(Symbol row, Symbol col) const;
+  bool TableValid(Symbol row, Symbol col) const;
   void PrintSets() const;
   void PrintTable() const;
 
  private:
   const Grammar& grammar_;
+  std::vector<Symbol> terms_;      // By column, EPSILON and '$' included
+  std::vector<Symbol> non_terms_;  // By row
+  std::vector<int> cols_;          // Column of each terminal by id, or -1
+  std::vector<int> rows_;          // Row of each non-terminal by id, or -1
+  int epsilon_;                    // Column of EPSILON
+
+  std::vector<Production> prods_;  // In grammar order
+  std::vector<Rhs> rhs_;           // By production, actions removed
+  std::vector<BitSet> first_;      // By row
+  std::vector<BitSet> first_rhs_;  // By production
+  std::vector<BitSet> follow_;     // By row
+  // By column, whether the terminal's first set is reported by FirstSets().
+  std::vector<bool> first_used_;
+
+  std::vector<int> table_;  // [row][column], production index or -1
+
   Sets first_sets_;
   Sets follow_sets_;
   FirstSetsRhs first_sets_rhs_;
-  Graph dep_graph_;
-  ParsingTable table_;
 
-  void CalculateSets();
+  void IndexGrammar();
+  void CalculateFirstSets();
+  void CalculateFollowSets();
+  void MaterializeSets();
   void ConstructTable();
-  Set FirstSetOf(Symbol symb);
-  Set FirstSetOfRhs(const std::vector<Symbol>& rhs);
-  Set FollowSetOf(Symbol symb);
-  void ResolveDependencies(Symbol symb);
+  bool FirstSetOfRhs(const Rhs& rhs, std::size_t begin, BitSet& first);
+  Set ToSet(const BitSet& bits) const;
 };
 
 }  // namespace toy
 
-#endif  // TOY_PARSER_GEN_H_
\ No newline at end of file
+#endif  // TOY_PARSER_GEN_H_
@@ -0,0 +1,47 @@
+#ifndef TOY_RD_PARSER_GEN_H_
+#define TOY_RD_PARSER_GEN_H_
+
+#include <iostream>
+#include <string>
+
+#include "parse_table.h"
+
+namespace toy {
+
+/**
+ * Generates the C++ source of a recursive-descent parser from an LL(1)
+ * parse table.
+ *
+ * Every non-terminal becomes a member function of RecursiveDescentParser
+ * switching on the lookahead's TokenType, with one case per production of
+ * the table's row. Terminals are matched inline and semantic actions become
+ * direct calls to the Parser's node-building actions, so the generated
+ * parser builds the same AST as the table-driven one.
+ */
+class RecursiveDescentGenerator {
+ public:
+  RecursiveDescentGenerator() = delete;
+  // The table must outlive the generator.
+  explicit RecursiveDescentGenerator(const ParseTable& table);
+
+  // Writes C++ source defining Parser::ParseRecursiveDescent().
+  void WriteSource(std::ostream& os) const;
+
+ private:
+  const ParseTable& table_;
+
+  // Returns the name of the member function parsing non_term.
+  std::string FunctionName(int non_term) const;
+  void WriteFunction(std::ostream& os, int non_term) const;
+  void WriteProduction(std::ostream& os, const std::string& indent,
+                       int non_term, int prod) const;
+  void WriteCaseLabels(std::ostream& os, int term) const;
+  void WriteMatch(std::ostream& os, const std::string& indent,
+                  int term) const;
+  void WriteAction(std::ostream& os, const std::string& indent,
+                   int action) const;
+};
+
+}  // namespace toy
+
+#endif  // TOY_RD_PARSER_GEN_H_
@@ -0,0 +1,45 @@
+#ifndef TOY_SOURCE_BUFFER_H_
+#define TOY_SOURCE_BUFFER_H_
+
+#include <cstddef>
+#include <string>
+
+namespace toy {
+
+/**
+ * Read-only source text held in one contiguous block of memory. The text is
+ * always followed by a NUL sentinel, so a scanner may look one character
+ * past the end without a bounds check.
+ */
+class SourceBuffer {
+ public:
+  // Maps the file into memory, or reads it in if it cannot be mapped.
+  // Throws std::runtime_error if the file cannot be opened.
+  static SourceBuffer FromFile(const std::string& filepath);
+  // Takes ownership of the given source text.
+  static SourceBuffer FromString(std::string text);
+
+  SourceBuffer(SourceBuffer&& other) noexcept;
+  SourceBuffer& operator=(SourceBuffer&& other) noexcept;
+  SourceBuffer(const SourceBuffer&) = delete;
+  SourceBuffer& operator=(const SourceBuffer&) = delete;
+  ~SourceBuffer();
+
+  // Returns the first character of the text; Data()[Size()] is always '\0'.
+  const char* Data() const;
+  std::size_t Size() const;
+
+ private:
+  SourceBuffer() = default;
+  void Release();
+
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+  void* map_ = nullptr;  // Start of the mapping if the file was mapped
+  std::size_t map_size_ = 0;
+  std::string text_;  // Owns the text when it is not mapped
+};
+
+}  // namespace toy
+
+#endif  // TOY_SOURCE_BUFFER_H_
@@ -0,0 +1,96 @@
+#ifndef TOY_STATIC_AST_VISITOR_H_
+#define TOY_STATIC_AST_VISITOR_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "ast.h"
+
+namespace toy {
+
+/**
+ * Visitor dispatching on the kind of the nodes rather than through virtual
+ * calls, for passes that are instantiated with their own class as Derived:
+ *
+ *   class NodeCounter : public StaticASTVisitor<NodeCounter> { ... };
+ *
+ * It has the same Visit overloads as ASTVisitor, each visiting the children
+ * by default, so that an ASTVisitor ports over by changing its base class,
+ * dropping the overrides and calling Dispatch(child) in place of
+ * child->Accept(*this). A pass overriding only some overloads must bring the
+ * rest in with a using declaration.
+ *
+ * Derived's overloads are called directly, so they can be inlined, and the
+ * kinds it leaves to the defaults are known at compile time. Those skip the
+ * switch on the kind and go straight to DFS, so that a pass that mostly does
+ * DFS(node) becomes a plain loop over the tree.
+ */
+template <typename Derived>
+class StaticASTVisitor {
+ public:
+  // Returned by the default overloads, to tell them from Derived's.
+  struct Default {};
+
+  // Visits node with the overload of Derived for the kind of the node.
+  void Dispatch(ASTNode& node);
+
+#define TOY_DEFAULT_VISIT(Kind, Node, name) \
+  Default Visit(Node& node) {               \
+    Self().DFS(node);                       \
+    return Default();                       \
+  }
+  TOY_AST_NODES(TOY_DEFAULT_VISIT)
+#undef TOY_DEFAULT_VISIT
+
+ protected:
+  // Dispatches the children of node in order. Derived may hide it with a DFS
+  // of its own, e.g. passing state down to the children, which the default
+  // overloads then call. This class must be able to access it.
+  void DFS(ASTNode& node);
+
+ private:
+  Derived& Self() { return static_cast<Derived&>(*this); }
+
+  // Returns the bit of kind if Derived has an overload of its own for Node.
+  template <typename Node>
+  static constexpr uint64_t OwnKind(NodeKind kind) {
+    return std::is_same<decltype(std::declval<Derived&>().Visit(
+                            std::declval<Node&>())),
+                        Default>::value
+               ? 0
+               : uint64_t(1) << static_cast<int>(kind);
+  }
+};
+
+template <typename Derived>
+void StaticASTVisitor<Derived>::Dispatch(ASTNode& node) {
+#define TOY_OWN_KIND(Kind, Node, name) | OwnKind<Node>(NodeKind::Kind)
+  constexpr uint64_t own_kinds = 0 TOY_AST_NODES(TOY_OWN_KIND);
+#undef TOY_OWN_KIND
+  if ((own_kinds >> static_cast<int>(node.Kind()) & 1) == 0) {
+    Self().DFS(node);
+    return;
+  }
+  switch (node.Kind()) {
+#define TOY_DISPATCH(Kind, Node, name)      \
+  case NodeKind::Kind:                      \
+    Self().Visit(static_cast<Node&>(node)); \
+    return;
+    TOY_AST_NODES(TOY_DISPATCH)
+#undef TOY_DISPATCH
+    case NodeKind::NONE:
+      return;
+  }
+}
+
+template <typename Derived>
+void StaticASTVisitor<Derived>::DFS(ASTNode& node) {
+  for (ASTNode* child : node.Children()) {
+    Dispatch(*child);
+  }
+}
+
+}  // namespace toy
+
+#endif  // TOY_STATIC_AST_VISITOR_H_
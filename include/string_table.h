@@ -0,0 +1,50 @@
+#ifndef TOY_STRING_TABLE_H_
+#define TOY_STRING_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace toy {
+
+/**
+ * Interns strings so each distinct string is stored once. Interned strings
+ * keep their address for the lifetime of the table, so two strings from the
+ * same table are equal exactly when their pointers are.
+ */
+class StringTable {
+ public:
+  StringTable();
+  StringTable(const StringTable&) = delete;
+  StringTable& operator=(const StringTable&) = delete;
+
+  // Returns the interned copy of the len chars at s, adding it if needed.
+  const std::string* Intern(const char* s, std::size_t len);
+  const std::string* Intern(const std::string& s);
+  // Returns the interned copy of s, or nullptr if s was never interned.
+  const std::string* Find(const std::string& s) const;
+  // Returns the number of distinct strings in the table.
+  std::size_t Size() const;
+
+  // Table used for strings interned outside of a compilation, e.g. tokens
+  // built by hand. It is never cleared and is not thread-safe.
+  static StringTable& Default();
+
+ private:
+  struct Slot {
+    uint32_t hash;
+    uint32_t idx;  // 1 + index into strings_, or 0 if the slot is empty
+  };
+
+  std::deque<std::string> strings_;  // deque keeps element addresses stable
+  std::vector<Slot> slots_;          // Open addressing, power of two size
+
+  static uint32_t Hash(const char* s, std::size_t len);
+  void Grow();
+};
+
+}  // namespace toy
+
+#endif  // TOY_STRING_TABLE_H_
@@ -1,13 +1,16 @@
 #ifndef TOY_SYMBOL_TABLE_H_
 #define TOY_SYMBOL_TABLE_H_
 
+#include <cstdint>
 #include <iostream>
-#include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "func_table.h"
+#include "string_table.h"
+
 namespace toy {
 
 // Forward declarations
@@ -19,13 +22,48 @@ class MemberFuncEntry;
 class ClassEntry;
 class InheritEntry;
 
-typedef std::map<std::pair<std::string, std::string>,
-                 std::shared_ptr<toy::Entry>>::iterator SymTabIt;
+// Kinds of entries, in the order of their names, which is the order of the
+// entries in a table.
+enum class EntryKind : uint8_t {
+  CLASS,
+  FUNC,
+  INHERIT,
+  LOCAL,
+  MEMBER_FUNC,
+  MEMBER_VAR
+};
+
+// Returns the name of kind, e.g. "memberFunc" for MEMBER_FUNC.
+const char* EntryKindName(EntryKind kind);
 
+typedef std::vector<std::shared_ptr<toy::Entry>>::iterator SymTabIt;
+
+/**
+ * Table of the entries declared in a scope, linked to the table of the
+ * enclosing scope. The entries are stored in the order they were added, and
+ * referred to by their index in it. They are iterated over in the order of
+ * their kinds and names, which is the order they are printed and given their
+ * offsets in. An entry is keyed by its kind and name, or signature for
+ * functions, and indexed in a hash table for the lookups, with the names
+ * interned in a StringTable shared by all the tables of a program.
+ *
+ * The same hash table caches the lookups that went up the chain of tables, so
+ * that looking up the same identifier again takes a single probe. Changing a
+ * table with children bumps a generation shared by the program, which makes
+ * all the cached lookups stale. Only leaves, e.g. function tables getting
+ * their temps, change during the later passes, and they keep their caches.
+ *
+ * The tables of a program may be used from several threads at once while
+ * concurrent, as long as each thread only adds entries to tables that no
+ * other thread uses, e.g. those of the functions it checks, of names that
+ * were interned beforehand. No lookup is cached meanwhile.
+ */
 class SymbolTable : public std::enable_shared_from_this<SymbolTable> {
  public:
   SymbolTable() = delete;
   SymbolTable(std::string name, std::shared_ptr<SymbolTable> parent, int level);
+  SymbolTable(const SymbolTable&) = delete;
+  SymbolTable& operator=(const SymbolTable&) = delete;
 
   std::string Name() const;
   int Level() const;
@@ -40,11 +78,15 @@ class SymbolTable : public std::enable_shared_from_this<SymbolTable> {
   // Remove member functions
   void RemoveMemberFunctionDefinitions();
 
+  // Iterate over the entries by kind and name. Adding entries invalidates the
+  // iterators.
   SymTabIt Begin();
   SymTabIt End();
 
-  std::shared_ptr<toy::Entry> GetEntry(const std::string& kind,
+  std::shared_ptr<toy::Entry> GetEntry(EntryKind kind,
                                        const std::string& name) const;
+  // Returns the entry named name in the first table that has one, the first
+  // in the order of the kinds if there are several.
   std::shared_ptr<toy::Entry> GetEntry(const std::string& name) const;
   void AddEntry(std::shared_ptr<LocalVarEntry> entry);
   void AddEntry(std::shared_ptr<MemberVarEntry> entry);
@@ -53,52 +95,104 @@ class SymbolTable : public std::enable_shared_from_this<SymbolTable> {
   void AddEntry(std::shared_ptr<ClassEntry> entry);
   void AddEntry(std::shared_ptr<InheritEntry> entry);
 
+  // Both apply to all the tables of the program.
+  void SetConcurrent(bool concurrent);
+  void InternName(const std::string& name);
+
   static std::string GetFuncSignature(std::string cls, std::string name,
                                       std::vector<std::string> fparams);
   friend std::ostream& operator<<(std::ostream& os, const SymbolTable& symbtab);
 
  private:
+  // State shared by all the tables of a program
+  struct Shared {
+    StringTable symbols;
+    // Bumped whenever a table that has children changes, or is re-parented,
+    // so that the lookups cached by its descendants no longer hold.
+    uint64_t generation = 1;
+    // Whether the tables are in use from several threads
+    bool concurrent = false;
+  };
+
+  // A slot of the index, mapping a kind and an interned name to an entry, or
+  // a name alone to the first entry of that name in the order of the kinds. A
+  // slot may also cache where a lookup from this table found the entry in an
+  // enclosing table, or that it found none.
+  struct Slot {
+    const std::string* name;  // nullptr if the slot is empty
+    const SymbolTable* table;  // Of the entry, nullptr if none was found
+    // 0 for the own entries of the table, else the generation of the lookup
+    uint64_t generation;
+    uint32_t index;  // Of the entry in the table
+    EntryKind kind;
+    bool by_name;  // Whether the slot is for the name alone
+  };
+
+  typedef std::pair<EntryKind, std::string> EntryId;
+
+  std::shared_ptr<toy::Entry> Lookup(EntryKind kind, bool by_name,
+                                     const std::string* name) const;
+  const Slot* FindOwn(EntryKind kind, bool by_name,
+                      const std::string* name) const;
+  Slot& SlotFor(EntryKind kind, bool by_name, const std::string* name) const;
+  bool Contains(const EntryId& id) const;
+  void Insert(const EntryId& id, std::shared_ptr<toy::Entry> entry);
+  void Index(uint32_t index);
+  void Grow() const;
+  void RebuildIndex();
+  void Changed();
+  const std::vector<std::shared_ptr<toy::Entry>>& Sorted() const;
+
   std::string name_;
   int level_;
   std::shared_ptr<SymbolTable> parent_;
+  bool has_children_ = false;
   int mem_size_ = 0;
-  // The key is (entryKind, entryId), the value is the entry.
-  std::map<std::pair<std::string, std::string>, std::shared_ptr<toy::Entry>>
-      table_;
+  std::vector<std::shared_ptr<toy::Entry>> entries_;
+  std::vector<const std::string*> keys_;  // Interned name of each entry
+  // The entries by kind and name, empty when it needs sorting again
+  mutable std::vector<std::shared_ptr<toy::Entry>> sorted_;
+  std::shared_ptr<Shared> shared_;
+  // Open addressing, power of two size. Lookups add to it, like a cache.
+  mutable std::vector<Slot> slots_;
+  mutable std::size_t num_slots_used_ = 0;
   // Helper set to check for overloaded functions.
   std::set<std::string> funcs_;
 };
 std::ostream& operator<<(std::ostream& os, const SymbolTable& symbtab);
 
 /**
- * Base class for entries in the SymbolTable.
+ * Base class for entries in the SymbolTable. It has no virtual functions:
+ * what depends on the class of an entry switches on its kind, which tells it,
+ * and EntryCast converts an entry to its class.
  */
 class Entry {
  public:
   Entry() = delete;
-  Entry(std::string kind, std::string name, std::string type, int line,
+  Entry(EntryKind kind, std::string name, std::string type, int line,
         std::shared_ptr<SymbolTable> link);
-  std::string Kind() const;
+  EntryKind Kind() const;
   std::string Name() const;
   std::string Type() const;
   int Line() const;
   std::shared_ptr<SymbolTable> Link() const;
-  virtual std::vector<std::string> Dims() const;
+  std::vector<std::string> Dims() const;
 
   // memory size & offset, for code generation
   int size = 0;
   int offset = 0;
+  // Id of the function, for the entries of functions that are defined
+  FuncId func = FuncTable::NONE;
 
-  void SetKind(std::string kind);
   void SetName(std::string name);
   void SetType(std::string type);
   void SetLink(std::shared_ptr<SymbolTable> link);
 
   friend std::ostream& operator<<(std::ostream& os, const Entry& entry);
-  virtual void Print(std::ostream& os) const;
+  void Print(std::ostream& os) const;
 
  protected:
-  std::string kind_;  // Kind of entry, e.g. var, class, func, memberFunc...
+  EntryKind kind_;
   std::string name_;
   std::string type_;  // Data type, e.g. integer
   int line_;
@@ -108,12 +202,14 @@ std::ostream& operator<<(std::ostream& os, const Entry& entry);
 
 class LocalVarEntry : public Entry {
  public:
+  static const EntryKind KIND = EntryKind::LOCAL;
+
   LocalVarEntry(std::string name, std::string type, int line,
                 std::shared_ptr<SymbolTable> link,
                 std::vector<std::string> dims);
-  std::vector<std::string> Dims() const;
+  const std::vector<std::string>& Dims() const;
   void SetDims(std::vector<std::string> dims);
-  void Print(std::ostream& os) const override;
+  void Print(std::ostream& os) const;
 
  private:
   std::vector<std::string> dims_;
@@ -122,17 +218,19 @@ std::ostream& operator<<(std::ostream& os, const LocalVarEntry& entry);
 
 class MemberVarEntry : public Entry {
  public:
+  static const EntryKind KIND = EntryKind::MEMBER_VAR;
+
   MemberVarEntry(std::string name, std::string type, int line,
                  std::shared_ptr<SymbolTable> link,
                  std::vector<std::string> dims, std::string cls,
                  std::string visibility);
-  std::vector<std::string> Dims() const;
+  const std::vector<std::string>& Dims() const;
   std::string Class();
   std::string Visibility();
   void SetDims(std::vector<std::string> dims);
   void SetClass(std::string cls);
   void SetVisibility(std::string visibility);
-  void Print(std::ostream& os) const override;
+  void Print(std::ostream& os) const;
 
  private:
   std::vector<std::string> dims_;
@@ -143,16 +241,18 @@ std::ostream& operator<<(std::ostream& os, const MemberVarEntry& entry);
 
 class FreeFuncEntry : public Entry {
  public:
+  static const EntryKind KIND = EntryKind::FUNC;
+
   FreeFuncEntry(std::string name, std::string type, int line,
                 std::shared_ptr<SymbolTable> link,
                 std::vector<std::pair<std::string, std::string>> params,
                 std::string scope);
-  std::vector<std::pair<std::string, std::string>> Params();
+  const std::vector<std::pair<std::string, std::string>>& Params() const;
   std::string Scope();
-  std::string Signature();
+  std::string Signature() const;
   void SetParams(std::vector<std::pair<std::string, std::string>> params);
   void SetScope(std::string scope);
-  void Print(std::ostream& os) const override;
+  void Print(std::ostream& os) const;
 
  private:
   std::vector<std::pair<std::string, std::string>>
@@ -164,18 +264,20 @@ std::ostream& operator<<(std::ostream& os, const FreeFuncEntry& entry);
 
 class MemberFuncEntry : public Entry {
  public:
+  static const EntryKind KIND = EntryKind::MEMBER_FUNC;
+
   MemberFuncEntry(std::string name, std::string type, int line,
                   std::shared_ptr<SymbolTable> link,
                   std::vector<std::pair<std::string, std::string>> params,
                   std::string cls, std::string visibility);
-  std::vector<std::pair<std::string, std::string>> Params();
+  const std::vector<std::pair<std::string, std::string>>& Params() const;
   std::string Class();
   std::string Visibility();
   std::string Signature();
   void SetParams(std::vector<std::pair<std::string, std::string>> params);
   void SetClass(std::string cls);
   void SetVisibility(std::string visibility);
-  void Print(std::ostream& os) const override;
+  void Print(std::ostream& os) const;
 
  private:
   std::vector<std::pair<std::string, std::string>>
@@ -188,22 +290,35 @@ std::ostream& operator<<(std::ostream& os, const MemberFuncEntry& entry);
 
 class ClassEntry : public Entry {
  public:
+  static const EntryKind KIND = EntryKind::CLASS;
+
   ClassEntry(std::string name, int line, std::shared_ptr<SymbolTable> link);
-  void Print(std::ostream& os) const override;
+  void Print(std::ostream& os) const;
 };
 std::ostream& operator<<(std::ostream& os, const ClassEntry& entry);
 
 class InheritEntry : public Entry {
  public:
+  static const EntryKind KIND = EntryKind::INHERIT;
+
   InheritEntry(std::vector<std::string> inherit_list);
   std::vector<std::string> InheritList();
-  void Print(std::ostream& os) const override;
+  void Print(std::ostream& os) const;
 
  private:
   std::vector<std::string> inherit_list_;
 };
 std::ostream& operator<<(std::ostream& os, const InheritEntry& entry);
 
+// Returns entry as a T, or nullptr if it is of another kind.
+template <typename T>
+std::shared_ptr<T> EntryCast(const std::shared_ptr<Entry>& entry) {
+  if (entry == nullptr || entry->Kind() != T::KIND) {
+    return nullptr;
+  }
+  return std::static_pointer_cast<T>(entry);
+}
+
 }  // namespace toy
 
 #endif  // TOY_SYMBOL_TABLE_H_
\ No newline at end of file
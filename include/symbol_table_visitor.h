@@ -1,6 +1,7 @@
 #ifndef TOY_SYMBOL_TABLE_VISITOR_H_
 #define TOY_SYMBOL_TABLE_VISITOR_H_
 
+#include <map>
 #include <unordered_map>
 #include <vector>
 
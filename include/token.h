@@ -2,20 +2,25 @@
 #define TOY_TOKEN_H_
 
 #include <iostream>
+#include <string>
 
 namespace toy {
 
 enum class TokenType;
 
 /**
- * Represents a token generated by the lexer.
+ * Represents a token generated by the lexer. The lexeme is a handle to a
+ * string interned in a StringTable, which makes tokens cheap to copy.
  */
 class Token {
  public:
-  Token() = default;
-  Token(TokenType type, std::string lexeme, int line);
+  Token();
+  // Interns the lexeme in StringTable::Default().
+  Token(TokenType type, const std::string& lexeme, int line);
+  // The lexeme must be interned in a table that outlives the token.
+  Token(TokenType type, const std::string* lexeme, int line);
   TokenType Type() const;
-  std::string Lexeme() const;
+  const std::string& Lexeme() const;
   int Line() const;
   bool IsComment() const;
 
@@ -24,7 +29,7 @@ class Token {
 
  private:
   TokenType type_;
-  std::string lexeme_;
+  const std::string* lexeme_;
   int line_;  // first line the token appears in the source code.
 };
 bool operator==(const Token& tk1, const Token& tk2);
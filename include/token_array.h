@@ -0,0 +1,42 @@
+#ifndef TOY_TOKEN_ARRAY_H_
+#define TOY_TOKEN_ARRAY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "string_table.h"
+#include "token.h"
+
+namespace toy {
+
+/**
+ * All the tokens of a source, laid out as a struct of arrays: entry i of
+ * each array describes the i-th token. Comments are not included, and the
+ * last token is always EOS.
+ */
+struct TokenArray {
+  std::vector<TokenType> types;
+  std::vector<uint32_t> offsets;  // Offset of the token's first char
+  std::vector<uint32_t> lengths;  // Number of source chars the token spans
+  std::vector<int> lines;
+  std::vector<const std::string*> lexemes;  // Interned in strings
+  std::shared_ptr<StringTable> strings;     // Keeps the lexemes alive
+
+  std::size_t Size() const;
+  // Returns the i-th token.
+  Token At(std::size_t i) const;
+  void Reserve(std::size_t n);
+  void PushBack(TokenType type, uint32_t offset, uint32_t length, int line,
+                const std::string* lexeme);
+  // Replaces the tokens in [first, last) with all the tokens of with.
+  void Splice(std::size_t first, std::size_t last, const TokenArray& with);
+  // Moves the tokens from first on by the given number of chars and lines.
+  void Shift(std::size_t first, long offset_delta, int line_delta);
+};
+
+}  // namespace toy
+
+#endif  // TOY_TOKEN_ARRAY_H_
@@ -0,0 +1,40 @@
+#ifndef TOY_TRACE_SINK_H_
+#define TOY_TRACE_SINK_H_
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace toy {
+
+/**
+ * Buffered sink for diagnostic dumps such as the lexer's token log. Output
+ * is collected in memory and only written to the file on Flush() or when
+ * the sink is destroyed, so tracing costs no I/O per event.
+ */
+class TraceSink {
+ public:
+  explicit TraceSink(std::string filepath);
+  TraceSink(const TraceSink&) = delete;
+  TraceSink& operator=(const TraceSink&) = delete;
+  ~TraceSink();
+
+  template <typename T>
+  TraceSink& operator<<(const T& val) {
+    buf_ << val;
+    return *this;
+  }
+
+  // Writes out everything collected since the last flush. The file is
+  // created on the first flush.
+  void Flush();
+
+ private:
+  std::string filepath_;
+  std::ostringstream buf_;
+  std::ofstream ofs_;
+};
+
+}  // namespace toy
+
+#endif  // TOY_TRACE_SINK_H_
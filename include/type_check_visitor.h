@@ -1,4 +1,4 @@
-#ifndef TOY_TYPE_CHECK_VISITOR_H
+#ifndef TOY_TYPE_CHECK_VISITOR_H_
 #define TOY_TYPE_CHECK_VISITOR_H_
 
 #include "ast_visitor.h"
@@ -7,6 +7,11 @@ namespace toy {
 
 class TypeCheckVisitor : public ASTVisitor {
  public:
+  // Type of the members not found in their class, or of an undefined class.
+  // Spelled "typerror", it is not TypeTable::TYPE_ERROR but counts as a class
+  // type, which the errors reported for the expressions around depend on.
+  static const char* const UNDECLARED_MEMBER_TYPE;
+
   void Visit(AParamsNode& node) override;
   void Visit(AddOpNode& node) override;
   void Visit(ArithExprNode& node) override;
@@ -48,6 +53,11 @@ class TypeCheckVisitor : public ASTVisitor {
   void Visit(VarNode& node) override;
   void Visit(WhileNode& node) override;
   void Visit(WriteNode& node) override;
+
+ protected:
+  // Visits the next child of a VarNode, once the type of the previous one
+  // was propagated to it.
+  virtual void VisitChild(ASTNode& child);
 };
 
 }  // namespace toy
@@ -0,0 +1,49 @@
+#ifndef TOY_TYPE_TABLE_H_
+#define TOY_TYPE_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace toy {
+
+// Id of a type interned in a TypeTable.
+typedef uint32_t TypeId;
+
+/**
+ * Interns the names of the types of expressions, e.g. "integer", "float[]"
+ * or a class name, so that they are stored once and compared as ids.
+ */
+class TypeTable {
+ public:
+  // Ids of the types every table starts with.
+  static const TypeId NONE = 0;  // Spelled "", the type of untyped nodes
+  static const TypeId INTEGER = 1;
+  static const TypeId FLOAT = 2;
+  static const TypeId TYPE_ERROR = 3;
+
+  TypeTable();
+  TypeTable(const TypeTable&) = delete;
+  TypeTable& operator=(const TypeTable&) = delete;
+
+  // Returns the id of the type spelled name, adding it if needed.
+  TypeId Intern(const std::string& name);
+  const std::string& Name(TypeId id) const;
+  // Returns the number of distinct types in the table.
+  std::size_t Size() const;
+
+  // While concurrent, the table may be used from several threads at once,
+  // for the types in it only: interning any other throws std::logic_error.
+  void SetConcurrent(bool concurrent);
+
+ private:
+  std::unordered_map<std::string, TypeId> ids_;
+  std::vector<const std::string*> names_;  // By id, pointing into ids_
+  bool concurrent_ = false;
+};
+
+}  // namespace toy
+
+#endif  // TOY_TYPE_TABLE_H_
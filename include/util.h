@@ -29,8 +29,8 @@ void PPrintVector(const std::vector<T> vec) {
   std::cout << "]" << std::endl;
 };
 
-template <typename T>
-void PPrintSet(const std::set<T> vec) {
+template <typename T, typename Compare>
+void PPrintSet(const std::set<T, Compare> vec) {
   std::cout << "{";
   auto separator = ", ";
   auto sep = "";
@@ -1,56 +1,111 @@
 #include "ast.h"
 
+#include <algorithm>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "ast_visitor.h"
 #include "lexer.h"
 
 namespace toy {
 
-ASTNode::ASTNode()
+ASTNode* ChildSpan::at(std::size_t idx) const {
+  if (idx >= size_) {
+    throw std::out_of_range("No child " + std::to_string(idx) + " of " +
+                            std::to_string(size_));
+  }
+  return begin_[idx];
+}
+
+// Value of the non-leaf nodes
+static const std::string EMPTY_VAL;
+
+ASTNode::ASTNode(NodeKind kind)
     : symtab(nullptr),
       symtab_entry(nullptr),
-      val_(),
+      op_(Operator::NONE),
+      kind_(kind),
+      val_(&EMPTY_VAL),
       line_(),
-      type_(),
-      children_(){};
+      type_(TypeTable::NONE),
+      arena_(nullptr),
+      children_(nullptr),
+      num_children_(0),
+      children_capacity_(0){};
 
-ASTNode::ASTNode(std::string val, int line)
+ASTNode::ASTNode(NodeKind kind, const std::string* val, int line)
     : symtab(nullptr),
       symtab_entry(nullptr),
+      op_(Operator::NONE),
+      kind_(kind),
       val_(val),
       line_(line),
-      type_(),
-      children_(){};
+      type_(TypeTable::NONE),
+      arena_(nullptr),
+      children_(nullptr),
+      num_children_(0),
+      children_capacity_(0){};
 
-std::vector<std::shared_ptr<ASTNode>> ASTNode::Children() const {
-  return children_;
-}
+ASTNode* ASTNode::ChildAt(int idx) const { return Children().at(idx); }
 
-std::shared_ptr<ASTNode> ASTNode::ChildAt(int idx) const {
-  return children_.at(idx);
+void ASTNode::AddChild(ASTNode* child) {
+  if (num_children_ == children_capacity_) {
+    ReserveChildren(children_capacity_ == 0 ? 2 : 2 * children_capacity_);
+  }
+  children_[num_children_++] = child;
 }
 
-void ASTNode::AddChild(const std::shared_ptr<ASTNode>& child) {
-  children_.push_back(child);
+// The old array is left to the arena, which frees it along with the rest.
+void ASTNode::ReserveChildren(std::size_t n) {
+  if (n <= children_capacity_) {
+    return;
+  }
+  ASTNode** children = arena_->AllocateChildren(n);
+  std::copy(children_, children_ + num_children_, children);
+  children_ = children;
+  children_capacity_ = n;
 }
 
-std::string ASTNode::Type() const { return type_; };
-std::string ASTNode::Val() const { return val_; };
+const std::string& ASTNode::Type() const {
+  return arena_->types_.Name(type_);
+};
+TypeId ASTNode::TypeID() const { return type_; };
+const std::string& ASTNode::Val() const { return *val_; };
 int ASTNode::Line() const { return line_; };
+Operator ASTNode::Op() const { return op_; };
+TypeTable& ASTNode::Types() const { return arena_->types_; }
+FuncTable& ASTNode::Funcs() const { return arena_->funcs_; }
+StringTable& ASTNode::Strings() const { return arena_->strings_; }
 
-void ASTNode::SetType(std::string type) { type_ = type; }
-void ASTNode::SetVal(std::string val) { val_ = val; }
+void ASTNode::SetType(const std::string& type) {
+  type_ = arena_->types_.Intern(type);
+}
+void ASTNode::SetTypeID(TypeId type) { type_ = type; }
+void ASTNode::SetVal(const std::string& val) {
+  val_ = arena_->strings_.Intern(val);
+}
 void ASTNode::SetLine(int line) { line_ = line; }
 
+Operator OperatorOf(const std::string& lexeme) {
+  static const std::unordered_map<std::string, Operator> ops = {
+      {"+", Operator::PLUS}, {"-", Operator::MINUS}, {"or", Operator::OR},
+      {"*", Operator::MULT}, {"/", Operator::DIV},   {"and", Operator::AND},
+      {"==", Operator::EQ},  {"<>", Operator::NEQ},  {"<", Operator::LT},
+      {">", Operator::GT},   {"<=", Operator::LEQ},  {">=", Operator::GEQ}};
+  auto it = ops.find(lexeme);
+  return it == ops.end() ? Operator::NONE : it->second;
+}
+
 void ASTNode::ToDotFile(std::string filepath) {
   int node_id = 0;
   // lambda function for preorder traversal
-  std::function<void(std::shared_ptr<ASTNode>, std::ofstream&)> preorder;
-  preorder = [&](std::shared_ptr<ASTNode> node, std::ofstream& ofs) {
+  std::function<void(ASTNode*, std::ofstream&)> preorder;
+  preorder = [&](ASTNode* node, std::ofstream& ofs) {
     if (node == nullptr) return;
     auto curr_id = node_id;
     ofs << curr_id << "[label=\"" << *node << "\"]" << std::endl;
@@ -63,7 +118,7 @@ void ASTNode::ToDotFile(std::string filepath) {
   std::ofstream ofs(filepath);
   ofs << "digraph ast {" << std::endl;
   ofs << "node [shape=record];\n";
-  preorder(shared_from_this(), ofs);
+  preorder(this, ofs);
   ofs << "}";
 }
 
@@ -72,217 +127,289 @@ std::ostream& operator<<(std::ostream& os, const ASTNode& node) {
   return os;
 }
 
+typedef ASTNode* (*NodeFactory)(ASTArena& arena);
+typedef ASTNode* (*LeafFactory)(ASTArena& arena, const std::string* val,
+                                int line);
+
+template <typename T>
+static ASTNode* MakeNonLeaf(ASTArena& arena) {
+  return arena.New<T>();
+}
+
+template <typename T>
+static ASTNode* MakeLeaf(ASTArena& arena, const std::string* val, int line) {
+  return arena.New<T>(val, line);
+}
+
+// Factories of the non-leaf nodes, by kind.
+static const NodeFactory NODE_FACTORIES[] = {
+#define TOY_NODE_FACTORY(Kind, Node, name) MakeNonLeaf<Node>,
+    TOY_NON_LEAF_NODES(TOY_NODE_FACTORY)
+#undef TOY_NODE_FACTORY
+};
+
+// Factories of the leaf nodes, by kind less FIRST_LEAF_KIND.
+static const LeafFactory LEAF_FACTORIES[] = {
+#define TOY_LEAF_FACTORY(Kind, Node, name) MakeLeaf<Node>,
+    TOY_LEAF_NODES(TOY_LEAF_FACTORY)
+#undef TOY_LEAF_FACTORY
+};
+
+static const int NUM_NON_LEAF_KINDS = static_cast<int>(FIRST_LEAF_KIND);
+
+// Memory is taken from the system in blocks of this many bytes, or more for
+// larger requests.
+static const std::size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+ASTArena::ASTArena() : cur_(nullptr), end_(nullptr), bytes_reserved_(0) {}
+
+ASTArena::~ASTArena() {
+  for (ASTNode* node : nodes_) {
+    node->~ASTNode();
+  }
+}
+
+ASTNode* ASTArena::MakeNode(NodeKind kind) {
+  if (kind >= FIRST_LEAF_KIND) {
+    throw std::invalid_argument(NodeKindToString(kind) +
+                                " is not a valid ASTNode kind.");
+  }
+  return NODE_FACTORIES[static_cast<int>(kind)](*this);
+}
+
+ASTNode* ASTArena::MakeNode(NodeKind kind, const std::string& val, int line) {
+  if (kind < FIRST_LEAF_KIND || kind == NodeKind::NONE) {
+    throw std::invalid_argument(NodeKindToString(kind) +
+                                " is not a valid leaf ASTNode kind.");
+  }
+  return LEAF_FACTORIES[static_cast<int>(kind) - NUM_NON_LEAF_KINDS](
+      *this, strings_.Intern(val), line);
+}
+
+std::size_t ASTArena::NumNodes() const { return nodes_.size(); }
+
+std::size_t ASTArena::BytesReserved() const { return bytes_reserved_; }
+
+TypeTable& ASTArena::Types() { return types_; }
+
+FuncTable& ASTArena::Funcs() { return funcs_; }
+
+void* ASTArena::Allocate(std::size_t size, std::size_t align) {
+  std::size_t pad = (align - reinterpret_cast<uintptr_t>(cur_) % align) % align;
+  if (cur_ == nullptr || size + pad > static_cast<std::size_t>(end_ - cur_)) {
+    // Blocks from new[] are aligned for any type
+    std::size_t block_size = std::max(size, ARENA_BLOCK_SIZE);
+    blocks_.emplace_back(new char[block_size]);
+    cur_ = blocks_.back().get();
+    end_ = cur_ + block_size;
+    bytes_reserved_ += block_size;
+    pad = 0;
+  }
+  void* ptr = cur_ + pad;
+  cur_ += pad + size;
+  return ptr;
+}
+
+ASTNode** ASTArena::AllocateChildren(std::size_t n) {
+  return static_cast<ASTNode**>(
+      Allocate(n * sizeof(ASTNode*), alignof(ASTNode*)));
+}
+
+std::shared_ptr<ASTNode> ASTNode::MakeNode(NodeKind kind) {
+  auto arena = std::make_shared<ASTArena>();
+  return std::shared_ptr<ASTNode>(arena, arena->MakeNode(kind));
+}
+
 std::shared_ptr<ASTNode> ASTNode::MakeNode(const std::string& kind) {
-  if (kind == "aparams") {
-    return std::make_shared<AParamsNode>();
-  } else if (kind == "arithexpr") {
-    return std::make_shared<ArithExprNode>();
-  } else if (kind == "class") {
-    return std::make_shared<ClassNode>();
-  } else if (kind == "classlist") {
-    return std::make_shared<ClassListNode>();
-  } else if (kind == "datamember") {
-    return std::make_shared<DataMemberNode>();
-  } else if (kind == "dimlist") {
-    return std::make_shared<DimListNode>();
-  } else if (kind == "fcall") {
-    return std::make_shared<FuncCallNode>();
-  } else if (kind == "fparams") {
-    return std::make_shared<FParamsNode>();
-  } else if (kind == "fparamslist") {
-    return std::make_shared<FParamsListNode>();
-  } else if (kind == "funcbody") {
-    return std::make_shared<FuncBodyNode>();
-  } else if (kind == "funcdef") {
-    return std::make_shared<FuncDefNode>();
-  } else if (kind == "funcdeflist") {
-    return std::make_shared<FuncDefListNode>();
-  } else if (kind == "ifstat") {
-    return std::make_shared<IfStatNode>();
-  } else if (kind == "indicelist") {
-    return std::make_shared<IndiceList>();
-  } else if (kind == "inheritlist") {
-    return std::make_shared<InheritListNode>();
-  } else if (kind == "main") {
-    return std::make_shared<MainNode>();
-  } else if (kind == "memberfuncdecl") {
-    return std::make_shared<MemberFuncDeclNode>();
-  } else if (kind == "membervardecl") {
-    return std::make_shared<MemberVarDeclNode>();
-  } else if (kind == "memblist") {
-    return std::make_shared<MemberListNode>();
-  } else if (kind == "not") {
-    return std::make_shared<NotNode>();
-  } else if (kind == "prog") {
-    return std::make_shared<ProgNode>();
-  } else if (kind == "read") {
-    return std::make_shared<ReadNode>();
-  } else if (kind == "relexpr") {
-    return std::make_shared<RelExprNode>();
-  } else if (kind == "return") {
-    return std::make_shared<ReturnNode>();
-  } else if (kind == "scoperes") {
-    return std::make_shared<ScopeResNode>();
-  } else if (kind == "statlist") {
-    return std::make_shared<StatListNode>();
-  } else if (kind == "var") {
-    return std::make_shared<VarNode>();
-  } else if (kind == "vardecl") {
-    return std::make_shared<VarDeclNode>();
-  } else if (kind == "vardecl") {
-    return std::make_shared<VarDeclNode>();
-  } else if (kind == "vardecllist") {
-    return std::make_shared<VarDeclListNode>();
-  } else if (kind == "while") {
-    return std::make_shared<WhileNode>();
-  } else if (kind == "write") {
-    return std::make_shared<WriteNode>();
-  } else {
+  NodeKind node_kind = StringToNodeKind(kind);
+  if (node_kind >= FIRST_LEAF_KIND) {
     throw std::invalid_argument(kind + " is not a valid ASTNode kind.");
   }
+  return MakeNode(node_kind);
 }
 
-std::shared_ptr<ASTNode> ASTNode::MakeNode(const std::string& kind,
+std::shared_ptr<ASTNode> ASTNode::MakeNode(NodeKind kind,
                                            const std::string& val, int line) {
+  auto arena = std::make_shared<ASTArena>();
+  return std::shared_ptr<ASTNode>(arena, arena->MakeNode(kind, val, line));
+}
+
+// Returns the leaf kind spelled kind, which may also be the string of a token
+// type the leaf is built from, or NONE.
+static NodeKind LeafKindFromString(const std::string& kind) {
   if (kind == "sign") {
-    return std::make_shared<SignNode>(val, line);
+    return NodeKind::SIGN;
   } else if (kind == "dim") {
-    return std::make_shared<DimNode>(val, line);
+    return NodeKind::DIM;
   } else if (kind == "type") {
-    return std::make_shared<TypeNode>(val, line);
+    return NodeKind::TYPE;
   } else if (kind == "intNum") {
-    return std::make_shared<IntNumNode>(val, line);
+    return NodeKind::INT_NUM;
   } else if (kind == "+" || kind == "-" || kind == "or") {
-    return std::make_shared<AddOpNode>(val, line);
+    return NodeKind::ADD_OP;
   } else if (kind == "*" || kind == "/" || kind == "and") {
-    return std::make_shared<MultOpNode>(val, line);
+    return NodeKind::MULT_OP;
   } else if (kind == "floatNum") {
-    return std::make_shared<FloatNumNode>(val, line);
+    return NodeKind::FLOAT_NUM;
   } else if (kind == "id" || Lexer::IsReserved(kind)) {
-    return std::make_shared<IdNode>(val, line);
+    return NodeKind::ID;
   } else if (kind == "=") {
-    return std::make_shared<AssignNode>(val, line);
+    return NodeKind::ASSIGN;
   } else if (kind == "eq" || kind == "neq" || kind == "lt" || kind == "gt" ||
              kind == "leq" || kind == "geq") {
-    return std::make_shared<RelOpNode>(val, line);
+    return NodeKind::REL_OP;
   } else {
+    return NodeKind::NONE;
+  }
+}
+
+std::shared_ptr<ASTNode> ASTNode::MakeNode(const std::string& kind,
+                                           const std::string& val, int line) {
+  NodeKind node_kind = LeafKindFromString(kind);
+  if (node_kind == NodeKind::NONE) {
     throw std::invalid_argument(kind + " is not a valid leaf ASTNode kind.");
   }
+  return MakeNode(node_kind, val, line);
+}
+
+NodeKind ASTNode::LeafKindOf(TokenType type) {
+  // Token types are mapped once, instead of matching their strings per leaf.
+  static const std::vector<NodeKind> kinds = [] {
+    std::vector<NodeKind> kinds;
+    for (int type = 0; type <= static_cast<int>(TokenType::EOS); ++type) {
+      kinds.push_back(
+          LeafKindFromString(TokenTypeToString(static_cast<TokenType>(type))));
+    }
+    return kinds;
+  }();
+  return kinds[static_cast<int>(type)];
 }
 
-AddOpNode::AddOpNode(std::string val, int line) : ASTNode(val, line){};
+AddOpNode::AddOpNode(const std::string* val, int line)
+    : ASTNode(NodeKind::ADD_OP, val, line) {
+  op_ = OperatorOf(*val);
+};
 void AddOpNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string AddOpNode::ToStr() const { return "addOp | " + Val(); }
 
-AParamsNode::AParamsNode() : ASTNode(){};
+AParamsNode::AParamsNode() : ASTNode(NodeKind::APARAMS){};
 void AParamsNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string AParamsNode::ToStr() const { return "aParams"; }
 
-ArithExprNode::ArithExprNode() : ASTNode(){};
+ArithExprNode::ArithExprNode() : ASTNode(NodeKind::ARITH_EXPR){};
 void ArithExprNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string ArithExprNode::ToStr() const { return "arithExpr"; }
 
-IndiceList::IndiceList() : ASTNode(){};
+IndiceList::IndiceList() : ASTNode(NodeKind::INDICE_LIST){};
 void IndiceList::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string IndiceList::ToStr() const { return "indiceList"; }
 
-AssignNode::AssignNode(std::string val, int line) : ASTNode(val, line){};
+AssignNode::AssignNode(const std::string* val, int line)
+    : ASTNode(NodeKind::ASSIGN, val, line){};
 void AssignNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string AssignNode::ToStr() const { return "assign"; }
 
-ClassNode::ClassNode() : ASTNode(){};
+ClassNode::ClassNode() : ASTNode(NodeKind::CLASS){};
 void ClassNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string ClassNode::ToStr() const { return "class"; }
 
-ClassListNode::ClassListNode() : ASTNode(){};
+ClassListNode::ClassListNode() : ASTNode(NodeKind::CLASS_LIST){};
 void ClassListNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string ClassListNode::ToStr() const { return "classList"; }
 
-DataMemberNode::DataMemberNode() : ASTNode(){};
+DataMemberNode::DataMemberNode() : ASTNode(NodeKind::DATA_MEMBER){};
 void DataMemberNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string DataMemberNode::ToStr() const { return "dataMember"; }
 
-VarNode::VarNode() : ASTNode(){};
+VarNode::VarNode() : ASTNode(NodeKind::VAR){};
 void VarNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string VarNode::ToStr() const { return "var"; }
 
-DimListNode::DimListNode() : ASTNode(){};
+DimListNode::DimListNode() : ASTNode(NodeKind::DIM_LIST){};
 void DimListNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string DimListNode::ToStr() const { return "dimList"; }
 
-DimNode::DimNode(std::string val, int line) : ASTNode(val, line){};
+DimNode::DimNode(const std::string* val, int line)
+    : ASTNode(NodeKind::DIM, val, line){};
 void DimNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string DimNode::ToStr() const { return "dim | " + Val(); }
 
-FloatNumNode::FloatNumNode(std::string val, int line) : ASTNode(val, line){};
+FloatNumNode::FloatNumNode(const std::string* val, int line)
+    : ASTNode(NodeKind::FLOAT_NUM, val, line){};
 void FloatNumNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string FloatNumNode::ToStr() const { return "floatNum | " + Val(); }
 
-FParamsNode::FParamsNode() : ASTNode(){};
+FParamsNode::FParamsNode() : ASTNode(NodeKind::FPARAMS){};
 void FParamsNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string FParamsNode::ToStr() const { return "fParams"; }
 
-FParamsListNode::FParamsListNode() : ASTNode(){};
+FParamsListNode::FParamsListNode() : ASTNode(NodeKind::FPARAMS_LIST){};
 void FParamsListNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string FParamsListNode::ToStr() const { return "fParamsList"; }
 
-FuncBodyNode::FuncBodyNode() : ASTNode(){};
+FuncBodyNode::FuncBodyNode() : ASTNode(NodeKind::FUNC_BODY){};
 void FuncBodyNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string FuncBodyNode::ToStr() const { return "funcBody"; }
 
-FuncCallNode::FuncCallNode() : ASTNode(){};
+FuncCallNode::FuncCallNode() : ASTNode(NodeKind::FCALL){};
 void FuncCallNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string FuncCallNode::ToStr() const { return "fCall"; }
 
-FuncDefNode::FuncDefNode() : ASTNode(){};
+FuncDefNode::FuncDefNode() : ASTNode(NodeKind::FUNC_DEF){};
 void FuncDefNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string FuncDefNode::ToStr() const { return "funcDef"; }
 
-FuncDefListNode::FuncDefListNode() : ASTNode(){};
+FuncDefListNode::FuncDefListNode() : ASTNode(NodeKind::FUNC_DEF_LIST){};
 void FuncDefListNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string FuncDefListNode::ToStr() const { return "funcDefList"; }
 
-IdNode::IdNode(std::string val, int line) : ASTNode(val, line){};
+IdNode::IdNode(const std::string* val, int line)
+    : ASTNode(NodeKind::ID, val, line){};
 void IdNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string IdNode::ToStr() const { return "id | " + Val(); }
 
-IfStatNode::IfStatNode() : ASTNode(){};
+IfStatNode::IfStatNode() : ASTNode(NodeKind::IF_STAT){};
 void IfStatNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string IfStatNode::ToStr() const { return "ifStat"; }
 
-InheritListNode::InheritListNode() : ASTNode(){};
+InheritListNode::InheritListNode() : ASTNode(NodeKind::INHERIT_LIST){};
 void InheritListNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string InheritListNode::ToStr() const { return "inheritList"; }
 
-IntNumNode::IntNumNode(std::string val, int line) : ASTNode(val, line){};
+IntNumNode::IntNumNode(const std::string* val, int line)
+    : ASTNode(NodeKind::INT_NUM, val, line){};
 void IntNumNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string IntNumNode::ToStr() const { return "intNum | " + Val(); }
 
-MainNode::MainNode() : ASTNode(){};
+MainNode::MainNode() : ASTNode(NodeKind::MAIN){};
 void MainNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string MainNode::ToStr() const { return "main"; }
 
-MemberFuncDeclNode::MemberFuncDeclNode() : ASTNode(){};
+MemberFuncDeclNode::MemberFuncDeclNode()
+    : ASTNode(NodeKind::MEMBER_FUNC_DECL){};
 void MemberFuncDeclNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string MemberFuncDeclNode::ToStr() const { return "memFuncDecl"; }
 
-MemberListNode::MemberListNode() : ASTNode(){};
+MemberListNode::MemberListNode() : ASTNode(NodeKind::MEMB_LIST){};
 void MemberListNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string MemberListNode::ToStr() const { return "memberList"; }
 
-MemberVarDeclNode::MemberVarDeclNode() : ASTNode(){};
+MemberVarDeclNode::MemberVarDeclNode() : ASTNode(NodeKind::MEMBER_VAR_DECL){};
 void MemberVarDeclNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string MemberVarDeclNode::ToStr() const { return "memVarDecl"; }
 
-MultOpNode::MultOpNode(std::string val, int line) : ASTNode(val, line){};
+MultOpNode::MultOpNode(const std::string* val, int line)
+    : ASTNode(NodeKind::MULT_OP, val, line) {
+  op_ = OperatorOf(*val);
+};
 void MultOpNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string MultOpNode::ToStr() const { return "multOp | " + Val(); }
 
-NotNode::NotNode() : ASTNode(){};
+NotNode::NotNode() : ASTNode(NodeKind::NOT){};
 void NotNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string NotNode::ToStr() const { return "not"; }
 
-ProgNode::ProgNode() : ASTNode(){};
+ProgNode::ProgNode() : ASTNode(NodeKind::PROG){};
 void ProgNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string ProgNode::ToStr() const { return "prog"; }
 void ProgNode::set_sorted_classes(std::vector<std::string> sorted_classes) {
@@ -290,15 +417,18 @@ void ProgNode::set_sorted_classes(std::vector<std::string> sorted_classes) {
 }
 std::vector<std::string> ProgNode::sorted_classes() { return sorted_classes_; }
 
-ReadNode::ReadNode() : ASTNode(){};
+ReadNode::ReadNode() : ASTNode(NodeKind::READ){};
 void ReadNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string ReadNode::ToStr() const { return "read"; }
 
-RelExprNode::RelExprNode() : ASTNode(){};
+RelExprNode::RelExprNode() : ASTNode(NodeKind::REL_EXPR){};
 void RelExprNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string RelExprNode::ToStr() const { return "relExpr"; }
 
-RelOpNode::RelOpNode(std::string val, int line) : ASTNode(val, line){};
+RelOpNode::RelOpNode(const std::string* val, int line)
+    : ASTNode(NodeKind::REL_OP, val, line) {
+  op_ = OperatorOf(*val);
+};
 void RelOpNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string RelOpNode::ToStr() const {
   std::string str;
@@ -310,39 +440,43 @@ std::string RelOpNode::ToStr() const {
   return "relOp | " + str;
 }
 
-ReturnNode::ReturnNode() : ASTNode(){};
+ReturnNode::ReturnNode() : ASTNode(NodeKind::RETURN){};
 void ReturnNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string ReturnNode::ToStr() const { return "return"; }
 
-ScopeResNode::ScopeResNode() : ASTNode(){};
+ScopeResNode::ScopeResNode() : ASTNode(NodeKind::SCOPE_RES){};
 void ScopeResNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string ScopeResNode::ToStr() const { return "scopeRes"; }
 
-SignNode::SignNode(std::string val, int line) : ASTNode(val, line){};
+SignNode::SignNode(const std::string* val, int line)
+    : ASTNode(NodeKind::SIGN, val, line) {
+  op_ = OperatorOf(*val);
+};
 void SignNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string SignNode::ToStr() const { return "sign | " + Val(); }
 
-StatListNode::StatListNode() : ASTNode(){};
+StatListNode::StatListNode() : ASTNode(NodeKind::STAT_LIST){};
 void StatListNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string StatListNode::ToStr() const { return "statList"; }
 
-TypeNode::TypeNode(std::string val, int line) : ASTNode(val, line){};
+TypeNode::TypeNode(const std::string* val, int line)
+    : ASTNode(NodeKind::TYPE, val, line){};
 void TypeNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string TypeNode::ToStr() const { return "type | " + Val(); }
 
-VarDeclNode::VarDeclNode() : ASTNode(){};
+VarDeclNode::VarDeclNode() : ASTNode(NodeKind::VAR_DECL){};
 void VarDeclNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string VarDeclNode::ToStr() const { return "varDecl"; }
 
-VarDeclListNode::VarDeclListNode() : ASTNode(){};
+VarDeclListNode::VarDeclListNode() : ASTNode(NodeKind::VAR_DECL_LIST){};
 void VarDeclListNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string VarDeclListNode::ToStr() const { return "varDeclList"; }
 
-WhileNode::WhileNode() : ASTNode(){};
+WhileNode::WhileNode() : ASTNode(NodeKind::WHILE){};
 void WhileNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string WhileNode::ToStr() const { return "while"; }
 
-WriteNode::WriteNode() : ASTNode(){};
+WriteNode::WriteNode() : ASTNode(NodeKind::WRITE){};
 void WriteNode::Accept(ASTVisitor& v) { v.Visit(*this); }
 std::string WriteNode::ToStr() const { return "write"; }
 
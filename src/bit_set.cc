@@ -0,0 +1,47 @@
+#include "bit_set.h"
+
+namespace toy {
+
+BitSet::BitSet(std::size_t size) : size_(size), words_((size + 63) / 64) {}
+
+std::size_t BitSet::Size() const { return size_; }
+
+bool BitSet::Contains(std::size_t i) const {
+  return (words_[i / 64] >> (i % 64)) & 1;
+}
+
+void BitSet::Insert(std::size_t i) {
+  words_[i / 64] |= uint64_t(1) << (i % 64);
+}
+
+void BitSet::Erase(std::size_t i) {
+  words_[i / 64] &= ~(uint64_t(1) << (i % 64));
+}
+
+bool BitSet::UnionWith(const BitSet& other) {
+  uint64_t added = 0;
+  for (std::size_t w = 0; w < words_.size(); ++w) {
+    added |= other.words_[w] & ~words_[w];
+    words_[w] |= other.words_[w];
+  }
+  return added != 0;
+}
+
+bool BitSet::UnionWithout(const BitSet& other, std::size_t excluded) {
+  uint64_t added = 0;
+  for (std::size_t w = 0; w < words_.size(); ++w) {
+    uint64_t word = other.words_[w];
+    if (w == excluded / 64) {
+      word &= ~(uint64_t(1) << (excluded % 64));
+    }
+    added |= word & ~words_[w];
+    words_[w] |= word;
+  }
+  return added != 0;
+}
+
+bool operator==(const BitSet& set1, const BitSet& set2) {
+  return set1.size_ == set2.size_ && set1.words_ == set2.words_;
+}
+
+}  // namespace toy
@@ -0,0 +1,111 @@
+#include "char_scan.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace toy {
+namespace scan {
+
+namespace {
+
+bool IsWhitespace(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+#if defined(__AVX2__)
+
+const int VEC_SIZE = 32;
+typedef unsigned int Mask;
+const Mask ALL_SET = 0xFFFFFFFF;
+
+// Returns one bit per byte of the 32 bytes at p, for whitespace and '\n'.
+void WhitespaceMasks(const char* p, Mask& ws, Mask& nl) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  // '\t' to '\r' are the only whitespace besides ' ': check v - '\t' <= 4.
+  __m256i ctrl = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+  __m256i is_ctrl =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(ctrl, _mm256_set1_epi8(4)), ctrl);
+  __m256i is_space = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+  ws = _mm256_movemask_epi8(_mm256_or_si256(is_ctrl, is_space));
+  nl = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+}
+
+// Returns one bit per byte of the 32 bytes at p, for c and '\n'.
+void CharMasks(const char* p, char c, Mask& found, Mask& nl) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  found = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+  nl = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+}
+
+#elif defined(__SSE2__)
+
+const int VEC_SIZE = 16;
+typedef unsigned int Mask;
+const Mask ALL_SET = 0xFFFF;
+
+void WhitespaceMasks(const char* p, Mask& ws, Mask& nl) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i ctrl = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+  __m128i is_ctrl = _mm_cmpeq_epi8(_mm_min_epu8(ctrl, _mm_set1_epi8(4)), ctrl);
+  __m128i is_space = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+  ws = _mm_movemask_epi8(_mm_or_si128(is_ctrl, is_space));
+  nl = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+}
+
+void CharMasks(const char* p, char c, Mask& found, Mask& nl) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  found = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+  nl = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+}
+
+#endif
+
+}  // namespace
+
+const char* SkipWhitespace(const char* p, const char* end, int& lines) {
+#if defined(__AVX2__) || defined(__SSE2__)
+  while (end - p >= VEC_SIZE) {
+    Mask ws, nl;
+    WhitespaceMasks(p, ws, nl);
+    if (ws != ALL_SET) {
+      int n = __builtin_ctz(~ws);
+      lines += __builtin_popcount(nl & ((1u << n) - 1));
+      return p + n;
+    }
+    lines += __builtin_popcount(nl);
+    p += VEC_SIZE;
+  }
+#endif
+  while (p != end && IsWhitespace(*p)) {
+    if (*p++ == '\n') {
+      lines++;
+    }
+  }
+  return p;
+}
+
+const char* FindChar(const char* p, const char* end, char c, int& lines) {
+#if defined(__AVX2__) || defined(__SSE2__)
+  while (end - p >= VEC_SIZE) {
+    Mask found, nl;
+    CharMasks(p, c, found, nl);
+    if (found) {
+      int n = __builtin_ctz(found);
+      lines += __builtin_popcount(nl & ((1u << n) - 1));
+      return p + n;
+    }
+    lines += __builtin_popcount(nl);
+    p += VEC_SIZE;
+  }
+#endif
+  while (p != end && *p != c) {
+    if (*p++ == '\n') {
+      lines++;
+    }
+  }
+  return p;
+}
+
+}  // namespace scan
+}  // namespace toy
@@ -1,6 +1,5 @@
 #include "code_gen_visitor.h"
 
-#include <algorithm>
 #include <fstream>
 
 #include "ast.h"
@@ -23,7 +22,7 @@ CodeGenVisitor::CodeGenVisitor()
   }
   // Registers reserved for runtime offset calculation storage
   for (int i = 12; i >= 9; i--) {
-    offset_register_pool_.push("r" + std::to_string(i));
+    offset_register_pool_.push(i);
   }
   procedure_map_ = CodeGenVisitor::InitProcedureMap();
 };
@@ -47,18 +46,21 @@ void CodeGenVisitor::AddHeaderComment(const std::string& comment) {
   AddComment("--------------------------------------------------------------%");
 }
 
+// Returns the name of register number num, e.g. r3.
+static std::string RegisterName(int num) { return "r" + std::to_string(num); }
+
 // start offset if the offset stored at the node is not r0
 void CodeGenVisitor::StartOffsetIf(const ASTNode& node) {
-  if (node.regist != "r0") {
+  if (node.regist != 0) {
     AddComment("Start array offsetting");
-    AddExecLine("add r14, r14, " + node.regist);
+    AddExecLine("add r14, r14, " + RegisterName(node.regist));
   }
 }
 
 void CodeGenVisitor::EndOffsetIf(ASTNode& node) {
-  if (node.regist != "r0") {
+  if (node.regist != 0) {
     AddComment("End array offsetting");
-    AddExecLine("sub r14, r14, " + node.regist);
+    AddExecLine("sub r14, r14, " + RegisterName(node.regist));
     offset_register_pool_.push(node.regist);
   }
 }
@@ -186,12 +188,12 @@ void CodeGenVisitor::HandleOr(AddOpNode& node) {
 // at the memory address offset calculated in MemSizeVisitor
 void CodeGenVisitor::Visit(AddOpNode& node) {
   DFS(node);
-  std::string op = node.Val();
-  if (op == "or") {
+  if (node.Op() == Operator::OR) {
     HandleOr(node);
     return;
   }
-  std::string instruction = GetInstructionFromOp(op);
+  const std::string& op = node.Val();
+  std::string instruction = GetInstructionFromOp(node.Op());
   std::string r1 = register_pool_.top();
   register_pool_.pop();
   std::string r2 = register_pool_.top();
@@ -232,11 +234,11 @@ void CodeGenVisitor::Visit(AddOpNode& node) {
 // at the memory address offset calculated in MemSizeVisitor
 void CodeGenVisitor::Visit(MultOpNode& node) {
   DFS(node);
-  std::string op = node.Val();
-  if (op == "and") {
+  if (node.Op() == Operator::AND) {
     HandleAnd(node);
     return;
   }
+  const std::string& op = node.Val();
   std::string r1 = register_pool_.top();
   register_pool_.pop();
   std::string r2 = register_pool_.top();
@@ -252,7 +254,7 @@ void CodeGenVisitor::Visit(MultOpNode& node) {
   std::string rhs_name = rhs_entry->Name();
   int rhs_offset = rhs_entry->offset;
   int tmp_offset = node.symtab_entry->offset;
-  std::string instruction = GetInstructionFromOp(op);
+  std::string instruction = GetInstructionFromOp(node.Op());
 
   AddComment(lhs_name + " " + op + " " + rhs_name);
   // LHS
@@ -291,8 +293,8 @@ void CodeGenVisitor::Visit(RelExprNode& node) {
   std::string rhs_name = rhs_entry->Name();
   int rhs_offset = rhs_entry->offset;
   int tmp_offset = node.symtab_entry->offset;
-  std::string op = node.ChildAt(1)->Val();
-  std::string instruction = GetInstructionFromOp(op);
+  const std::string& op = node.ChildAt(1)->Val();
+  std::string instruction = GetInstructionFromOp(node.ChildAt(1)->Op());
 
   AddComment(lhs_name + " " + op + " " + rhs_name);
   // LHS
@@ -323,7 +325,7 @@ void CodeGenVisitor::Visit(VarNode& node) {
       child->Accept(*this);
       type = child->Type();
       entry_name += sep + child->ChildAt(0)->Val();
-      if (child->symtab_entry->Kind() == "memberVar") {
+      if (child->symtab_entry->Kind() == EntryKind::MEMBER_VAR) {
         offset -= child->symtab_entry->offset + child->symtab_entry->size;
       } else {
         offset += child->symtab_entry->offset;
@@ -345,15 +347,17 @@ void CodeGenVisitor::Visit(VarNode& node) {
 void CodeGenVisitor::Visit(DataMemberNode& node) {
   DFS(node);
 
-  auto entry = node.symtab->GetEntry("local", node.ChildAt(0)->Val());
+  const std::string& name = node.ChildAt(0)->Val();
+  auto entry = node.symtab->GetEntry(EntryKind::LOCAL, name);
   if (!entry) {
-    entry = node.symtab->GetEntry("class", node.cls);
+    entry =
+        node.symtab->GetEntry(EntryKind::CLASS, node.Types().Name(node.cls));
     if (entry) {
-      entry = entry->Link()->GetEntry("memberVar", node.ChildAt(0)->Val());
+      entry = entry->Link()->GetEntry(EntryKind::MEMBER_VAR, name);
     }
     // Inside a member function
     else {
-      entry = node.symtab->GetEntry("memberVar", node.ChildAt(0)->Val());
+      entry = node.symtab->GetEntry(EntryKind::MEMBER_VAR, name);
     }
   }
   node.symtab_entry = std::shared_ptr<Entry>(entry);
@@ -364,7 +368,8 @@ void CodeGenVisitor::Visit(DataMemberNode& node) {
   if (node.ChildAt(1)->Children().size() > 0) {
     node.regist = offset_register_pool_.top();
     offset_register_pool_.pop();
-    AddExecLine("add " + node.regist + ", r0, r0");
+    std::string offset_reg = RegisterName(node.regist);
+    AddExecLine("add " + offset_reg + ", r0, r0");
     auto vec = node.ChildAt(1)->Children();
     uint64_t i = 1;
     for (auto it = vec.begin(); it != vec.end(); ++it) {
@@ -377,7 +382,7 @@ void CodeGenVisitor::Visit(DataMemberNode& node) {
       if (i < dims.size()) {
         AddExecLine("muli r2, r2, " + dims.at(i));
       }
-      AddExecLine("add " + node.regist + ", " + node.regist + ", r2");
+      AddExecLine("add " + offset_reg + ", " + offset_reg + ", r2");
       i++;
     }
   }
@@ -490,20 +495,7 @@ void CodeGenVisitor::Visit(ReadNode& node) {
 }
 
 void CodeGenVisitor::Visit(FuncDefNode& node) {
-  std::string func_tag;
-  if (node.ChildAt(1)->Children().size() == 0) {
-    func_tag = node.symtab_entry->Name();
-  } else {
-    func_tag = node.ChildAt(1)->ChildAt(0)->Val() + node.symtab_entry->Name();
-  }
-
-  for (auto param : node.ChildAt(2)->Children()) {
-    func_tag += param->ChildAt(0)->Val();
-  }
-  func_tag.erase(
-      std::remove_if(func_tag.begin(), func_tag.end(),
-                     [](auto const& c) -> bool { return !std::isalnum(c); }),
-      func_tag.end());
+  const std::string& func_tag = node.Funcs().Label(node.symtab_entry->func);
   AddHeaderComment("Start of function definition: " + func_tag);
   // Create the tag to jump onto after function is done and also
   // copy the jumping-back address as the second thing on function call stack
@@ -535,44 +527,31 @@ void CodeGenVisitor::Visit(ReturnNode& node) {
 
 void CodeGenVisitor::Visit(FuncCallNode& node) {
   DFS(node);
-  // TODO: Refactor to have func_signature as a member of fcallNode.
-  std::string class_name = node.cls;
-  std::string func_name = node.ChildAt(0)->Val();
-  std::string func_tag = class_name + func_name;
-  std::vector<std::string> fparams;
-  for (auto& param : node.ChildAt(1)->Children()) {
-    fparams.push_back(param->Type());
-    func_tag += param->Type();
-  }
-  std::string func_signature = SymbolTable::GetFuncSignature(
-      class_name, node.ChildAt(0)->Val(), fparams);
-  std::shared_ptr<Entry> func_entry =
-      node.symtab->GetEntry("func", func_signature);
-  if (!func_entry) {
-    func_entry = node.symtab->GetEntry("class", class_name)
-                     ->Link()
-                     ->GetEntry("memberFunc", func_signature);
-  }
-  // Erase non-alphanum from functag, else error in the assembly
-  func_tag.erase(
-      std::remove_if(func_tag.begin(), func_tag.end(),
-                     [](auto const& c) -> bool { return !std::isalnum(c); }),
-      func_tag.end());
-  auto func_symtab = func_entry->Link();
+  // The function was resolved during type checking
+  const FreeFuncEntry& func_entry = node.Funcs().Func(node.func);
+  const std::string& func_tag = node.Funcs().Label(node.func);
+  auto func_symtab = func_entry.Link();
 
   std::string r1 = register_pool_.top();
   register_pool_.pop();
   AddComment("Function call to " + func_tag);
   // Parameter passing
+  const auto& func_params = func_entry.Params();
   int idx_of_param = 0;
   for (auto param : node.ChildAt(1)->Children()) {
     int passed_param_offset = param->symtab_entry->offset;
     int passed_param_size = param->symtab_entry->size;
-    if (param->regist != "r0") {
+    if (param->regist != 0) {
       for (auto dim : param->symtab_entry->Dims()) {
         passed_param_size /= std::stoi(dim);
       }
     }
+    // The offset of the parameter inside the function's call stack
+    int offsetofparam =
+        node.symtab->ScopeSize() +
+        func_symtab
+            ->GetEntry(EntryKind::LOCAL, func_params.at(idx_of_param).first)
+            ->offset;
     // copy word by word
     for (int i = 0; i < passed_param_size; i += 4) {
       // Loading the PASSED value into r1
@@ -582,29 +561,6 @@ void CodeGenVisitor::Visit(FuncCallNode& node) {
       EndOffsetIf(*param);
       // Storing that passed value at the calculated offset residing inside the
       // function's call stack
-
-      int offsetofparam;
-      if (func_entry->Kind() == "func") {
-        offsetofparam =
-            node.symtab->ScopeSize() +
-            func_symtab
-                ->GetEntry("local",
-                           std::dynamic_pointer_cast<FreeFuncEntry>(func_entry)
-                               ->Params()
-                               .at(idx_of_param)
-                               .first)
-                ->offset;
-      } else {
-        offsetofparam =
-            node.symtab->ScopeSize() +
-            func_symtab
-                ->GetEntry("local", std::dynamic_pointer_cast<MemberFuncEntry>(
-                                        func_entry)
-                                        ->Params()
-                                        .at(idx_of_param)
-                                        .first)
-                ->offset;
-      }
       AddExecLine("sw " + std::to_string(offsetofparam + i) + "(r14), " + r1);
     }
 
@@ -689,39 +645,39 @@ void CodeGenVisitor::Visit(VarDeclListNode& node) { DFS(node); }
 void CodeGenVisitor::Visit(VarDeclNode& node) { DFS(node); }
 
 // Gets the appropriate instruction given the operator
-std::string CodeGenVisitor::GetInstructionFromOp(const std::string& op) {
-  std::string instruction;
-  // Add operators
-  if (op == "+") {
-    instruction = "add ";
-  } else if (op == "-") {
-    instruction = "sub ";
-  } else if (op == "or") {
-    instruction = "or ";
-  }
-  // Mult operators
-  else if (op == "*") {
-    instruction = "mul ";
-  } else if (op == "/") {
-    instruction = "div ";
-  } else if (op == "and") {
-    instruction = "and ";
-  }
-  // Relational operators
-  if (op == "==") {
-    instruction = "ceq ";
-  } else if (op == "<>") {
-    instruction = "cne ";
-  } else if (op == "<") {
-    instruction = "clt ";
-  } else if (op == ">") {
-    instruction = "cgt ";
-  } else if (op == "<=") {
-    instruction = "cle ";
-  } else if (op == ">=") {
-    instruction = "cge ";
+std::string CodeGenVisitor::GetInstructionFromOp(Operator op) {
+  switch (op) {
+    // Add operators
+    case Operator::PLUS:
+      return "add ";
+    case Operator::MINUS:
+      return "sub ";
+    case Operator::OR:
+      return "or ";
+    // Mult operators
+    case Operator::MULT:
+      return "mul ";
+    case Operator::DIV:
+      return "div ";
+    case Operator::AND:
+      return "and ";
+    // Relational operators
+    case Operator::EQ:
+      return "ceq ";
+    case Operator::NEQ:
+      return "cne ";
+    case Operator::LT:
+      return "clt ";
+    case Operator::GT:
+      return "cgt ";
+    case Operator::LEQ:
+      return "cle ";
+    case Operator::GEQ:
+      return "cge ";
+    case Operator::NONE:
+      break;
   }
-  return instruction;
+  return "";
 }
 
 // Add procedure if we didn't already
@@ -0,0 +1,40 @@
+#include "func_table.h"
+
+#include <cctype>
+#include <stdexcept>
+
+#include "symbol_table.h"
+
+namespace toy {
+
+const FuncId FuncTable::NONE;
+
+FuncTable::FuncTable() {}
+
+FuncId FuncTable::Add(std::shared_ptr<FreeFuncEntry> entry) {
+  // Only alphanumerics are allowed in the labels of the assembly
+  std::string label;
+  for (char c : entry->Signature()) {
+    if (std::isalnum(static_cast<unsigned char>(c))) {
+      label += c;
+    }
+  }
+  funcs_.push_back({entry, label});
+  entry->func = static_cast<FuncId>(funcs_.size());
+  return entry->func;
+}
+
+const FreeFuncEntry& FuncTable::Func(FuncId id) const { return *At(id).entry; }
+
+const std::string& FuncTable::Label(FuncId id) const { return At(id).label; }
+
+std::size_t FuncTable::Size() const { return funcs_.size(); }
+
+const FuncTable::Function& FuncTable::At(FuncId id) const {
+  if (id == NONE || id > funcs_.size()) {
+    throw std::out_of_range("No function of id " + std::to_string(id));
+  }
+  return funcs_[id - 1];
+}
+
+}  // namespace toy
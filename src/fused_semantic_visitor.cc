@@ -0,0 +1,90 @@
+#include "fused_semantic_visitor.h"
+
+#include "logger.h"
+
+namespace toy {
+
+FusedSemanticVisitor::FusedSemanticVisitor()
+    : type_check_(*this), mem_size_(type_check_), sizing_(false) {}
+
+bool FusedSemanticVisitor::Sized() const { return sizing_; }
+
+FusedSemanticVisitor::TypeCheckStep::TypeCheckStep(FusedSemanticVisitor& fused)
+    : fused_(fused) {}
+
+void FusedSemanticVisitor::TypeCheckStep::DFS(ASTNode& node) {
+  for (auto& child : node.Children()) {
+    child->Accept(fused_);
+  }
+}
+
+void FusedSemanticVisitor::TypeCheckStep::VisitChild(ASTNode& child) {
+  child.Accept(fused_);
+}
+
+FusedSemanticVisitor::MemSizeStep::MemSizeStep(TypeCheckStep& type_check)
+    : type_check_(type_check) {}
+
+// Every MemSizeVisitor::Visit sizes the node after its DFS, so type checking
+// the node there runs it before the sizing, and after the class sizes
+void FusedSemanticVisitor::MemSizeStep::DFS(ASTNode& node) {
+  node.Accept(type_check_);
+}
+
+template <class T>
+void FusedSemanticVisitor::VisitNode(T& node) {
+  if (sizing_) {
+    mem_size_.Visit(node);
+  } else {
+    type_check_.Visit(node);
+  }
+}
+
+// Symbol table errors can leave the class sizes undefined
+void FusedSemanticVisitor::Visit(ProgNode& node) {
+  sizing_ = !Logger::HasErrors();
+  VisitNode(node);
+}
+
+void FusedSemanticVisitor::Visit(AParamsNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(AddOpNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(ArithExprNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(AssignNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(ClassListNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(ClassNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(DataMemberNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(DimListNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(DimNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(FParamsListNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(FParamsNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(FloatNumNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(FuncBodyNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(FuncCallNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(FuncDefListNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(FuncDefNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(IdNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(IfStatNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(IndiceList& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(InheritListNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(IntNumNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(MainNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(MemberFuncDeclNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(MemberListNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(MemberVarDeclNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(MultOpNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(NotNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(ReadNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(RelExprNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(RelOpNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(ReturnNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(ScopeResNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(SignNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(StatListNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(TypeNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(VarDeclListNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(VarDeclNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(VarNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(WhileNode& node) { VisitNode(node); }
+void FusedSemanticVisitor::Visit(WriteNode& node) { VisitNode(node); }
+
+}  // namespace toy
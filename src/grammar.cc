@@ -1,9 +1,11 @@
 #include "grammar.h"
 
 #include <algorithm>
+#include <deque>
 #include <fstream>
 #include <iterator>
 #include <sstream>
+#include <unordered_map>
 
 #include "util.h"
 
@@ -41,56 +43,103 @@ SymbolType StringToSymbolType(const std::string& str) {
   }
 }
 
-Symbol::Symbol(std::string s)
-    : s_(util::TrimString(s)), type_(StringToSymbolType(s_)) {}
+// Spellings of all symbols by id, and the id of each spelling. Spellings are
+// kept in a deque so references to them stay valid.
+struct SymbolNames {
+  std::deque<std::string> strs;
+  std::unordered_map<std::string, int> ids;
+};
 
-Symbol::Symbol(SymbolType type) : s_(SymbolTypeToString(type)), type_(type) {}
+static SymbolNames& Names() {
+  static SymbolNames names;
+  return names;
+}
+
+static int InternSymbol(const std::string& s) {
+  SymbolNames& names = Names();
+  auto it = names.ids.find(s);
+  if (it != names.ids.end()) {
+    return it->second;
+  }
+  names.strs.push_back(s);
+  names.ids.emplace(s, names.strs.size() - 1);
+  return names.strs.size() - 1;
+}
 
-Symbol::Symbol(Token tk)
-    : s_("'" + TokenTypeToString(tk.Type()) + "'"),
-      type_(StringToSymbolType(s_)) {}
+Symbol::Symbol(std::string s) {
+  s = util::TrimString(s);
+  id_ = InternSymbol(s);
+  type_ = StringToSymbolType(s);
+}
+
+Symbol::Symbol(SymbolType type)
+    : id_(InternSymbol(SymbolTypeToString(type))), type_(type) {}
+
+// Token types are mapped to their terminal once, instead of spelling the
+// terminal out on every conversion.
+Symbol::Symbol(Token tk) {
+  static std::vector<Symbol> terms(static_cast<int>(TokenType::EOS) + 1);
+  Symbol& term = terms[static_cast<int>(tk.Type())];
+  if (term.id_ == -1) {
+    std::string s = "'" + TokenTypeToString(tk.Type()) + "'";
+    term.id_ = InternSymbol(s);
+    term.type_ = StringToSymbolType(s);
+  }
+  *this = term;
+}
 
 SymbolType Symbol::Type() const { return type_; }
 
-std::string Symbol::Str() const { return s_; }
+const std::string& Symbol::Str() const { return Names().strs[id_]; }
 
-std::string Symbol::RawStr() const { return s_.substr(1, s_.size() - 2); }
+std::string Symbol::RawStr() const {
+  const std::string& s = Str();
+  return s.substr(1, s.size() - 2);
+}
 
 bool Symbol::IsTerm() const {
   return type_ == SymbolType::TERM || type_ == SymbolType::EPSILON;
 }
 
-bool Symbol::operator<(const Symbol& rhs) const { return s_ < rhs.s_; }
+int Symbol::Id() const { return id_; }
+
+int Symbol::NumIds() { return Names().strs.size(); }
+
+bool Symbol::operator<(const Symbol& rhs) const { return id_ < rhs.id_; }
 
 std::ostream& operator<<(std::ostream& os, const Symbol& symb) {
-  os << symb.s_;
+  os << symb.Str();
   return os;
 }
 
 bool operator==(const Symbol& symb1, const Symbol& symb2) {
-  return symb1.s_ == symb2.s_;
+  return symb1.id_ == symb2.id_;
 }
 
 bool operator!=(const Symbol& symb1, const Symbol& symb2) {
-  return symb1.s_ != symb2.s_;
+  return symb1.id_ != symb2.id_;
 }
 
 bool operator==(const Symbol& symb, const Token& tk) {
-  return symb.RawStr() == TokenTypeToString(tk.Type());
+  return symb == Symbol(tk);
 }
 
 bool operator!=(const Symbol& symb, const Token& tk) {
-  return symb.RawStr() != TokenTypeToString(tk.Type());
+  return symb != Symbol(tk);
 }
 
-Grammar::Grammar() { ReadGrammar(GRAMMAR_FILEPATH); }
-
-Grammar::Grammar(std::string filepath) { ReadGrammar(filepath); }
+Grammar::Grammar() : Grammar(GRAMMAR_FILEPATH) {}
 
-void Grammar::ReadGrammar(const std::string& filepath) {
+Grammar::Grammar(std::string filepath) {
   std::ifstream file(filepath);
+  ReadGrammar(file);
+}
+
+Grammar::Grammar(std::istream& is) { ReadGrammar(is); }
+
+void Grammar::ReadGrammar(std::istream& is) {
   std::string line;
-  while (std::getline(file, line)) {
+  while (std::getline(is, line)) {
     if (line.length() == 0) {
       continue;
     }
@@ -1,116 +1,441 @@
 #include "lexer.h"
 
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include "char_scan.h"
 #include "logger.h"
 #include "token.h"
 
 namespace toy {
 
-static const std::string OUT_TOKENS_FILEPATH = "../out/outlextokens";
+// Returns kw_type if the len chars at s spell the keyword kw, else ID.
+static constexpr TokenType MatchReservedWord(const char* s, const char* kw,
+                                             std::size_t len,
+                                             TokenType kw_type) {
+  for (std::size_t i = 0; i < len; ++i) {
+    if (s[i] != kw[i]) {
+      return TokenType::ID;
+    }
+  }
+  return kw_type;
+}
+
+// Classifies the len chars at s as a reserved word or an id. Switching on
+// the length and a distinguishing char leaves at most one candidate keyword,
+// so each word costs a single comparison.
+static constexpr TokenType ClassifyWord(const char* s, std::size_t len) {
+  switch (len) {
+    case 2:
+      switch (s[0]) {
+        case 'd':
+          return MatchReservedWord(s, "do", 2, TokenType::DO);
+        case 'i':
+          return MatchReservedWord(s, "if", 2, TokenType::IF);
+        case 'o':
+          return MatchReservedWord(s, "or", 2, TokenType::OR);
+      }
+      break;
+    case 3:
+      switch (s[0]) {
+        case 'a':
+          return MatchReservedWord(s, "and", 3, TokenType::AND);
+        case 'e':
+          return MatchReservedWord(s, "end", 3, TokenType::END);
+        case 'n':
+          return MatchReservedWord(s, "not", 3, TokenType::NOT);
+      }
+      break;
+    case 4:
+      switch (s[0]) {
+        case 'e':
+          return MatchReservedWord(s, "else", 4, TokenType::ELSE);
+        case 'm':
+          return MatchReservedWord(s, "main", 4, TokenType::MAIN);
+        case 'r':
+          return MatchReservedWord(s, "read", 4, TokenType::READ);
+        case 't':
+          return MatchReservedWord(s, "then", 4, TokenType::THEN);
+        case 'v':
+          return MatchReservedWord(s, "void", 4, TokenType::VOID);
+      }
+      break;
+    case 5:
+      switch (s[0]) {
+        case 'c':
+          return MatchReservedWord(s, "class", 5, TokenType::CLASS);
+        case 'f':
+          return MatchReservedWord(s, "float", 5, TokenType::FLOAT);
+        case 'l':
+          return MatchReservedWord(s, "local", 5, TokenType::LOCAL);
+        case 'w':
+          return s[1] == 'h'
+                     ? MatchReservedWord(s, "while", 5, TokenType::WHILE)
+                     : MatchReservedWord(s, "write", 5, TokenType::WRITE);
+      }
+      break;
+    case 6:
+      switch (s[0]) {
+        case 'p':
+          return MatchReservedWord(s, "public", 6, TokenType::PUBLIC);
+        case 'r':
+          return MatchReservedWord(s, "return", 6, TokenType::RETURN);
+      }
+      break;
+    case 7:
+      switch (s[0]) {
+        case 'i':
+          return MatchReservedWord(s, "integer", 7, TokenType::INTEGER);
+        case 'p':
+          return MatchReservedWord(s, "private", 7, TokenType::PRIVATE);
+      }
+      break;
+    case 8:
+      return MatchReservedWord(s, "inherits", 8, TokenType::INHERITS);
+  }
+  return TokenType::ID;
+}
+
+static_assert(ClassifyWord("while", 5) == TokenType::WHILE &&
+                  ClassifyWord("write", 5) == TokenType::WRITE &&
+                  ClassifyWord("inherits", 8) == TokenType::INHERITS &&
+                  ClassifyWord("integers", 8) == TokenType::ID &&
+                  ClassifyWord("dO", 2) == TokenType::ID,
+              "reserved word classification is broken");
 
 Lexer::Lexer(std::istream& is)
-    : is_(is), line_(1), tokens_ofs_(OUT_TOKENS_FILEPATH) {}
+    : strings_(std::make_shared<StringTable>()),
+      is_(&is),
+      begin_(nullptr),
+      cur_(nullptr),
+      end_(nullptr),
+      line_(1),
+      mode_(LexerMode::HAND_WRITTEN),
+      token_log_(nullptr),
+      tokenize_start_(0),
+      tokenize_line_(1) {}
+
+Lexer::Lexer(const SourceBuffer& src, LexerMode mode)
+    : strings_(std::make_shared<StringTable>()),
+      is_(nullptr),
+      begin_(src.Data()),
+      cur_(src.Data()),
+      end_(src.Data() + src.Size()),
+      line_(1),
+      mode_(mode),
+      token_log_(nullptr),
+      tokenize_start_(0),
+      tokenize_line_(1) {}
+
+TokenArray Lexer::TokenizeAll() {
+  if (is_) {
+    // Offsets need the text in memory, so the rest of the stream is read in
+    // and lexed as a buffer from here on.
+    std::ostringstream oss;
+    oss << is_->rdbuf();
+    owned_src_.reset(new SourceBuffer(SourceBuffer::FromString(oss.str())));
+    is_ = nullptr;
+    begin_ = cur_ = owned_src_->Data();
+    end_ = begin_ + owned_src_->Size();
+  }
+  tokenize_start_ = cur_ - begin_;
+  tokenize_line_ = line_;
+  TokenArray tokens;
+  tokens.strings = strings_;
+  // Roughly one token per four chars of source.
+  tokens.Reserve((end_ - cur_) / 4 + 1);
+  while (true) {
+    std::size_t offset;
+    Token tk = NextArrayToken(offset);
+    tokens.PushBack(tk.Type(), offset, cur_ - begin_ - offset, tk.Line(),
+                    &tk.Lexeme());
+    if (tk.Type() == TokenType::EOS) {
+      return tokens;
+    }
+  }
+}
+
+void Lexer::Relex(TokenArray& tokens, std::size_t offset, std::size_t removed,
+                  const std::string& inserted) {
+  std::size_t size = end_ - begin_;
+  if (tokens.Size() == 0 || offset < tokenize_start_ || offset > size ||
+      removed > size - offset) {
+    throw std::out_of_range("Edit is outside of the lexed source");
+  }
+  std::size_t edit_end = offset + removed;
+  long delta = static_cast<long>(inserted.size()) - static_cast<long>(removed);
+
+  std::string text;
+  text.reserve(size + delta);
+  text.append(begin_, offset).append(inserted).append(begin_ + edit_end, end_);
+  owned_src_.reset(new SourceBuffer(SourceBuffer::FromString(std::move(text))));
+  begin_ = owned_src_->Data();
+  end_ = begin_ + owned_src_->Size();
+
+  // A token is only known to be unchanged if it ends before the edit and the
+  // char after it, which ended the scan, is not edited either. Lexing
+  // restarts right after the last such token.
+  std::size_t keep = 0;
+  for (std::size_t hi = tokens.Size(); keep < hi;) {
+    std::size_t mid = keep + (hi - keep) / 2;
+    if (tokens.offsets[mid] + tokens.lengths[mid] + 1 <= offset) {
+      keep = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  // Line numbers cannot be derived from the text alone, as a newline right
+  // after a '*' in a block comment is not counted, so the kept token's line
+  // is used instead; only comments span several lines.
+  if (keep == 0) {
+    cur_ = begin_ + tokenize_start_;
+    line_ = tokenize_line_;
+  } else {
+    cur_ = begin_ + tokens.offsets[keep - 1] + tokens.lengths[keep - 1];
+    line_ = tokens.lines[keep - 1];
+  }
+
+  // Lex until a token starts where an old token after the edit started. From
+  // there on the text is unchanged, so the old tokens are too, only moved.
+  TokenArray relexed;
+  std::size_t old = keep;
+  int line_delta = 0;
+  while (true) {
+    std::size_t tk_offset;
+    Token tk = NextArrayToken(tk_offset);
+    while (old < tokens.Size() &&
+           (tokens.offsets[old] < edit_end ||
+            tokens.offsets[old] + delta < static_cast<long>(tk_offset))) {
+      ++old;
+    }
+    if (old < tokens.Size() &&
+        tokens.offsets[old] + delta == static_cast<long>(tk_offset)) {
+      line_delta = tk.Line() - tokens.lines[old];
+      break;
+    }
+    relexed.PushBack(tk.Type(), tk_offset, cur_ - begin_ - tk_offset,
+                     tk.Line(), &tk.Lexeme());
+    if (tk.Type() == TokenType::EOS) {
+      old = tokens.Size();
+      break;
+    }
+  }
+  tokens.Splice(keep, old, relexed);
+  tokens.Shift(keep + relexed.Size(), delta, line_delta);
+  // Leave the lexer at the end, as after TokenizeAll().
+  cur_ = end_;
+  line_ = tokens.lines.back();
+}
+
+// Returns the next non-comment token of the buffer, and sets offset to
+// where it starts.
+Token Lexer::NextArrayToken(std::size_t& offset) {
+  while (true) {
+    SkipBufferWs();
+    offset = cur_ - begin_;
+    Token tk = NextToken();
+    if (!tk.IsComment()) {
+      return tk;
+    }
+  }
+}
 
 bool Lexer::HasNext() {
+  if (!is_) {
+    SkipBufferWs();
+    return cur_ != end_;
+  }
   SkipWs();
-  return is_.tellg() != -1;
+  return is_->tellg() != -1;
 }
 
+void Lexer::SetTokenLog(TraceSink* sink) { token_log_ = sink; }
+
+std::shared_ptr<StringTable> Lexer::Strings() const { return strings_; }
+
 Token Lexer::NextToken() {
+  Token tk;
+  if (is_) {
+    tk = NextStreamToken();
+  } else if (mode_ == LexerMode::DFA) {
+    tk = NextDfaToken();
+  } else {
+    tk = NextBufferToken();
+  }
+  LogToken(tk);
+  return tk;
+}
+
+Token Lexer::NextStreamToken() {
   SkipWs();
-  is_.get(c_);
+  is_->get(c_);
   Token tk;
   std::string s(1, c_);
-  if (is_.tellg() == -1) {  // Reached end of source, return '$'.
-    tk = Token(TokenType::EOS, "$", line_);
+  if (is_->tellg() == -1) {  // Reached end of source, return '$'.
+    tk = MakeToken(TokenType::EOS, "$", line_);
   } else if (isalpha(c_) || c_ == '_') {  // Find id token.
     tk = HandleId(s);
   } else if (isdigit(c_)) {  // Handle intnum or floatnum tokens.
     tk = HandleNum(s);
   } else if (c_ == '=') {  // Handle '=' or '==' tokens.
-    c_ = is_.get();
+    c_ = is_->get();
     if (c_ == '=') {
-      tk = Token(TokenType::EQ, s + c_, line_);
+      tk = MakeToken(TokenType::EQ, s + c_, line_);
     } else {
-      is_.unget();
-      tk = Token(TokenType::ASSGN, s, line_);
+      is_->unget();
+      tk = MakeToken(TokenType::ASSGN, s, line_);
     }
   } else if (c_ == '<') {  // Handle '<', '<=' or '<>' tokens.
-    c_ = is_.get();
+    c_ = is_->get();
     if (c_ == '=') {
-      tk = Token(TokenType::LEQ, s + c_, line_);
+      tk = MakeToken(TokenType::LEQ, s + c_, line_);
     } else if (c_ == '>') {
-      tk = Token(TokenType::NEQ, s + c_, line_);
+      tk = MakeToken(TokenType::NEQ, s + c_, line_);
     } else {
-      is_.unget();
-      tk = Token(TokenType::LT, s, line_);
+      is_->unget();
+      tk = MakeToken(TokenType::LT, s, line_);
     }
   } else if (c_ == '>') {  // Handle '>' and '>=' tokens.
-    c_ = is_.get();
+    c_ = is_->get();
     if (c_ == '=') {
-      tk = Token(TokenType::GEQ, s + c_, line_);
+      tk = MakeToken(TokenType::GEQ, s + c_, line_);
     } else {
-      is_.unget();
-      tk = Token(TokenType::GT, s, line_);
+      is_->unget();
+      tk = MakeToken(TokenType::GT, s, line_);
     }
   } else if (c_ == '+') {  // Find '+' token.
-    tk = Token(TokenType::PLUS, s, line_);
+    tk = MakeToken(TokenType::PLUS, s, line_);
   } else if (c_ == '-') {  // Find '-' token.
-    tk = Token(TokenType::MINUS, s, line_);
+    tk = MakeToken(TokenType::MINUS, s, line_);
   } else if (c_ == '*') {  // 'Find *' token.
-    tk = Token(TokenType::MULT, s, line_);
+    tk = MakeToken(TokenType::MULT, s, line_);
   } else if (c_ == '/') {  // Handle '/', // comments and /* comments */
     tk = HandleDivOrComment(s);
   } else if (c_ == '(') {  // Find '(' token.
-    tk = Token(TokenType::OPEN_PAR, s, line_);
+    tk = MakeToken(TokenType::OPEN_PAR, s, line_);
   } else if (c_ == ')') {  // Find ')' token.
-    tk = Token(TokenType::CLOSE_PAR, s, line_);
+    tk = MakeToken(TokenType::CLOSE_PAR, s, line_);
   } else if (c_ == '{') {  // Find '{' token.
-    tk = Token(TokenType::OPEN_CBR, s, line_);
+    tk = MakeToken(TokenType::OPEN_CBR, s, line_);
   } else if (c_ == '}') {  // Find '}' token.
-    tk = Token(TokenType::CLOSE_CBR, s, line_);
+    tk = MakeToken(TokenType::CLOSE_CBR, s, line_);
   } else if (c_ == '[') {  // Find '[' token.
-    tk = Token(TokenType::OPEN_SQBR, s, line_);
+    tk = MakeToken(TokenType::OPEN_SQBR, s, line_);
   } else if (c_ == ']') {  // Find ']' token.
-    tk = Token(TokenType::CLOSE_SQBR, s, line_);
+    tk = MakeToken(TokenType::CLOSE_SQBR, s, line_);
   } else if (c_ == ';') {  // Find ';' token.
-    tk = Token(TokenType::SEMICOLON, s, line_);
+    tk = MakeToken(TokenType::SEMICOLON, s, line_);
   } else if (c_ == ',') {  // Find ',' token.
-    tk = Token(TokenType::COMMA, s, line_);
+    tk = MakeToken(TokenType::COMMA, s, line_);
   } else if (c_ == '.') {  // Find '.' token.
-    tk = Token(TokenType::DOT, s, line_);
+    tk = MakeToken(TokenType::DOT, s, line_);
   } else if (c_ == ':') {  // Handle ':' and '::' tokens.
-    c_ = is_.get();
+    c_ = is_->get();
     if (c_ == ':') {
-      tk = Token(TokenType::SCOPE_RES, s + c_, line_);
+      tk = MakeToken(TokenType::SCOPE_RES, s + c_, line_);
     } else {
-      is_.unget();
-      tk = Token(TokenType::COLON, s, line_);
+      is_->unget();
+      tk = MakeToken(TokenType::COLON, s, line_);
     }
   } else {
-    tk = Token(TokenType::INVALID_CHAR, s, line_);  // Unexpected token.
+    tk = MakeToken(TokenType::INVALID_CHAR, s, line_);  // Unexpected token.
   }
-  LogToken(tk);
   return tk;
 }
 
+// The buffer is NUL-terminated, so the Scan functions below only need an
+// explicit bounds check in loops that would also accept a '\0'.
+Token Lexer::NextBufferToken() {
+  SkipBufferWs();
+  if (cur_ == end_) {  // Reached end of source, return '$'.
+    return MakeToken(TokenType::EOS, "$", line_);
+  }
+  const char* start = cur_;
+  c_ = *cur_++;
+  if (isalpha(static_cast<unsigned char>(c_)) || c_ == '_') {
+    return ScanId(start);
+  } else if (isdigit(static_cast<unsigned char>(c_))) {
+    return ScanNum(start);
+  }
+  switch (c_) {
+    case '=':  // Handle '=' or '==' tokens.
+      if (*cur_ == '=') {
+        ++cur_;
+        return MakeToken(TokenType::EQ, start);
+      }
+      return MakeToken(TokenType::ASSGN, start);
+    case '<':  // Handle '<', '<=' or '<>' tokens.
+      if (*cur_ == '=') {
+        ++cur_;
+        return MakeToken(TokenType::LEQ, start);
+      } else if (*cur_ == '>') {
+        ++cur_;
+        return MakeToken(TokenType::NEQ, start);
+      }
+      return MakeToken(TokenType::LT, start);
+    case '>':  // Handle '>' and '>=' tokens.
+      if (*cur_ == '=') {
+        ++cur_;
+        return MakeToken(TokenType::GEQ, start);
+      }
+      return MakeToken(TokenType::GT, start);
+    case ':':  // Handle ':' and '::' tokens.
+      if (*cur_ == ':') {
+        ++cur_;
+        return MakeToken(TokenType::SCOPE_RES, start);
+      }
+      return MakeToken(TokenType::COLON, start);
+    case '/':  // Handle '/', // comments and /* comments */
+      return ScanDivOrComment(start);
+    case '+':
+      return MakeToken(TokenType::PLUS, start);
+    case '-':
+      return MakeToken(TokenType::MINUS, start);
+    case '*':
+      return MakeToken(TokenType::MULT, start);
+    case '(':
+      return MakeToken(TokenType::OPEN_PAR, start);
+    case ')':
+      return MakeToken(TokenType::CLOSE_PAR, start);
+    case '{':
+      return MakeToken(TokenType::OPEN_CBR, start);
+    case '}':
+      return MakeToken(TokenType::CLOSE_CBR, start);
+    case '[':
+      return MakeToken(TokenType::OPEN_SQBR, start);
+    case ']':
+      return MakeToken(TokenType::CLOSE_SQBR, start);
+    case ';':
+      return MakeToken(TokenType::SEMICOLON, start);
+    case ',':
+      return MakeToken(TokenType::COMMA, start);
+    case '.':
+      return MakeToken(TokenType::DOT, start);
+    default:
+      return MakeToken(TokenType::INVALID_CHAR, start);  // Unexpected token.
+  }
+}
+
 Token Lexer::HandleId(std::string& s) {
   Token tk;
   if (isalpha(c_)) {
-    c_ = is_.get();
-    while (is_.tellg() != -1 && (isalnum(c_) || c_ == '_')) {
+    c_ = is_->get();
+    while (is_->tellg() != -1 && (isalnum(c_) || c_ == '_')) {
       s += c_;
-      c_ = is_.get();
+      c_ = is_->get();
     }
-    is_.unget();
-    tk = Token(GetIdOrReservedWordType(s), s, line_);
+    is_->unget();
+    tk = MakeToken(GetIdOrReservedWordType(s), s, line_);
   } else if (c_ == '_') {
-    c_ = is_.get();
-    while (is_.tellg() != -1 && !isspace(c_)) {
+    c_ = is_->get();
+    while (is_->tellg() != -1 && !isspace(c_)) {
       s += c_;
-      c_ = is_.get();
+      c_ = is_->get();
     }
-    is_.unget();
-    tk = Token(TokenType::INVALID_ID, s, line_);
+    is_->unget();
+    tk = MakeToken(TokenType::INVALID_ID, s, line_);
   }
   return tk;
 }
@@ -118,44 +443,44 @@ Token Lexer::HandleId(std::string& s) {
 Token Lexer::HandleNum(std::string& s) {
   Token tk;
   if (c_ == '0') {
-    c_ = is_.get();
-    if (is_.tellg() != -1 && !IsNumTerminatingChar(c_) && c_ != '.') {
+    c_ = is_->get();
+    if (is_->tellg() != -1 && !IsNumTerminatingChar(c_) && c_ != '.') {
       s += c_;
-      c_ = is_.get();
-      while (is_.tellg() != -1 && !IsNumTerminatingChar(c_)) {
+      c_ = is_->get();
+      while (is_->tellg() != -1 && !IsNumTerminatingChar(c_)) {
         s += c_;
-        c_ = is_.get();
+        c_ = is_->get();
       }
-      is_.unget();
-      tk = Token(TokenType::INVALID_NUM, s, line_);
+      is_->unget();
+      tk = MakeToken(TokenType::INVALID_NUM, s, line_);
     } else {
       if (c_ == '.') {
         tk = HandleFloatNum(s);
       } else {
-        is_.unget();
-        tk = Token(TokenType::INTNUM, s, line_);
+        is_->unget();
+        tk = MakeToken(TokenType::INTNUM, s, line_);
       }
     }
   } else {
-    c_ = is_.get();
-    while (is_.tellg() != 1 && isdigit(c_)) {
+    c_ = is_->get();
+    while (is_->tellg() != -1 && isdigit(c_)) {
       s += c_;
-      c_ = is_.get();
+      c_ = is_->get();
     }
     if (c_ == '.') {
       tk = HandleFloatNum(s);
-    } else if (is_.tellg() != -1 && !IsNumTerminatingChar(c_)) {
+    } else if (is_->tellg() != -1 && !IsNumTerminatingChar(c_)) {
       s += c_;
-      c_ = is_.get();
-      while (is_.tellg() != -1 && !IsNumTerminatingChar(c_)) {
+      c_ = is_->get();
+      while (is_->tellg() != -1 && !IsNumTerminatingChar(c_)) {
         s += c_;
-        c_ = is_.get();
+        c_ = is_->get();
       }
-      is_.unget();
-      tk = Token(TokenType::INVALID_NUM, s, line_);
+      is_->unget();
+      tk = MakeToken(TokenType::INVALID_NUM, s, line_);
     } else {
-      is_.unget();
-      tk = Token(TokenType::INTNUM, s, line_);
+      is_->unget();
+      tk = MakeToken(TokenType::INTNUM, s, line_);
     }
   }
   return tk;
@@ -164,95 +489,95 @@ Token Lexer::HandleNum(std::string& s) {
 Token Lexer::HandleFloatNum(std::string& s) {
   Token tk;
   s += c_;
-  c_ = is_.get();
+  c_ = is_->get();
   if (isdigit(c_)) {
     s += c_;
-    c_ = is_.get();
+    c_ = is_->get();
     bool ends_with_zero = false;
     while (isdigit(c_)) {
       ends_with_zero = (c_ == '0') ? true : false;
       s += c_;
-      c_ = is_.get();
+      c_ = is_->get();
       while (c_ == '0') {
         ends_with_zero = true;
         s += c_;
-        c_ = is_.get();
+        c_ = is_->get();
       }
     }
     if (!ends_with_zero) {
       if (c_ == 'e') {
         s += c_;
-        c_ = is_.get();
+        c_ = is_->get();
         if (c_ == '+' || c_ == '-') {
           s += c_;
-          c_ = is_.get();
+          c_ = is_->get();
         }
         if (isdigit(c_)) {
           s += c_;
           if (c_ == '0') {
-            c_ = is_.get();
-            if (is_.tellg() != -1 && !IsNumTerminatingChar(c_)) {
+            c_ = is_->get();
+            if (is_->tellg() != -1 && !IsNumTerminatingChar(c_)) {
               s += c_;
-              c_ = is_.get();
-              while (is_.tellg() != -1 && !IsNumTerminatingChar(c_)) {
+              c_ = is_->get();
+              while (is_->tellg() != -1 && !IsNumTerminatingChar(c_)) {
                 s += c_;
-                c_ = is_.get();
+                c_ = is_->get();
               }
-              is_.unget();
-              tk = Token(TokenType::INVALID_NUM, s, line_);
+              is_->unget();
+              tk = MakeToken(TokenType::INVALID_NUM, s, line_);
             } else {
-              is_.unget();
-              tk = Token(TokenType::FLOATNUM, s, line_);
+              is_->unget();
+              tk = MakeToken(TokenType::FLOATNUM, s, line_);
             }
           } else if (isdigit(c_)) {
-            c_ = is_.get();
+            c_ = is_->get();
             while (isdigit(c_)) {
               s += c_;
-              c_ = is_.get();
+              c_ = is_->get();
             }
-            is_.unget();
-            tk = Token(TokenType::FLOATNUM, s, line_);
+            is_->unget();
+            tk = MakeToken(TokenType::FLOATNUM, s, line_);
           } else {
-            is_.unget();
-            tk = Token(TokenType::INVALID_NUM, s, line_);
+            is_->unget();
+            tk = MakeToken(TokenType::INVALID_NUM, s, line_);
           }
         } else {
-          is_.unget();
-          tk = Token(TokenType::INVALID_NUM, s, line_);
+          is_->unget();
+          tk = MakeToken(TokenType::INVALID_NUM, s, line_);
         }
 
       } else {
-        is_.unget();
-        tk = Token(TokenType::FLOATNUM, s, line_);
+        is_->unget();
+        tk = MakeToken(TokenType::FLOATNUM, s, line_);
       }
     } else {
-      is_.unget();
-      tk = Token(TokenType::INVALID_NUM, s, line_);
+      is_->unget();
+      tk = MakeToken(TokenType::INVALID_NUM, s, line_);
     }
   } else {
-    is_.unget();
-    tk = Token(TokenType::INVALID_NUM, s, line_);
+    is_->unget();
+    tk = MakeToken(TokenType::INVALID_NUM, s, line_);
   }
   return tk;
 }
 
 Token Lexer::HandleDivOrComment(std::string& s) {
   Token tk;
-  c_ = is_.get();
+  c_ = is_->get();
   if (c_ == '/') {
     s += c_;
-    c_ = is_.get();
-    while (is_.tellg() != -1 && c_ != '\n') {
+    c_ = is_->get();
+    while (is_->tellg() != -1 && c_ != '\n') {
       s += c_;
-      c_ = is_.get();
+      c_ = is_->get();
     }
-    is_.unget();
-    tk = Token(TokenType::INLINE_CMT, s, line_);
+    is_->unget();
+    tk = MakeToken(TokenType::INLINE_CMT, s, line_);
   } else if (c_ == '*') {
     s += c_;
     uint block_cmt_line = line_;
-    while (is_.tellg() != -1) {
-      while (is_.tellg() != -1 && is_.get(c_) && c_ != '*') {
+    while (is_->tellg() != -1) {
+      while (is_->tellg() != -1 && is_->get(c_) && c_ != '*') {
         if (c_ == '\n') {
           line_++;
           s += "\\n";
@@ -260,25 +585,25 @@ Token Lexer::HandleDivOrComment(std::string& s) {
           s += c_;
         }
       }
-      if (is_.tellg() == -1) {
-        tk = Token(TokenType::UNTERMINATED_CMT, s, block_cmt_line);
+      if (is_->tellg() == -1) {
+        tk = MakeToken(TokenType::UNTERMINATED_CMT, s, block_cmt_line);
         break;
       } else {
         s += c_;
       }
-      c_ = is_.get();
-      if (is_.tellg() == -1) {
-        tk = Token(TokenType::UNTERMINATED_CMT, s, block_cmt_line);
+      c_ = is_->get();
+      if (is_->tellg() == -1) {
+        tk = MakeToken(TokenType::UNTERMINATED_CMT, s, block_cmt_line);
         break;
       } else if (c_ == '/') {
         s += c_;
-        tk = Token(TokenType::BLOCK_CMT, s, block_cmt_line);
+        tk = MakeToken(TokenType::BLOCK_CMT, s, block_cmt_line);
         break;
       }
     }
   } else {
-    is_.unget();
-    tk = Token(TokenType::DIV, s, line_);
+    is_->unget();
+    tk = MakeToken(TokenType::DIV, s, line_);
   }
   return tk;
 }
@@ -286,62 +611,16 @@ Token Lexer::HandleDivOrComment(std::string& s) {
 // Return the correct TokenType given a string that is either
 // an id or a reserved word.
 TokenType Lexer::GetIdOrReservedWordType(const std::string& str) {
-  if (str == "if") {
-    return TokenType::IF;
-  } else if (str == "then") {
-    return TokenType::THEN;
-  } else if (str == "else") {
-    return TokenType::ELSE;
-  } else if (str == "while") {
-    return TokenType::WHILE;
-  } else if (str == "class") {
-    return TokenType::CLASS;
-  } else if (str == "integer") {
-    return TokenType::INTEGER;
-  } else if (str == "float") {
-    return TokenType::FLOAT;
-  } else if (str == "do") {
-    return TokenType::DO;
-  } else if (str == "end") {
-    return TokenType::END;
-  } else if (str == "public") {
-    return TokenType::PUBLIC;
-  } else if (str == "private") {
-    return TokenType::PRIVATE;
-  } else if (str == "or") {
-    return TokenType::OR;
-  } else if (str == "and") {
-    return TokenType::AND;
-  } else if (str == "not") {
-    return TokenType::NOT;
-  } else if (str == "read") {
-    return TokenType::READ;
-  } else if (str == "write") {
-    return TokenType::WRITE;
-  } else if (str == "return") {
-    return TokenType::RETURN;
-  } else if (str == "main") {
-    return TokenType::MAIN;
-  } else if (str == "inherits") {
-    return TokenType::INHERITS;
-  } else if (str == "local") {
-    return TokenType::LOCAL;
-  } else if (str == "void") {
-    return TokenType::VOID;
-  } else {
-    return TokenType::ID;
-  }
+  return ClassifyWord(str.data(), str.size());
+}
+
+TokenType Lexer::GetIdOrReservedWordType(const char* s, std::size_t len) {
+  return ClassifyWord(s, len);
 }
 
 // Returns true if the given string is a reserved word.
 bool Lexer::IsReserved(const std::string& word) {
-  return word == "if" || word == "then" || word == "else" || word == "while" ||
-         word == "class" || word == "integer" || word == "float" ||
-         word == "do" || word == "end" || word == "public" ||
-         word == "private" || word == "or" || word == "and" || word == "not" ||
-         word == "read" || word == "write" || word == "return" ||
-         word == "main" || word == "inherits" || word == "local" ||
-         word == "void";
+  return ClassifyWord(word.data(), word.size()) != TokenType::ID;
 }
 
 // Returns true if the given char can terminate a num token.
@@ -353,9 +632,9 @@ bool Lexer::IsNumTerminatingChar(const char& c) {
 
 // Sets the stream position to before the next non-whitespace character.
 void Lexer::SkipWs() {
-  while (is_.get(c_)) {
+  while (is_->get(c_)) {
     if (!isspace(c_)) {
-      is_.unget();
+      is_->unget();
       break;
     } else if (c_ == '\n') {
       line_++;
@@ -363,8 +642,147 @@ void Lexer::SkipWs() {
   }
 }
 
+// Returns a token whose lexeme spans from start to the current position.
+Token Lexer::MakeToken(TokenType type, const char* start) {
+  return Token(type, strings_->Intern(start, cur_ - start), line_);
+}
+
+Token Lexer::MakeToken(TokenType type, const std::string& lexeme, int line) {
+  return Token(type, strings_->Intern(lexeme), line);
+}
+
+Token Lexer::ScanId(const char* start) {
+  if (*start == '_') {
+    while (cur_ != end_ && !isspace(static_cast<unsigned char>(*cur_))) {
+      ++cur_;
+    }
+    return MakeToken(TokenType::INVALID_ID, start);
+  }
+  while (isalnum(static_cast<unsigned char>(*cur_)) || *cur_ == '_') {
+    ++cur_;
+  }
+  return MakeToken(ClassifyWord(start, cur_ - start), start);
+}
+
+Token Lexer::ScanNum(const char* start) {
+  if (*start == '0') {
+    if (cur_ != end_ && !IsNumTerminatingChar(*cur_) && *cur_ != '.') {
+      return ScanInvalidNum(start);
+    }
+  } else {
+    while (isdigit(static_cast<unsigned char>(*cur_))) {
+      ++cur_;
+    }
+  }
+  if (*cur_ == '.') {
+    return ScanFloatNum(start);
+  } else if (cur_ != end_ && !IsNumTerminatingChar(*cur_)) {
+    return ScanInvalidNum(start);
+  }
+  return MakeToken(TokenType::INTNUM, start);
+}
+
+// Scans the fraction and optional exponent, starting at the '.'.
+Token Lexer::ScanFloatNum(const char* start) {
+  ++cur_;
+  if (!isdigit(static_cast<unsigned char>(*cur_))) {
+    return MakeToken(TokenType::INVALID_NUM, start);
+  }
+  ++cur_;
+  // Trailing zeros are invalid, except for a single zero right after the '.'.
+  bool ends_with_zero = false;
+  while (isdigit(static_cast<unsigned char>(*cur_))) {
+    ends_with_zero = *cur_++ == '0';
+  }
+  if (ends_with_zero) {
+    return MakeToken(TokenType::INVALID_NUM, start);
+  } else if (*cur_ != 'e') {
+    return MakeToken(TokenType::FLOATNUM, start);
+  }
+  ++cur_;
+  if (*cur_ == '+' || *cur_ == '-') {
+    ++cur_;
+  }
+  if (!isdigit(static_cast<unsigned char>(*cur_))) {
+    return MakeToken(TokenType::INVALID_NUM, start);
+  } else if (*cur_++ == '0') {
+    if (cur_ != end_ && !IsNumTerminatingChar(*cur_)) {
+      return ScanInvalidNum(start);
+    }
+    return MakeToken(TokenType::FLOATNUM, start);
+  }
+  while (isdigit(static_cast<unsigned char>(*cur_))) {
+    ++cur_;
+  }
+  return MakeToken(TokenType::FLOATNUM, start);
+}
+
+// Consumes the rest of a malformed number up to the next terminating char.
+Token Lexer::ScanInvalidNum(const char* start) {
+  while (cur_ != end_ && !IsNumTerminatingChar(*cur_)) {
+    ++cur_;
+  }
+  return MakeToken(TokenType::INVALID_NUM, start);
+}
+
+Token Lexer::ScanDivOrComment(const char* start) {
+  if (*cur_ == '/') {
+    while (cur_ != end_ && *cur_ != '\n') {
+      ++cur_;
+    }
+    return MakeToken(TokenType::INLINE_CMT, start);
+  } else if (*cur_ != '*') {
+    return MakeToken(TokenType::DIV, start);
+  }
+  ++cur_;
+  return ScanBlockComment(start);
+}
+
+// Scans the rest of a block comment, starting right after the "/*".
+// Newlines are escaped in the lexeme, and the char following a '*' that
+// does not close the comment is dropped, as in HandleDivOrComment.
+Token Lexer::ScanBlockComment(const char* start) {
+  std::string s(start, cur_ - start);
+  int block_cmt_line = line_;
+  while (true) {
+    int lines = 0;
+    const char* star = scan::FindChar(cur_, end_, '*', lines);
+    line_ += lines;
+    for (; lines > 0; --lines) {
+      const char* nl =
+          static_cast<const char*>(memchr(cur_, '\n', star - cur_));
+      s.append(cur_, nl);
+      s += "\\n";
+      cur_ = nl + 1;
+    }
+    s.append(cur_, star);
+    cur_ = star;
+    if (cur_ == end_) {
+      return MakeToken(TokenType::UNTERMINATED_CMT, s, block_cmt_line);
+    }
+    s += *cur_++;
+    if (cur_ == end_) {
+      return MakeToken(TokenType::UNTERMINATED_CMT, s, block_cmt_line);
+    } else if (*cur_++ == '/') {
+      s += '/';
+      return MakeToken(TokenType::BLOCK_CMT, s, block_cmt_line);
+    }
+  }
+}
+
+// Moves the buffer position to the next non-whitespace character.
+void Lexer::SkipBufferWs() {
+  // Tokens are often directly adjacent, e.g. "f(x);", so check the first
+  // char before paying for a vector scan.
+  if (isspace(static_cast<unsigned char>(*cur_))) {
+    cur_ = scan::SkipWhitespace(cur_, end_, line_);
+  }
+}
+
 void Lexer::LogToken(const Token& tk) {
-  tokens_ofs_ << tk << std::endl;
+  if (token_log_) {
+    *token_log_ << tk << '\n';
+  }
   switch (tk.Type()) {
     case TokenType::INVALID_ID:
       Logger::Err("Invalid identifier '" + tk.Lexeme() + "'", tk.Line(),
@@ -0,0 +1,282 @@
+#include <cstdint>
+
+#include "lexer.h"
+
+namespace toy {
+
+namespace {
+
+// Chars that behave the same in every state share a class.
+enum CharClass : uint8_t {
+  CC_NUL,  // '\0', which is also the end of buffer sentinel
+  CC_OTHER,
+  CC_LETTER,  // Letters other than 'e'
+  CC_E,       // 'e', which starts the exponent of a float
+  CC_ZERO,
+  CC_DIGIT,  // '1' to '9'
+  CC_UNDERSCORE,
+  CC_SPACE,  // Whitespace other than '\n'
+  CC_NEWLINE,
+  CC_DOT,
+  CC_EQ,
+  CC_LT,
+  CC_GT,
+  CC_COLON,
+  CC_SLASH,
+  CC_STAR,
+  CC_PLUS,
+  CC_MINUS,
+  CC_OPEN_PAR,
+  CC_CLOSE_PAR,
+  CC_OPEN_CBR,
+  CC_CLOSE_CBR,
+  CC_OPEN_SQBR,
+  CC_CLOSE_SQBR,
+  CC_SEMICOLON,
+  CC_COMMA,
+  NUM_CHAR_CLASSES
+};
+
+enum State : uint8_t {
+  S_DEAD,  // No transition: the token ends before the current char
+  S_START,
+  S_ID,
+  S_INVALID_ID,
+  S_ZERO,       // "0"
+  S_INT,        // Nonzero integer
+  S_BAD_NUM,    // Malformed number, runs to the next terminating char
+  S_FRAC_DOT,   // "12."
+  S_FRAC,       // "12.5", or "12.0" with only the one zero
+  S_FRAC_ZERO,  // "12.50", a fraction with a trailing zero
+  S_EXP,        // "12.5e"
+  S_EXP_SIGN,   // "12.5e-"
+  S_EXP_ZERO,   // "12.5e0"
+  S_EXP_INT,    // "12.5e10"
+  S_ASSGN,
+  S_EQ,
+  S_LT,
+  S_LEQ,
+  S_NEQ,
+  S_GT,
+  S_GEQ,
+  S_COLON,
+  S_SCOPE_RES,
+  S_DIV,
+  S_INLINE_CMT,
+  S_BLOCK_CMT,  // "/*", the rest is left to Lexer::ScanBlockComment
+  S_PLUS,
+  S_MINUS,
+  S_MULT,
+  S_OPEN_PAR,
+  S_CLOSE_PAR,
+  S_OPEN_CBR,
+  S_CLOSE_CBR,
+  S_OPEN_SQBR,
+  S_CLOSE_SQBR,
+  S_SEMICOLON,
+  S_COMMA,
+  S_DOT,
+  S_INVALID_CHAR,
+  NUM_STATES
+};
+
+struct DfaTables {
+  uint8_t char_class[256];
+  uint8_t next[NUM_STATES][NUM_CHAR_CLASSES];
+  TokenType accept[NUM_STATES];  // Type of the token ending in each state
+};
+
+// Char classes that end a number, see Lexer::IsNumTerminatingChar.
+constexpr bool IsNumTerminatingClass(int cc) {
+  return cc == CC_SPACE || cc == CC_NEWLINE || cc == CC_EQ || cc == CC_PLUS ||
+         cc == CC_MINUS || cc == CC_SLASH || cc == CC_STAR || cc == CC_LT ||
+         cc == CC_GT || cc == CC_OPEN_PAR || cc == CC_CLOSE_PAR ||
+         cc == CC_SEMICOLON || cc == CC_CLOSE_SQBR || cc == CC_COMMA;
+}
+
+constexpr void SetClass(DfaTables& t, char c, CharClass cc) {
+  t.char_class[static_cast<unsigned char>(c)] = cc;
+}
+
+constexpr void SetToken(DfaTables& t, CharClass cc, State state,
+                        TokenType type) {
+  t.next[S_START][cc] = state;
+  t.accept[state] = type;
+}
+
+// Builds the tables for the same token rules as Lexer::NextStreamToken.
+constexpr DfaTables MakeDfaTables() {
+  DfaTables t{};
+  for (int c = 0; c < 256; ++c) {
+    t.char_class[c] = CC_OTHER;
+  }
+  for (char c = 'a'; c <= 'z'; ++c) {
+    SetClass(t, c, CC_LETTER);
+  }
+  for (char c = 'A'; c <= 'Z'; ++c) {
+    SetClass(t, c, CC_LETTER);
+  }
+  for (char c = '1'; c <= '9'; ++c) {
+    SetClass(t, c, CC_DIGIT);
+  }
+  SetClass(t, '\0', CC_NUL);
+  SetClass(t, 'e', CC_E);
+  SetClass(t, '0', CC_ZERO);
+  SetClass(t, '_', CC_UNDERSCORE);
+  SetClass(t, ' ', CC_SPACE);
+  SetClass(t, '\t', CC_SPACE);
+  SetClass(t, '\v', CC_SPACE);
+  SetClass(t, '\f', CC_SPACE);
+  SetClass(t, '\r', CC_SPACE);
+  SetClass(t, '\n', CC_NEWLINE);
+  SetClass(t, '.', CC_DOT);
+  SetClass(t, '=', CC_EQ);
+  SetClass(t, '<', CC_LT);
+  SetClass(t, '>', CC_GT);
+  SetClass(t, ':', CC_COLON);
+  SetClass(t, '/', CC_SLASH);
+  SetClass(t, '*', CC_STAR);
+  SetClass(t, '+', CC_PLUS);
+  SetClass(t, '-', CC_MINUS);
+  SetClass(t, '(', CC_OPEN_PAR);
+  SetClass(t, ')', CC_CLOSE_PAR);
+  SetClass(t, '{', CC_OPEN_CBR);
+  SetClass(t, '}', CC_CLOSE_CBR);
+  SetClass(t, '[', CC_OPEN_SQBR);
+  SetClass(t, ']', CC_CLOSE_SQBR);
+  SetClass(t, ';', CC_SEMICOLON);
+  SetClass(t, ',', CC_COMMA);
+
+  // Single char tokens, and the first char of longer ones.
+  SetToken(t, CC_OTHER, S_INVALID_CHAR, TokenType::INVALID_CHAR);
+  SetToken(t, CC_LETTER, S_ID, TokenType::ID);
+  SetToken(t, CC_E, S_ID, TokenType::ID);
+  SetToken(t, CC_UNDERSCORE, S_INVALID_ID, TokenType::INVALID_ID);
+  SetToken(t, CC_ZERO, S_ZERO, TokenType::INTNUM);
+  SetToken(t, CC_DIGIT, S_INT, TokenType::INTNUM);
+  SetToken(t, CC_DOT, S_DOT, TokenType::DOT);
+  SetToken(t, CC_EQ, S_ASSGN, TokenType::ASSGN);
+  SetToken(t, CC_LT, S_LT, TokenType::LT);
+  SetToken(t, CC_GT, S_GT, TokenType::GT);
+  SetToken(t, CC_COLON, S_COLON, TokenType::COLON);
+  SetToken(t, CC_SLASH, S_DIV, TokenType::DIV);
+  SetToken(t, CC_STAR, S_MULT, TokenType::MULT);
+  SetToken(t, CC_PLUS, S_PLUS, TokenType::PLUS);
+  SetToken(t, CC_MINUS, S_MINUS, TokenType::MINUS);
+  SetToken(t, CC_OPEN_PAR, S_OPEN_PAR, TokenType::OPEN_PAR);
+  SetToken(t, CC_CLOSE_PAR, S_CLOSE_PAR, TokenType::CLOSE_PAR);
+  SetToken(t, CC_OPEN_CBR, S_OPEN_CBR, TokenType::OPEN_CBR);
+  SetToken(t, CC_CLOSE_CBR, S_CLOSE_CBR, TokenType::CLOSE_CBR);
+  SetToken(t, CC_OPEN_SQBR, S_OPEN_SQBR, TokenType::OPEN_SQBR);
+  SetToken(t, CC_CLOSE_SQBR, S_CLOSE_SQBR, TokenType::CLOSE_SQBR);
+  SetToken(t, CC_SEMICOLON, S_SEMICOLON, TokenType::SEMICOLON);
+  SetToken(t, CC_COMMA, S_COMMA, TokenType::COMMA);
+
+  // Two char operators.
+  t.next[S_ASSGN][CC_EQ] = S_EQ;
+  t.accept[S_EQ] = TokenType::EQ;
+  t.next[S_LT][CC_EQ] = S_LEQ;
+  t.accept[S_LEQ] = TokenType::LEQ;
+  t.next[S_LT][CC_GT] = S_NEQ;
+  t.accept[S_NEQ] = TokenType::NEQ;
+  t.next[S_GT][CC_EQ] = S_GEQ;
+  t.accept[S_GEQ] = TokenType::GEQ;
+  t.next[S_COLON][CC_COLON] = S_SCOPE_RES;
+  t.accept[S_SCOPE_RES] = TokenType::SCOPE_RES;
+
+  // Comments.
+  t.next[S_DIV][CC_SLASH] = S_INLINE_CMT;
+  t.accept[S_INLINE_CMT] = TokenType::INLINE_CMT;
+  t.next[S_DIV][CC_STAR] = S_BLOCK_CMT;
+  t.accept[S_BLOCK_CMT] = TokenType::BLOCK_CMT;
+
+  // Numbers.
+  t.next[S_ZERO][CC_DOT] = S_FRAC_DOT;
+  t.next[S_INT][CC_DOT] = S_FRAC_DOT;
+  t.next[S_INT][CC_ZERO] = S_INT;
+  t.next[S_INT][CC_DIGIT] = S_INT;
+  t.accept[S_BAD_NUM] = TokenType::INVALID_NUM;
+  t.next[S_FRAC_DOT][CC_ZERO] = S_FRAC;
+  t.next[S_FRAC_DOT][CC_DIGIT] = S_FRAC;
+  t.accept[S_FRAC_DOT] = TokenType::INVALID_NUM;
+  t.next[S_FRAC][CC_ZERO] = S_FRAC_ZERO;
+  t.next[S_FRAC][CC_DIGIT] = S_FRAC;
+  t.next[S_FRAC][CC_E] = S_EXP;
+  t.accept[S_FRAC] = TokenType::FLOATNUM;
+  t.next[S_FRAC_ZERO][CC_ZERO] = S_FRAC_ZERO;
+  t.next[S_FRAC_ZERO][CC_DIGIT] = S_FRAC;
+  t.accept[S_FRAC_ZERO] = TokenType::INVALID_NUM;
+  t.next[S_EXP][CC_PLUS] = S_EXP_SIGN;
+  t.next[S_EXP][CC_MINUS] = S_EXP_SIGN;
+  t.next[S_EXP][CC_ZERO] = S_EXP_ZERO;
+  t.next[S_EXP][CC_DIGIT] = S_EXP_INT;
+  t.accept[S_EXP] = TokenType::INVALID_NUM;
+  t.next[S_EXP_SIGN][CC_ZERO] = S_EXP_ZERO;
+  t.next[S_EXP_SIGN][CC_DIGIT] = S_EXP_INT;
+  t.accept[S_EXP_SIGN] = TokenType::INVALID_NUM;
+  t.accept[S_EXP_ZERO] = TokenType::FLOATNUM;
+  t.next[S_EXP_INT][CC_ZERO] = S_EXP_INT;
+  t.next[S_EXP_INT][CC_DIGIT] = S_EXP_INT;
+  t.accept[S_EXP_INT] = TokenType::FLOATNUM;
+
+  for (int cc = CC_OTHER; cc < NUM_CHAR_CLASSES; ++cc) {
+    if (cc == CC_LETTER || cc == CC_E || cc == CC_ZERO || cc == CC_DIGIT ||
+        cc == CC_UNDERSCORE) {
+      t.next[S_ID][cc] = S_ID;
+    }
+    if (cc != CC_SPACE && cc != CC_NEWLINE) {
+      t.next[S_INVALID_ID][cc] = S_INVALID_ID;
+    }
+    if (cc != CC_NEWLINE) {
+      t.next[S_INLINE_CMT][cc] = S_INLINE_CMT;
+    }
+    if (!IsNumTerminatingClass(cc)) {
+      t.next[S_BAD_NUM][cc] = S_BAD_NUM;
+      t.next[S_EXP_ZERO][cc] = S_BAD_NUM;
+      if (cc != CC_DOT) {
+        t.next[S_ZERO][cc] = S_BAD_NUM;
+        if (cc != CC_ZERO && cc != CC_DIGIT) {
+          t.next[S_INT][cc] = S_BAD_NUM;
+        }
+      }
+    }
+  }
+  return t;
+}
+
+constexpr DfaTables DFA = MakeDfaTables();
+
+}  // namespace
+
+// Runs the DFA from the current position until it has no transition, and
+// returns the token for the state it stopped in. The '\0' class has no
+// transitions so the end of the buffer stops the loop without a bounds check.
+Token Lexer::NextDfaToken() {
+  SkipBufferWs();
+  if (cur_ == end_) {  // Reached end of source, return '$'.
+    return MakeToken(TokenType::EOS, "$", line_);
+  }
+  const char* start = cur_;
+  uint8_t state = S_START;
+  while (true) {
+    uint8_t cc = DFA.char_class[static_cast<unsigned char>(*cur_)];
+    uint8_t next = DFA.next[state][cc];
+    if (next == S_DEAD) {
+      // A '\0' before the end of the buffer is just an unexpected char.
+      if (cc != CC_NUL || cur_ == end_ ||
+          (next = DFA.next[state][CC_OTHER]) == S_DEAD) {
+        break;
+      }
+    }
+    state = next;
+    ++cur_;
+  }
+  if (state == S_ID) {
+    return MakeToken(GetIdOrReservedWordType(start, cur_ - start), start);
+  } else if (state == S_BLOCK_CMT) {
+    return ScanBlockComment(start);
+  }
+  return MakeToken(DFA.accept[state], start);
+}
+
+}  // namespace toy
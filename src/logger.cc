@@ -21,6 +21,10 @@ std::string ErrorType_to_string(ErrorType type) {
 
 std::string WarningType_to_string(WarningType type) {
   switch (type) {
+    case WarningType::LEXING:
+      return "LexingWarning: ";
+    case WarningType::SYNTAX:
+      return "SyntaxWarning: ";
     case WarningType::SEMANTIC:
       return "SemanticWarning: ";
     default:
@@ -29,6 +33,7 @@ std::string WarningType_to_string(WarningType type) {
 }
 
 std::shared_ptr<Logger> Logger::instance_ = 0;
+thread_local Logger* Logger::redirect_ = nullptr;
 
 std::shared_ptr<Logger> Logger::Instance() {
   if (!instance_) {
@@ -37,15 +42,25 @@ std::shared_ptr<Logger> Logger::Instance() {
   return instance_;
 }
 
+Logger& Logger::Target() {
+  return redirect_ != nullptr ? *redirect_ : *Instance();
+}
+
+Logger::Redirect::Redirect(Logger& log) : previous_(redirect_) {
+  redirect_ = &log;
+}
+
+Logger::Redirect::~Redirect() { redirect_ = previous_; }
+
 void Logger::Err(const std::string& msg, ErrorType type) {
   std::string log = ErrorType_to_string(type) + msg + "\n";
-  Instance()->errors_.emplace_back(-1, log);
+  Target().errors_.emplace_back(-1, log);
 }
 
 void Logger::Err(const std::string& msg, int line, ErrorType type) {
   std::string log = ErrorType_to_string(type) + msg + " (line " +
                     std::to_string(line) + ") \n";
-  Instance()->errors_.emplace_back(line, log);
+  Target().errors_.emplace_back(line, log);
 }
 
 bool Logger::HasErrors() { return Instance()->errors_.size() > 0; }
@@ -76,13 +91,13 @@ std::vector<std::string> Logger::GetErrors() {
 
 void Logger::Warn(const std::string& msg, WarningType type) {
   std::string log = WarningType_to_string(type) + msg + "\n";
-  Instance()->warnings_.emplace_back(-1, log);
+  Target().warnings_.emplace_back(-1, log);
 }
 
 void Logger::Warn(const std::string& msg, int line, WarningType type) {
   std::string log = WarningType_to_string(type) + msg + " (line " +
                     std::to_string(line) + ") \n";
-  Instance()->warnings_.emplace_back(line, log);
+  Target().warnings_.emplace_back(line, log);
 }
 
 bool Logger::HasWarnings() { return Instance()->warnings_.size() > 0; }
@@ -117,4 +132,12 @@ void Logger::Clear() {
   instance->warnings_.clear();
 }
 
+void Logger::Merge(const Logger& log) {
+  auto instance = Instance();
+  instance->errors_.insert(instance->errors_.end(), log.errors_.begin(),
+                           log.errors_.end());
+  instance->warnings_.insert(instance->warnings_.end(), log.warnings_.begin(),
+                             log.warnings_.end());
+}
+
 }  // namespace toy
\ No newline at end of file
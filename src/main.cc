@@ -5,11 +5,15 @@
 
 #include "code_gen_visitor.h"
 #include "cxxopts.h"
+#include "fused_semantic_visitor.h"
 #include "lexer.h"
 #include "logger.h"
 #include "mem_size_visitor.h"
+#include "parallel_semantic_pass.h"
 #include "parser.h"
+#include "source_buffer.h"
 #include "symbol_table_visitor.h"
+#include "trace_sink.h"
 #include "type_check_visitor.h"
 #include "util.h"
 
@@ -23,6 +27,15 @@ cxxopts::ParseResult ParseArgs(int argc, char* argv[]) {
     options.add_options()("f, file", "Source code file [required]",
                           cxxopts::value<std::string>())(
         "e, exe", "Execute the generated code after compilation.")(
+        "t, tokens", "Write the lexed tokens to ../out/outlextokens.")(
+        "d, derivation",
+        "Write the parser's derivation to ../out/outderivation.")(
+        "fused",
+        "Type check and calculate memory sizes in a single AST traversal.")(
+        "j, jobs",
+        "Type check and calculate memory sizes of the functions on this many "
+        "threads, 0 for one per core. Not with --fused.",
+        cxxopts::value<int>())(
         "h, help", "Display this information.");
     options.parse_positional({"file"});
     cxxopts::ParseResult result = options.parse(argc, argv);
@@ -30,6 +43,16 @@ cxxopts::ParseResult ParseArgs(int argc, char* argv[]) {
       std::cout << options.help() << std::endl;
       exit(0);
     }
+    if (result.count("jobs") && result["jobs"].as<int>() < 0) {
+      std::cout << "Error parsing options: --jobs cannot be negative"
+                << std::endl;
+      exit(1);
+    }
+    if (result.count("jobs") && result.count("fused")) {
+      std::cout << "Error parsing options: --jobs cannot be used with --fused"
+                << std::endl;
+      exit(1);
+    }
     return result;
   } catch (const cxxopts::OptionException& e) {
     std::cout << "Error parsing options: " << e.what() << std::endl;
@@ -42,18 +65,35 @@ int main(int argc, char* argv[]) {
 
   // Lexical analysis
   std::string filename = result["file"].as<std::string>();
-  std::ifstream file_stream(filename);
-  if (!file_stream.good()) {
+  std::unique_ptr<SourceBuffer> src;
+  try {
+    src.reset(new SourceBuffer(SourceBuffer::FromFile(filename)));
+  } catch (const std::runtime_error&) {
     std::cout << "No such file " << filename;
     return 0;
   }
-  Lexer lexer(file_stream);
+  Lexer lexer(*src, LexerMode::DFA);
+  std::unique_ptr<TraceSink> token_log;
+  if (result.count("tokens")) {
+    token_log.reset(new TraceSink("../out/outlextokens"));
+    lexer.SetTokenLog(token_log.get());
+  }
+
+  TokenArray tokens = lexer.TokenizeAll();
 
   // Syntax analysis
-  Grammar grammar;
-  ParserGenerator pgen(grammar);
-  Parser parser(lexer, pgen);
+  Parser parser(tokens);
+  std::unique_ptr<TraceSink> derivation_log;
+  if (result.count("derivation")) {
+    derivation_log.reset(new TraceSink("../out/outderivation"));
+    parser.SetDerivationLog(derivation_log.get());
+  }
   std::shared_ptr<ASTNode> ast = parser.Parse();
+  if (!ast) {
+    Logger::PrintWarnings();
+    Logger::PrintErrors();
+    return 0;
+  }
   ast->ToDotFile("../out/outast.gv");
   if (Logger::HasErrors()) {
     Logger::PrintErrors();
@@ -63,8 +103,18 @@ int main(int argc, char* argv[]) {
   // Semantic analysis
   SymbolTableVisitor symtab_visitor;
   ast->Accept(symtab_visitor);
-  TypeCheckVisitor typecheck_visitor;
-  ast->Accept(typecheck_visitor);
+  bool fused = result.count("fused") > 0;
+  bool parallel = result.count("jobs") > 0;
+  if (fused) {
+    FusedSemanticVisitor fused_visitor;
+    ast->Accept(fused_visitor);
+  } else if (parallel) {
+    ParallelSemanticPass parallel_pass(result["jobs"].as<int>());
+    parallel_pass.Run(*ast);
+  } else {
+    TypeCheckVisitor typecheck_visitor;
+    ast->Accept(typecheck_visitor);
+  }
   Logger::PrintWarnings();
   if (Logger::HasErrors()) {
     Logger::PrintErrors();
@@ -72,8 +122,10 @@ int main(int argc, char* argv[]) {
   }
 
   // Code generation
-  MemSizeVisitor memsize_visitor;
-  ast->Accept(memsize_visitor);
+  if (!fused && !parallel) {
+    MemSizeVisitor memsize_visitor;
+    ast->Accept(memsize_visitor);
+  }
   CodeGenVisitor codegen_visitor;
   ast->Accept(codegen_visitor);
 
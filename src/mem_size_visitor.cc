@@ -2,6 +2,7 @@
 
 #include <fstream>
 
+#include "logger.h"
 #include "symbol_table.h"
 
 namespace toy {
@@ -12,11 +13,52 @@ MemSizeVisitor::MemSizeVisitor()
 // tempvars are used to store intermediate results,
 // e.g. the result of an add operation
 std::string MemSizeVisitor::GetTempVarName() {
-  return "temp" + std::to_string(temp_var_counter++);
+  return TempVarName(temp_var_counter++);
 }
 
 std::string MemSizeVisitor::GetLitValName() {
-  return "lit" + std::to_string(lit_val_counter++);
+  return LitValName(lit_val_counter++);
+}
+
+std::string MemSizeVisitor::TempVarName(int n) {
+  return "temp" + std::to_string(n);
+}
+
+std::string MemSizeVisitor::LitValName(int n) {
+  return "lit" + std::to_string(n);
+}
+
+void MemSizeVisitor::SetCounters(int temp_var_counter, int lit_val_counter) {
+  this->temp_var_counter = temp_var_counter;
+  this->lit_val_counter = lit_val_counter;
+}
+
+void MemSizeVisitor::SetCounting(bool counting) { counting_ = counting; }
+
+int MemSizeVisitor::TempVarCounter() const { return temp_var_counter; }
+
+int MemSizeVisitor::LitValCounter() const { return lit_val_counter; }
+
+const std::vector<std::string>& MemSizeVisitor::SignedVals() const {
+  return signed_vals_;
+}
+
+void MemSizeVisitor::AddTempVar(ASTNode& node, int line) {
+  std::string name = GetTempVarName();
+  if (counting_) return;
+  auto entry = std::shared_ptr<LocalVarEntry>(
+      new LocalVarEntry(name, node.Type(), line, nullptr, {}));
+  node.symtab->AddEntry(entry);
+  node.symtab_entry = entry;
+}
+
+void MemSizeVisitor::AddLitVal(ASTNode& node) {
+  std::string name = GetLitValName();
+  if (counting_) return;
+  auto entry = std::shared_ptr<LocalVarEntry>(
+      new LocalVarEntry(name, node.Type(), node.Line(), nullptr, {}));
+  node.symtab->AddEntry(entry);
+  node.symtab_entry = entry;
 }
 
 void MemSizeVisitor::InitTypeSizes(ProgNode& node) {
@@ -27,17 +69,25 @@ void MemSizeVisitor::InitTypeSizes(ProgNode& node) {
   // Calculate class sizes
   for (std::string class_name : node.sorted_classes()) {
     type_sizes_[class_name] = 0;
-    auto classtab = node.symtab->GetEntry("class", class_name)->Link();
+    auto classtab =
+        node.symtab->GetEntry(EntryKind::CLASS, class_name)->Link();
     for (auto it = classtab->Begin(); it != classtab->End(); ++it) {
-      if (it->second->Kind() == "memberVar") {
-        type_sizes_[class_name] += GetEntrySize(*it->second);
+      if ((*it)->Kind() == EntryKind::MEMBER_VAR) {
+        type_sizes_[class_name] += GetEntrySize(**it);
       }
     }
   }
 }
 
+// Types that are undefined in a program with semantic errors take no space,
+// the sizes of such a program are never used for code generation
+int MemSizeVisitor::GetTypeSize(const std::string& type) const {
+  auto it = type_sizes_.find(type);
+  return it != type_sizes_.end() ? it->second : 0;
+}
+
 int MemSizeVisitor::GetEntrySize(const Entry& entry) {
-  int size = type_sizes_.at(entry.Type());
+  int size = GetTypeSize(entry.Type());
   for (auto& dim : entry.Dims()) {
     if (dim.length() > 0) {
       size *= std::stoi(dim);
@@ -47,41 +97,49 @@ int MemSizeVisitor::GetEntrySize(const Entry& entry) {
 }
 
 void MemSizeVisitor::Visit(ProgNode& node) {
+  if (counting_) {
+    DFS(node);
+    return;
+  }
   InitTypeSizes(node);
   for (auto it = node.symtab->Begin(); it != node.symtab->End(); ++it) {
-    it->second->size = GetEntrySize(*it->second);
-    node.symtab->SetScopeSize(node.symtab->ScopeSize() - it->second->size);
+    (*it)->size = GetEntrySize(**it);
+    node.symtab->SetScopeSize(node.symtab->ScopeSize() - (*it)->size);
   }
   DFS(node);
-  std::ofstream ofs("../out/outsymboltable");
-  ofs << *node.symtab;
+  if (!Logger::HasErrors()) {
+    std::ofstream ofs("../out/outsymboltable");
+    ofs << *node.symtab;
+  }
 }
 
 void MemSizeVisitor::Visit(ClassNode& node) {
   DFS(node);
+  if (counting_) return;
   auto symtab = node.symtab;
   for (auto it = symtab->Begin(); it != symtab->End(); ++it) {
-    if (it->first.first == "inherit") continue;
-    it->second->size = GetEntrySize(*it->second);
-    it->second->offset = symtab->ScopeSize() - it->second->size;
-    symtab->SetScopeSize(symtab->ScopeSize() - it->second->size);
+    if ((*it)->Kind() == EntryKind::INHERIT) continue;
+    (*it)->size = GetEntrySize(**it);
+    (*it)->offset = symtab->ScopeSize() - (*it)->size;
+    symtab->SetScopeSize(symtab->ScopeSize() - (*it)->size);
   }
 }
 
 void MemSizeVisitor::Visit(FuncDefNode& node) {
   DFS(node);
+  if (counting_) return;
   // After all the temps and literals were added to the
   // symtab, calculate offsets
   auto symtab = node.symtab;
   // Allocate some space for the return value at the bottom of the stack
   // frame.
   symtab->SetScopeSize(symtab->ScopeSize() -
-                       type_sizes_.at(node.ChildAt(3)->Val()));
+                       GetTypeSize(node.ChildAt(3)->Val()));
   // Then right after, make some space to store the return address
   symtab->SetScopeSize(symtab->ScopeSize() - 4);
   // Offsets for everything else
   for (auto it = symtab->Begin(); it != symtab->End(); ++it) {
-    auto entry = it->second;
+    auto entry = *it;
     entry->size = GetEntrySize(*entry);
     entry->offset = symtab->ScopeSize() - entry->size;
     symtab->SetScopeSize(symtab->ScopeSize() - entry->size);
@@ -90,11 +148,12 @@ void MemSizeVisitor::Visit(FuncDefNode& node) {
 
 void MemSizeVisitor::Visit(MainNode& node) {
   DFS(node);
+  if (counting_) return;
   // After all the temps and literals were added to the
   // symtab, calculate offsets
   auto symtab = node.symtab;
   for (auto it = symtab->Begin(); it != symtab->End(); ++it) {
-    auto entry = it->second;
+    auto entry = *it;
     entry->size = GetEntrySize(*entry);
     entry->offset = symtab->ScopeSize() - entry->size;
     symtab->SetScopeSize(symtab->ScopeSize() - entry->size);
@@ -105,66 +164,45 @@ void MemSizeVisitor::Visit(MainNode& node) {
 // The type was assigned to this node in TypeCheckVisitor
 void MemSizeVisitor::Visit(AddOpNode& node) {
   DFS(node);
-  auto entry = std::shared_ptr<LocalVarEntry>(new LocalVarEntry(
-      GetTempVarName(), node.Type(), node.ChildAt(0)->Line(), nullptr, {}));
-  node.symtab->AddEntry(entry);
-  node.symtab_entry = entry;
+  AddTempVar(node, node.ChildAt(0)->Line());
 }
 
 // Create a temp var entry
 // The type was assigned to this node in TypeCheckVisitor
 void MemSizeVisitor::Visit(MultOpNode& node) {
   DFS(node);
-  auto entry = std::shared_ptr<LocalVarEntry>(new LocalVarEntry(
-      GetTempVarName(), node.Type(), node.ChildAt(0)->Line(), nullptr, {}));
-  node.symtab->AddEntry(entry);
-  node.symtab_entry = entry;
+  AddTempVar(node, node.ChildAt(0)->Line());
 }
 
 // Create a temp var entry for the return value of the function
 // The type was assigned to this node in TypeCheckVisitor
 void MemSizeVisitor::Visit(FuncCallNode& node) {
   DFS(node);
-  auto entry = std::shared_ptr<LocalVarEntry>(new LocalVarEntry(
-      GetTempVarName(), node.Type(), node.ChildAt(0)->Line(), nullptr, {}));
-  node.symtab->AddEntry(entry);
-  node.symtab_entry = entry;
+  AddTempVar(node, node.ChildAt(0)->Line());
 }
 
 // Create tempvar for the result of the relExpr (the result is an integer)
 // The type was assigned to this node in TypeCheckVisitor
 void MemSizeVisitor::Visit(RelExprNode& node) {
   DFS(node);
-  auto entry = std::shared_ptr<LocalVarEntry>(new LocalVarEntry(
-      GetTempVarName(), node.Type(), node.ChildAt(1)->Line(), nullptr, {}));
-  node.symtab->AddEntry(entry);
-  node.symtab_entry = entry;
+  AddTempVar(node, node.ChildAt(1)->Line());
 }
 
 void MemSizeVisitor::Visit(NotNode& node) {
   DFS(node);
-  auto entry = std::shared_ptr<LocalVarEntry>(new LocalVarEntry(
-      GetTempVarName(), node.Type(), node.ChildAt(0)->Line(), nullptr, {}));
-  node.symtab->AddEntry(entry);
-  node.symtab_entry = entry;
+  AddTempVar(node, node.ChildAt(0)->Line());
 }
 
 // Create a literal entry, type was set during TypeCheckVisitor
 void MemSizeVisitor::Visit(IntNumNode& node) {
   DFS(node);
-  auto entry = std::shared_ptr<LocalVarEntry>(new LocalVarEntry(
-      GetLitValName(), node.Type(), node.Line(), nullptr, {}));
-  node.symtab->AddEntry(entry);
-  node.symtab_entry = entry;
+  AddLitVal(node);
 }
 
 // Create a literal entry, type was set during TypeCheckVisitor
 void MemSizeVisitor::Visit(FloatNumNode& node) {
   DFS(node);
-  auto entry = std::shared_ptr<LocalVarEntry>(new LocalVarEntry(
-      GetLitValName(), node.Type(), node.Line(), nullptr, {}));
-  node.symtab->AddEntry(entry);
-  node.symtab_entry = entry;
+  AddLitVal(node);
 }
 
 void MemSizeVisitor::Visit(VarNode& node) {
@@ -184,6 +222,10 @@ void MemSizeVisitor::Visit(ArithExprNode& node) {
 
 void MemSizeVisitor::Visit(SignNode& node) {
   DFS(node);
+  if (counting_) {
+    signed_vals_.push_back(node.Val() + node.ChildAt(0)->Val());
+    return;
+  }
   node.ChildAt(0)->SetVal(node.Val() + node.ChildAt(0)->Val());
   node.symtab_entry = node.ChildAt(0)->symtab_entry;
 }
@@ -0,0 +1,28 @@
+#include "node_kind.h"
+
+namespace toy {
+
+// Spellings by kind, NONE included.
+static const char* const NODE_KIND_NAMES[] = {
+#define TOY_NODE_KIND_NAME(Kind, Node, name) name,
+    TOY_AST_NODES(TOY_NODE_KIND_NAME)
+#undef TOY_NODE_KIND_NAME
+    "none",
+};
+
+static const int NUM_NODE_KINDS = static_cast<int>(NodeKind::NONE) + 1;
+
+std::string NodeKindToString(NodeKind kind) {
+  return NODE_KIND_NAMES[static_cast<int>(kind)];
+}
+
+NodeKind StringToNodeKind(const std::string& str) {
+  for (int kind = 0; kind < NUM_NODE_KINDS - 1; ++kind) {
+    if (str == NODE_KIND_NAMES[kind]) {
+      return static_cast<NodeKind>(kind);
+    }
+  }
+  return NodeKind::NONE;
+}
+
+}  // namespace toy
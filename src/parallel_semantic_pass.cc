@@ -0,0 +1,231 @@
+#include "parallel_semantic_pass.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include "symbol_table.h"
+#include "type_check_visitor.h"
+#include "type_table.h"
+
+namespace toy {
+
+namespace {
+
+// Interns the types the entries of symtab give expressions, i.e. their own
+// and those of their elements
+void InternTypes(SymbolTable& symtab, TypeTable& types) {
+  for (auto it = symtab.Begin(); it != symtab.End(); ++it) {
+    std::string type = (*it)->Type();
+    types.Intern(type);
+    for (std::size_t i = 0; i < (*it)->Dims().size(); ++i) {
+      type += "[]";
+      types.Intern(type);
+    }
+  }
+}
+
+// Appends the types of the nodes of the subtree at node, in preorder
+void SaveTypes(const ASTNode& node, std::vector<TypeId>& types) {
+  types.push_back(node.TypeID());
+  for (ASTNode* child : node.Children()) {
+    SaveTypes(*child, types);
+  }
+}
+
+// Gives the nodes back the types SaveTypes appended, from the one at pos on
+void RestoreTypes(ASTNode& node, const std::vector<TypeId>& types,
+                  std::size_t& pos) {
+  node.SetTypeID(types[pos++]);
+  for (ASTNode* child : node.Children()) {
+    RestoreTypes(*child, types, pos);
+  }
+}
+
+}  // namespace
+
+ParallelSemanticPass::ParallelSemanticPass(unsigned num_threads)
+    : num_threads_(num_threads) {
+  if (num_threads_ == 0) {
+    num_threads_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+void ParallelSemanticPass::Run(ASTNode& prog) {
+  if (prog.Kind() != NodeKind::PROG) {
+    throw std::invalid_argument("Not a program");
+  }
+  bodies_.clear();
+  serial_.clear();
+  sized_ = false;
+  for (auto& child : prog.Children()) {
+    if (child->Kind() == NodeKind::FUNC_DEF_LIST) {
+      for (auto& func : child->Children()) {
+        bodies_.push_back(Body());
+        bodies_.back().node = func;
+      }
+    } else if (child->Kind() == NodeKind::MAIN) {
+      bodies_.push_back(Body());
+      bodies_.back().node = child;
+    } else {
+      serial_.push_back(child);
+    }
+  }
+
+  TypeCheck(prog);
+  if (Logger::HasErrors()) {
+    return;
+  }
+  InternNames(prog);
+  MemSizeStep sizer(*this);
+  prog.Accept(sizer);
+  sized_ = true;
+}
+
+bool ParallelSemanticPass::Sized() const { return sized_; }
+
+void ParallelSemanticPass::TypeCheck(ASTNode& prog) {
+  TypeTable& types = prog.Types();
+  // Not added by any entry, the type checker sets it on undeclared members
+  types.Intern(TypeCheckVisitor::UNDECLARED_MEMBER_TYPE);
+  InternTypes(*prog.symtab, types);
+  for (auto it = prog.symtab->Begin(); it != prog.symtab->End(); ++it) {
+    if ((*it)->Kind() == EntryKind::CLASS && (*it)->Link()) {
+      InternTypes(*(*it)->Link(), types);
+    }
+  }
+  for (Body& body : bodies_) {
+    if (body.node->symtab) {
+      InternTypes(*body.node->symtab, types);
+    }
+  }
+
+  // The classes have neither temps nor literals
+  for (ASTNode* node : serial_) {
+    TypeCheckVisitor checker;
+    node->Accept(checker);
+  }
+  auto check = [](Body& body) {
+    TypeCheckVisitor checker;
+    body.node->Accept(checker);
+    MemSizeVisitor counter;
+    counter.SetCounting(true);
+    body.node->Accept(counter);
+    body.num_temps = counter.TempVarCounter() - 1;
+    body.num_lits = counter.LitValCounter() - 1;
+    body.signed_vals = counter.SignedVals();
+  };
+  if (num_threads_ == 1) {
+    ForEachBody(prog, 1, check);
+    return;
+  }
+  // The type checker reads the types of some nodes before setting them
+  std::vector<TypeId> types_before;
+  for (Body& body : bodies_) {
+    SaveTypes(*body.node, types_before);
+  }
+  try {
+    ForEachBody(prog, num_threads_, check);
+  } catch (const std::logic_error&) {
+    // A body added a type or name that was not interned beforehand, which
+    // the tables only allow off the threads, so check them all again alone
+    std::size_t pos = 0;
+    for (Body& body : bodies_) {
+      RestoreTypes(*body.node, types_before, pos);
+    }
+    ForEachBody(prog, 1, check);
+  }
+}
+
+void ParallelSemanticPass::InternNames(ASTNode& prog) {
+  int num_temps = 0;
+  int num_lits = 0;
+  for (Body& body : bodies_) {
+    body.first_temp = num_temps + 1;
+    body.first_lit = num_lits + 1;
+    num_temps += body.num_temps;
+    num_lits += body.num_lits;
+    for (const std::string& val : body.signed_vals) {
+      prog.Strings().Intern(val);
+    }
+  }
+  for (int i = 1; i <= num_temps; ++i) {
+    prog.symtab->InternName(MemSizeVisitor::TempVarName(i));
+  }
+  for (int i = 1; i <= num_lits; ++i) {
+    prog.symtab->InternName(MemSizeVisitor::LitValName(i));
+  }
+}
+
+void ParallelSemanticPass::ForEachBody(ASTNode& prog, unsigned num_threads,
+                                       const std::function<void(Body&)>& fn) {
+  std::atomic<std::size_t> next(0);
+  auto work = [&]() {
+    for (std::size_t i = next++; i < bodies_.size(); i = next++) {
+      Body& body = bodies_[i];
+      Logger::Redirect redirect(body.log);
+      try {
+        fn(body);
+      } catch (...) {
+        body.error = std::current_exception();
+      }
+    }
+  };
+
+  // The calling thread is one of them, and caches its lookups when alone
+  std::size_t num_workers =
+      std::min<std::size_t>(num_threads, bodies_.size());
+  bool concurrent = num_workers > 1;
+  prog.Types().SetConcurrent(concurrent);
+  prog.symtab->SetConcurrent(concurrent);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < num_workers; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  prog.Types().SetConcurrent(false);
+  prog.symtab->SetConcurrent(false);
+
+  std::exception_ptr error;
+  for (Body& body : bodies_) {
+    if (body.error && !error) {
+      error = body.error;
+    }
+    body.error = nullptr;
+  }
+  for (Body& body : bodies_) {
+    if (!error) {
+      Logger::Merge(body.log);
+    }
+    body.log = Logger();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+ParallelSemanticPass::MemSizeStep::MemSizeStep(ParallelSemanticPass& pass)
+    : pass_(pass) {}
+
+void ParallelSemanticPass::MemSizeStep::DFS(ASTNode& node) {
+  if (node.Kind() != NodeKind::PROG) {
+    MemSizeVisitor::DFS(node);
+    return;
+  }
+  for (ASTNode* child : pass_.serial_) {
+    child->Accept(*this);
+  }
+  // Each body gets a sizer of its own, with the type sizes of the program
+  const MemSizeVisitor& program_sizer = *this;
+  pass_.ForEachBody(node, pass_.num_threads_, [&program_sizer](Body& body) {
+    MemSizeVisitor sizer(program_sizer);
+    sizer.SetCounters(body.first_temp, body.first_lit);
+    body.node->Accept(sizer);
+  });
+}
+
+}  // namespace toy
@@ -0,0 +1,330 @@
+#include "parse_table.h"
+
+#include <map>
+#include <set>
+#include <stdexcept>
+
+namespace toy {
+
+// Number of token types, EOS being the last one.
+static const int NUM_TOKEN_TYPES = static_cast<int>(TokenType::EOS) + 1;
+
+// Bits of the sync sets entries.
+static const uint8_t IN_FIRST = 1;
+static const uint8_t IN_FOLLOW = 2;
+
+ParseTable::ParseTable(const Grammar& grammar, const ParserGenerator& pgen) {
+  // Collect the symbols by kind, '$' never being spelled out in the grammar.
+  // Symbols are numbered by spelling, since their ids depend on the order
+  // they were interned in.
+  std::set<Symbol, SymbolNameLess> terms = {Symbol(SymbolType::END)};
+  std::set<Symbol, SymbolNameLess> non_terms;
+  std::set<Symbol, SymbolNameLess> actions;
+  for (auto it = grammar.Begin(); it != grammar.End(); ++it) {
+    non_terms.insert(it->first);
+    for (const Rhs& rhs : it->second) {
+      for (const Symbol& symb : rhs) {
+        if (symb.Type() == SymbolType::TERM) {
+          terms.insert(symb);
+        } else if (symb.Type() == SymbolType::ACTION) {
+          actions.insert(symb);
+        } else if (symb.Type() != SymbolType::EPSILON) {
+          non_terms.insert(symb);
+        }
+      }
+    }
+  }
+  std::map<Symbol, int> ids;
+  for (const std::set<Symbol, SymbolNameLess>* kind :
+       {&terms, &non_terms, &actions}) {
+    for (const Symbol& symb : *kind) {
+      ids[symb] = name_strs_.size();
+      name_strs_.push_back(symb.Str());
+    }
+  }
+  ids[Symbol(SymbolType::EPSILON)] = name_strs_.size();
+  name_strs_.push_back(Symbol(SymbolType::EPSILON).Str());
+  num_terms_ = terms.size();
+  num_non_terms_ = non_terms.size();
+  num_actions_ = actions.size();
+  start_ = ids.at(Symbol(SymbolType::START));
+  end_ = ids.at(Symbol(SymbolType::END));
+
+  // Productions are numbered in grammar order. Each table entry is looked
+  // up in the generator's table and mapped back to its production number.
+  table_vec_.assign(num_non_terms_ * num_terms_, -1);
+  rhs_offsets_vec_.push_back(0);
+  for (auto it = grammar.Begin(); it != grammar.End(); ++it) {
+    int first_prod = rhs_offsets_vec_.size() - 1;
+    for (const Rhs& rhs : it->second) {
+      for (const Symbol& symb : rhs) {
+        rhs_vec_.push_back(ids.at(symb));
+      }
+      rhs_offsets_vec_.push_back(rhs_vec_.size());
+    }
+    int16_t* row = &table_vec_[(ids.at(it->first) - num_terms_) * num_terms_];
+    for (const Symbol& term : terms) {
+      if (!pgen.TableValid(it->first, term)) {
+        continue;
+      }
+      Production prod = pgen.TableAt(it->first, term);
+      for (std::size_t i = 0; i < it->second.size(); ++i) {
+        if (it->second[i] == prod.second) {
+          row[ids.at(term)] = first_prod + i;
+          break;
+        }
+      }
+    }
+  }
+  num_prods_ = rhs_offsets_vec_.size() - 1;
+
+  sync_sets_vec_.assign(num_non_terms_ * num_terms_, 0);
+  for (const Symbol& non_term : non_terms) {
+    int nt = ids.at(non_term) - num_terms_;
+    uint8_t* row = &sync_sets_vec_[nt * num_terms_];
+    for (const Symbol& term : pgen.FirstSets().at(non_term)) {
+      if (term.Type() != SymbolType::EPSILON) {
+        row[ids.at(term)] |= IN_FIRST;
+      }
+    }
+    for (const Symbol& term : pgen.FollowSets().at(non_term)) {
+      row[ids.at(term)] |= IN_FOLLOW;
+    }
+  }
+
+  expansion_offsets_vec_.push_back(0);
+  for (int prod = 0; prod < num_prods_; ++prod) {
+    for (int i = rhs_offsets_vec_[prod + 1] - 1; i >= rhs_offsets_vec_[prod];
+         --i) {
+      if (rhs_vec_[i] != Epsilon()) {
+        expansions_vec_.push_back(rhs_vec_[i]);
+      }
+    }
+    expansion_offsets_vec_.push_back(expansions_vec_.size());
+  }
+
+  for (int type = 0; type < NUM_TOKEN_TYPES; ++type) {
+    Symbol symb(Token(static_cast<TokenType>(type), "", 0));
+    auto it = ids.find(symb);
+    token_terms_vec_.push_back(
+        it != ids.end() && it->second < num_terms_ ? it->second : -1);
+  }
+
+  for (const std::string& name : name_strs_) {
+    name_ptrs_.push_back(name.c_str());
+  }
+  names_ = name_ptrs_.data();
+  table_ = table_vec_.data();
+  sync_sets_ = sync_sets_vec_.data();
+  rhs_offsets_ = rhs_offsets_vec_.data();
+  rhs_ = rhs_vec_.data();
+  expansion_offsets_ = expansion_offsets_vec_.data();
+  expansions_ = expansions_vec_.data();
+  token_terms_ = token_terms_vec_.data();
+  DecodeActions();
+}
+
+ParseTable::ParseTable(int num_terms, int num_non_terms, int num_actions,
+                       int num_prods, int start, int end,
+                       const char* const* names, const int16_t* table,
+                       const uint8_t* sync_sets, const int32_t* rhs_offsets,
+                       const int16_t* rhs,
+                       const int32_t* expansion_offsets,
+                       const int16_t* expansions, const int16_t* token_terms)
+    : num_terms_(num_terms),
+      num_non_terms_(num_non_terms),
+      num_actions_(num_actions),
+      num_prods_(num_prods),
+      start_(start),
+      end_(end),
+      names_(names),
+      table_(table),
+      sync_sets_(sync_sets),
+      rhs_offsets_(rhs_offsets),
+      rhs_(rhs),
+      expansion_offsets_(expansion_offsets),
+      expansions_(expansions),
+      token_terms_(token_terms) {
+  DecodeActions();
+}
+
+int ParseTable::NumTerms() const { return num_terms_; }
+
+int ParseTable::NumNonTerms() const { return num_non_terms_; }
+
+int ParseTable::NumActions() const { return num_actions_; }
+
+int ParseTable::NumSymbols() const {
+  return num_terms_ + num_non_terms_ + num_actions_ + 1;
+}
+
+int ParseTable::NumProductions() const { return num_prods_; }
+
+bool ParseTable::IsTerm(int symb) const { return symb < num_terms_; }
+
+bool ParseTable::IsNonTerm(int symb) const {
+  return symb >= num_terms_ && symb < num_terms_ + num_non_terms_;
+}
+
+bool ParseTable::IsAction(int symb) const {
+  return symb >= num_terms_ + num_non_terms_ && symb < Epsilon();
+}
+
+int ParseTable::Start() const { return start_; }
+
+int ParseTable::End() const { return end_; }
+
+int ParseTable::Epsilon() const { return NumSymbols() - 1; }
+
+const char* ParseTable::Name(int symb) const { return names_[symb]; }
+
+const SemanticAction& ParseTable::Action(int symb) const {
+  return actions_[symb - num_terms_ - num_non_terms_];
+}
+
+int ParseTable::TermOf(TokenType type) const {
+  return token_terms_[static_cast<int>(type)];
+}
+
+int ParseTable::At(int non_term, int term) const {
+  if (term < 0) {
+    return -1;
+  }
+  return table_[(non_term - num_terms_) * num_terms_ + term];
+}
+
+bool ParseTable::InFirst(int non_term, int term) const {
+  return term >= 0 &&
+         (sync_sets_[(non_term - num_terms_) * num_terms_ + term] & IN_FIRST);
+}
+
+bool ParseTable::InFollow(int non_term, int term) const {
+  return term >= 0 &&
+         (sync_sets_[(non_term - num_terms_) * num_terms_ + term] & IN_FOLLOW);
+}
+
+const int16_t* ParseTable::RhsBegin(int prod) const {
+  return rhs_ + rhs_offsets_[prod];
+}
+
+const int16_t* ParseTable::RhsEnd(int prod) const {
+  return rhs_ + rhs_offsets_[prod + 1];
+}
+
+const int16_t* ParseTable::ExpansionBegin(int prod) const {
+  return expansions_ + expansion_offsets_[prod];
+}
+
+const int16_t* ParseTable::ExpansionEnd(int prod) const {
+  return expansions_ + expansion_offsets_[prod + 1];
+}
+
+// Decodes an action spelled !sem_<type>_<node kind>!. The action types are
+// matched in order, so e.g. !sem_end_sign! is END_SIGN rather than END.
+static SemanticAction DecodeAction(const std::string& name) {
+  std::string action = name.substr(1, name.size() - 2);
+  if (action.find("end_sign") != std::string::npos) {
+    return {ActionType::END_SIGN, NodeKind::NONE};
+  } else if (action.find("end_scoperes") != std::string::npos) {
+    return {ActionType::END_SCOPERES, NodeKind::SCOPE_RES};
+  } else if (action.find("start") != std::string::npos) {
+    return {ActionType::START, NodeKind::NONE};
+  } else if (action.find("end") != std::string::npos) {
+    NodeKind kind = StringToNodeKind(action.substr(8));
+    if (kind == NodeKind::NONE || kind >= FIRST_LEAF_KIND) {
+      throw std::invalid_argument(action.substr(8) +
+                                  " is not a valid ASTNode kind.");
+    }
+    return {ActionType::END, kind};
+  } else if (action.find("push") != std::string::npos) {
+    if (action.find("type") != std::string::npos) {
+      return {ActionType::PUSH, NodeKind::TYPE};
+    } else if (action.find("dim") != std::string::npos) {
+      return {ActionType::PUSH, NodeKind::DIM};
+    }
+    return {ActionType::PUSH, NodeKind::NONE};
+  } else if (action.find("op") != std::string::npos) {
+    return {ActionType::OP, NodeKind::NONE};
+  }
+  return {ActionType::NONE, NodeKind::NONE};
+}
+
+// Decodes every action once, so parsing involves no string matching.
+void ParseTable::DecodeActions() {
+  for (int symb = num_terms_ + num_non_terms_; symb < Epsilon(); ++symb) {
+    actions_.push_back(DecodeAction(names_[symb]));
+  }
+}
+
+// Writes the n values as the body of an array initializer.
+template <typename T>
+static void WriteValues(std::ostream& os, const T* values, int n) {
+  std::size_t col = 0;
+  for (int i = 0; i < n; ++i) {
+    std::string value = std::to_string(values[i]) + ",";
+    if (col > 0 && col + 1 + value.size() > 76) {
+      os << "\n";
+      col = 0;
+    }
+    os << (col == 0 ? "    " : " ") << value;
+    col += (col == 0 ? 4 : 1) + value.size();
+  }
+  os << "\n";
+}
+
+static void WriteString(std::ostream& os, const char* s) {
+  os << '"';
+  for (; *s; ++s) {
+    if (*s == '"' || *s == '\\') {
+      os << '\\';
+    }
+    os << *s;
+  }
+  os << '"';
+}
+
+void ParseTable::WriteSource(std::ostream& os) const {
+  os << "// Generated by gen_parse_table. Do not edit.\n\n"
+     << "#include \"parse_table.h\"\n\n"
+     << "namespace toy {\n\n";
+  os << "static constexpr const char* NAMES[] = {\n";
+  for (int i = 0; i < NumSymbols(); ++i) {
+    os << "    ";
+    WriteString(os, names_[i]);
+    os << ",\n";
+  }
+  os << "};\n\n";
+  os << "static constexpr int16_t TABLE[] = {\n";
+  WriteValues(os, table_, num_non_terms_ * num_terms_);
+  os << "};\n\n";
+  os << "static constexpr uint8_t SYNC_SETS[] = {\n";
+  WriteValues(os, sync_sets_, num_non_terms_ * num_terms_);
+  os << "};\n\n";
+  os << "static constexpr int32_t RHS_OFFSETS[] = {\n";
+  WriteValues(os, rhs_offsets_, num_prods_ + 1);
+  os << "};\n\n";
+  os << "static constexpr int16_t RHS[] = {\n";
+  WriteValues(os, rhs_, rhs_offsets_[num_prods_]);
+  os << "};\n\n";
+  os << "static constexpr int32_t EXPANSION_OFFSETS[] = {\n";
+  WriteValues(os, expansion_offsets_, num_prods_ + 1);
+  os << "};\n\n";
+  os << "static constexpr int16_t EXPANSIONS[] = {\n";
+  WriteValues(os, expansions_, expansion_offsets_[num_prods_]);
+  os << "};\n\n";
+  os << "static constexpr int16_t TOKEN_TERMS[] = {\n";
+  WriteValues(os, token_terms_, NUM_TOKEN_TYPES);
+  os << "};\n\n";
+  os << "const ParseTable& ParseTable::Embedded() {\n"
+     << "  static const ParseTable table(" << num_terms_ << ", "
+     << num_non_terms_ << ", " << num_actions_ << ", " << num_prods_ << ", "
+     << start_ << ", " << end_ << ", NAMES, TABLE,\n"
+     << "                                SYNC_SETS, RHS_OFFSETS, RHS,\n"
+     << "                                EXPANSION_OFFSETS, EXPANSIONS,\n"
+     << "                                TOKEN_TERMS);\n"
+     << "  return table;\n"
+     << "}\n\n"
+     << "}  // namespace toy\n";
+}
+
+}  // namespace toy
@@ -6,32 +6,101 @@
 
 namespace toy {
 
-Parser::Parser(Lexer& lexer, const ParserGenerator& pgen)
-    : lexer_(lexer), pgen_(pgen){};
+// Deep enough for the symbol stack of most programs, so that it rarely grows
+// during a parse.
+static const std::size_t INITIAL_STACK_CAPACITY = 256;
+
+// Syntax errors reported before parsing stops.
+static const int DEFAULT_MAX_ERRORS = 20;
+
+Parser::Parser(Lexer& lexer, const ParseTable& table)
+    : lexer_(&lexer),
+      tokens_(nullptr),
+      pos_(0),
+      table_(table),
+      mode_(ParserMode::TABLE),
+      derivation_log_(nullptr),
+      max_errors_(DEFAULT_MAX_ERRORS){};
+
+Parser::Parser(const TokenArray& tokens, const ParseTable& table)
+    : lexer_(nullptr),
+      tokens_(&tokens),
+      pos_(0),
+      table_(table),
+      mode_(ParserMode::TABLE),
+      derivation_log_(nullptr),
+      max_errors_(DEFAULT_MAX_ERRORS){};
+
+void Parser::SetMode(ParserMode mode) { mode_ = mode; }
+
+void Parser::SetDerivationLog(TraceSink* sink) { derivation_log_ = sink; }
+
+void Parser::SetMaxErrors(int max_errors) { max_errors_ = max_errors; }
+
+const std::vector<RecoveryPoint>& Parser::RecoveryPoints() const {
+  return recovery_points_;
+}
+
+// Returns the next non-comment token.
+Token Parser::NextToken() {
+  if (tokens_) {
+    // The array has no comments and ends with EOS, which is repeated if the
+    // parser keeps asking.
+    if (pos_ < tokens_->Size()) {
+      return tokens_->At(pos_++);
+    }
+    return tokens_->At(tokens_->Size() - 1);
+  }
+  Token tk = lexer_->NextToken();
+  while (tk.IsComment()) {
+    tk = lexer_->NextToken();
+  }
+  return tk;
+}
+
+// Returns true if tokens are left after the last one handed out.
+bool Parser::HasNextToken() {
+  return tokens_ ? pos_ < tokens_->Size() : lexer_->HasNext();
+}
 
 // LL(1) table-driven parsing
 std::shared_ptr<ASTNode> Parser::Parse() {
-  std::ofstream derivations("../out/outderivation");
-  Token tk = lexer_.NextToken();
+  num_errors_ = 0;
+  recovering_ = false;
+  recovery_points_.clear();
+  semantic_stack_ = std::stack<ASTNode*>();
+  arena_ = std::make_shared<ASTArena>();
+  if (mode_ == ParserMode::RECURSIVE_DESCENT) {
+    return ParseRecursiveDescent();
+  }
+
+  Token tk = NextToken();
   bool error = false;
 
-  symbol_stack_.emplace(SymbolType::END);
-  symbol_stack_.emplace(SymbolType::START);
-  while (symbol_stack_.top().Type() != SymbolType::END) {
-    // Skip over comment tokens
-    while (tk.IsComment()) {
-      tk = lexer_.NextToken();
+  symbol_stack_.clear();
+  symbol_stack_.reserve(INITIAL_STACK_CAPACITY);
+  symbol_stack_.push_back(table_.End());
+  symbol_stack_.push_back(table_.Start());
+  while (symbol_stack_.back() != table_.End()) {
+    int top = symbol_stack_.back();
+    if (derivation_log_) {
+      *derivation_log_ << table_.Name(top) << '\n';
     }
-    Symbol top = symbol_stack_.top();
-    derivations << top << std::endl;
-    if (top.Type() == SymbolType::ACTION) {
-      ExecuteSemanticAction(top.RawStr());
-      symbol_stack_.pop();
-    } else if (top.IsTerm()) {
-      if (top == tk) {
-        symbol_stack_.pop();
+    if (table_.IsAction(top)) {
+      // After a syntax error the semantic stack no longer matches the
+      // symbols, so no more nodes are built.
+      if (!error) {
+        ExecuteSemanticAction(table_.Action(top));
+      }
+      symbol_stack_.pop_back();
+    } else if (table_.IsTerm(top)) {
+      if (top == table_.TermOf(tk.Type())) {
+        if (recovering_) {
+          EndRecovery(tk);
+        }
+        symbol_stack_.pop_back();
         prev_token_ = tk;
-        tk = lexer_.NextToken();
+        tk = NextToken();
       } else {
         SkipErrors(top, tk);
         error = true;
@@ -39,43 +108,101 @@ std::shared_ptr<ASTNode> Parser::Parse() {
     }
     // Push the correct inverse of the production on the stack
     else {
-      if (pgen_.TableValid(top, tk)) {
-        symbol_stack_.pop();
-        InverseRhsMultiplePush(top, tk);
+      int prod = table_.At(top, table_.TermOf(tk.Type()));
+      if (prod != -1) {
+        symbol_stack_.pop_back();
+        InverseRhsMultiplePush(prod);
       } else {
         SkipErrors(top, tk);
         error = true;
       }
     }
+    if (num_errors_ >= max_errors_) {
+      Logger::Warn("Too many syntax errors, stopped parsing", tk.Line(),
+                   WarningType::SYNTAX);
+      recovering_ = false;  // Parsing does not resume
+      break;
+    }
   }
-  if (lexer_.HasNext() || error == true) {
-    derivations << "# Parsing failed" << std::endl;
-    return semantic_stack_.top();
+  if (recovering_) {
+    EndRecovery(tk);
+  }
+  if (HasNextToken() || error == true) {
+    if (derivation_log_) {
+      *derivation_log_ << "# Parsing failed\n";
+    }
+    return nullptr;
   } else {
-    derivations << "# Parsing ok" << std::endl;
-    return semantic_stack_.top();
+    if (derivation_log_) {
+      *derivation_log_ << "# Parsing ok\n";
+    }
+    return Root();
   }
 };
 
-// This syntax error recovery is very primitive - just pops from the symbol
-// stack and attempts to continue the parse.
-// TODO: implement a better syntax error recovery mechanism (i.e. token
-// synchronization)
-void Parser::SkipErrors(Symbol& top, Token& tk) {
-  Logger::Err(
-      "Expected '" + top.Str() + "', but next token was '" + tk.Lexeme() + "'",
-      tk.Line(), ErrorType::SYNTAX);
-  symbol_stack_.pop();
+// The node on top of the semantic stack, sharing ownership of the arena.
+std::shared_ptr<ASTNode> Parser::Root() const {
+  return std::shared_ptr<ASTNode>(arena_, semantic_stack_.top());
+}
+
+// Panic-mode recovery. A terminal that does not match is taken as missing
+// and popped. For a non-terminal, tokens are skipped until one is in its
+// FIRST set, to expand it with, or in its FOLLOW set or expected further
+// down the stack, to pop it and carry on with what follows it.
+void Parser::SkipErrors(int top, Token& tk) {
+  if (!recovering_) {
+    Logger::Err(std::string("Expected '") + table_.Name(top) +
+                    "', but next token was '" + tk.Lexeme() + "'",
+                tk.Line(), ErrorType::SYNTAX);
+    ++num_errors_;
+    recovering_ = true;
+    recovery_points_.push_back({tk.Line(), tk.Line(), 0});
+  }
+  if (table_.IsTerm(top)) {
+    symbol_stack_.pop_back();
+    return;
+  }
+  int term = table_.TermOf(tk.Type());
+  while (term != table_.End() && !table_.InFirst(top, term) &&
+         !table_.InFollow(top, term) && !ExpectedBelowTop(term)) {
+    prev_token_ = tk;
+    tk = NextToken();
+    term = table_.TermOf(tk.Type());
+    ++recovery_points_.back().skipped;
+  }
+  if (!table_.InFirst(top, term)) {
+    symbol_stack_.pop_back();
+  }
 }
 
-void Parser::InverseRhsMultiplePush(Symbol top, Symbol tk) {
-  Production prod = pgen_.TableAt(top, tk);
-  // Push the reverse of the rhs on the stack
-  std::vector<Symbol> rhs = prod.second;
-  std::reverse(rhs.begin(), rhs.end());
-  for (Symbol symb : rhs) {
-    if (symb.Type() != SymbolType::EPSILON) symbol_stack_.push(symb);
+// Returns true if a symbol below the top of the stack can start with term,
+// e.g. the next statement after one missing its ';'.
+bool Parser::ExpectedBelowTop(int term) const {
+  for (std::size_t i = symbol_stack_.size() - 1; i-- > 0;) {
+    int symb = symbol_stack_[i];
+    if (symb == term ||
+        (table_.IsNonTerm(symb) && table_.InFirst(symb, term))) {
+      return true;
+    }
   }
+  return false;
+}
+
+// Reports where parsing resumed after the last syntax error, tk being the
+// first token matched since.
+void Parser::EndRecovery(const Token& tk) {
+  RecoveryPoint& point = recovery_points_.back();
+  point.resume_line = tk.Line();
+  Logger::Warn("Resumed parsing at '" + tk.Lexeme() + "' after skipping " +
+                   std::to_string(point.skipped) + " token(s)",
+               tk.Line(), WarningType::SYNTAX);
+  recovering_ = false;
+}
+
+void Parser::InverseRhsMultiplePush(int prod) {
+  // The table keeps the reverse of the rhs ready to push, EPSILON left out
+  symbol_stack_.insert(symbol_stack_.end(), table_.ExpansionBegin(prod),
+                       table_.ExpansionEnd(prod));
 }
 
 // In the grammar, actions are encoded in the form:
@@ -86,63 +213,74 @@ void Parser::InverseRhsMultiplePush(Symbol top, Symbol tk) {
 // - start: push a nullptr on the stack to signify the start of a siblings list.
 // - end: adopts all siblings until the marker node.
 // - op: special case for addOp, assignOp, multOp.
-void Parser::ExecuteSemanticAction(const std::string& action) {
-  if (action.find("end_sign") != std::string::npos) {
-    EndSignAction();
-  } else if (action.find("end_scoperes") != std::string::npos) {
-    EndScopeResAction(action);
-  } else if (action.find("start") != std::string::npos) {
-    StartAction();
-  } else if (action.find("end") != std::string::npos) {
-    EndAction(action);
-  } else if (action.find("push") != std::string::npos) {
-    PushAction(action);
-  } else if (action.find("op") != std::string::npos) {
-    OpAction();
+// The table decodes the actions up front, see ParseTable::Action.
+void Parser::ExecuteSemanticAction(const SemanticAction& action) {
+  switch (action.type) {
+    case ActionType::END_SIGN:
+      EndSignAction();
+      break;
+    case ActionType::END_SCOPERES:
+      EndScopeResAction(action.node_kind);
+      break;
+    case ActionType::START:
+      StartAction();
+      break;
+    case ActionType::END:
+      EndAction(action.node_kind);
+      break;
+    case ActionType::PUSH:
+      PushAction(action.node_kind);
+      break;
+    case ActionType::OP:
+      OpAction();
+      break;
+    case ActionType::NONE:
+      break;
   }
 }
 
 void Parser::StartAction() { semantic_stack_.push(nullptr); }
 
-void Parser::EndAction(std::string action) {
-  std::string node_kind = action.substr(8);
+void Parser::EndAction(NodeKind node_kind) {
   // In this case we had nothing on the stack, just pop it
   if (semantic_stack_.top() == nullptr) {
     semantic_stack_.pop();
-    auto node = ASTNode::MakeNode(node_kind);
-    semantic_stack_.push(node);
+    semantic_stack_.push(arena_->MakeNode(node_kind));
   } else {
-    auto parent = ASTNode::MakeNode(node_kind);
+    ASTNode* parent = arena_->MakeNode(node_kind);
 
-    std::stack<std::shared_ptr<ASTNode>> reverse;
+    std::vector<ASTNode*> reverse;
     while (semantic_stack_.top() != nullptr) {
-      reverse.push(semantic_stack_.top());
+      reverse.push_back(semantic_stack_.top());
       semantic_stack_.pop();
     }
-    while (reverse.size() > 0) {
-      parent->AddChild(reverse.top());
-      reverse.pop();
+    parent->ReserveChildren(reverse.size());
+    for (auto it = reverse.rbegin(); it != reverse.rend(); ++it) {
+      parent->AddChild(*it);
     }
     semantic_stack_.pop();  // pop the NULL OUT
     semantic_stack_.push(parent);
   }
 }
 
-void Parser::PushAction(const std::string& action) {
-  std::shared_ptr<ASTNode> node = nullptr;
-  if (action.find("type") != std::string::npos) {
-    node = ASTNode::MakeNode("type", prev_token_.Lexeme(), prev_token_.Line());
-  } else if (action.find("dim") != std::string::npos) {
+// Pushes a leaf of the given kind, or if it is NONE one of the kind the
+// previous token makes.
+void Parser::PushAction(NodeKind node_kind) {
+  ASTNode* node = nullptr;
+  if (node_kind == NodeKind::TYPE) {
+    node = arena_->MakeNode(NodeKind::TYPE, prev_token_.Lexeme(),
+                            prev_token_.Line());
+  } else if (node_kind == NodeKind::DIM) {
     std::string val;
     if (prev_token_.Type() == TokenType::INTNUM) {
       val = prev_token_.Lexeme();
     } else {
       val = "";
     }
-    node = ASTNode::MakeNode("dim", val, prev_token_.Line());
+    node = arena_->MakeNode(NodeKind::DIM, val, prev_token_.Line());
   } else {
-    node = ASTNode::MakeNode(TokenTypeToString(prev_token_.Type()),
-                             prev_token_.Lexeme(), prev_token_.Line());
+    node = arena_->MakeNode(ASTNode::LeafKindOf(prev_token_.Type()),
+                            prev_token_.Lexeme(), prev_token_.Line());
   }
   semantic_stack_.push(node);
 }
@@ -161,19 +299,20 @@ void Parser::OpAction() {
 }
 
 void Parser::EndSignAction() {
-  std::shared_ptr<ASTNode> factor = semantic_stack_.top();
+  ASTNode* factor = semantic_stack_.top();
   semantic_stack_.pop();
-  std::shared_ptr<ASTNode> child_node = semantic_stack_.top();
+  ASTNode* child_node = semantic_stack_.top();
   semantic_stack_.pop();
   semantic_stack_.pop();  // pop the NULL out
-  auto node = ASTNode::MakeNode("sign", child_node->Val(), child_node->Line());
+  ASTNode* node = arena_->MakeNode(NodeKind::SIGN, child_node->Val(),
+                                   child_node->Line());
   node->AddChild(factor);
   semantic_stack_.push(node);
 }
 
-void Parser::EndScopeResAction(std::string action) {
-  std::shared_ptr<ASTNode> func_name_node;
-  std::shared_ptr<ASTNode> scope_res_node;
+void Parser::EndScopeResAction(NodeKind node_kind) {
+  ASTNode* func_name_node;
+  ASTNode* scope_res_node;
   if (semantic_stack_.top() != nullptr) {
     func_name_node = semantic_stack_.top();
     semantic_stack_.pop();
@@ -183,9 +322,9 @@ void Parser::EndScopeResAction(std::string action) {
     semantic_stack_.push(func_name_node);
     semantic_stack_.push(nullptr);
     semantic_stack_.push(scope_res_node);
-    EndAction(action);
+    EndAction(node_kind);
   } else {
-    EndAction(action);
+    EndAction(node_kind);
   }
 }
 
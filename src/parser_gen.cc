@@ -2,13 +2,17 @@
 
 #include <algorithm>
 #include <queue>
+#include <stdexcept>
 
 #include "util.h"
 
 namespace toy {
 
 ParserGenerator::ParserGenerator(const Grammar& grammar) : grammar_(grammar) {
-  CalculateSets();
+  IndexGrammar();
+  CalculateFirstSets();
+  CalculateFollowSets();
+  MaterializeSets();
   ConstructTable();
 }
 
@@ -20,13 +24,22 @@ const FirstSetsRhs& ParserGenerator::FirstSetsOfRhs() const {
   return first_sets_rhs_;
 }
 
-Production ParserGenerator::TableAt(Symbol row, Symbol col) {
-  return table_.at(row).at(col);
+const Production& ParserGenerator::TableAt(Symbol row, Symbol col) const {
+  if (!TableValid(row, col)) {
+    throw std::out_of_range("No production for " + row.Str() + " on " +
+                            col.Str());
+  }
+  return prods_[table_[rows_[row.Id()] * terms_.size() + cols_[col.Id()]]];
 }
 
-bool ParserGenerator::TableValid(Symbol row, Symbol col) {
-  return (table_.find(row) != table_.end()) &&
-         (table_.at(row).find(col) != table_.at(row).end());
+bool ParserGenerator::TableValid(Symbol row, Symbol col) const {
+  // Symbols interned after the table was built are in neither dimension.
+  if (row.Id() >= static_cast<int>(rows_.size()) ||
+      col.Id() >= static_cast<int>(cols_.size()) || rows_[row.Id()] == -1 ||
+      cols_[col.Id()] == -1) {
+    return false;
+  }
+  return table_[rows_[row.Id()] * terms_.size() + cols_[col.Id()]] != -1;
 }
 
 void ParserGenerator::PrintSets() const {
@@ -41,14 +54,15 @@ void ParserGenerator::PrintSets() const {
 }
 
 void ParserGenerator::PrintTable() const {
-  for (auto it = table_.begin(); it != table_.end(); ++it) {
-    auto row = it->first;
-    std::cout << "Row: " << row << std::endl;
-    auto cols = it->second;
-    for (auto it2 = cols.begin(); it2 != cols.end(); ++it2) {
-      Production prod = it2->second;
-      std::cout << "Col: " << it2->first << ", Production: ";
-      for (Symbol symb : prod.second) {
+  for (std::size_t row = 0; row < non_terms_.size(); ++row) {
+    std::cout << "Row: " << non_terms_[row] << std::endl;
+    for (std::size_t col = 0; col < terms_.size(); ++col) {
+      int prod = table_[row * terms_.size() + col];
+      if (prod == -1) {
+        continue;
+      }
+      std::cout << "Col: " << terms_[col] << ", Production: ";
+      for (Symbol symb : prods_[prod].second) {
         std::cout << symb << " ";
       }
       std::cout << std::endl;
@@ -56,190 +70,201 @@ void ParserGenerator::PrintTable() const {
   }
 }
 
-void ParserGenerator::CalculateSets() {
-  for (auto it = grammar_.Begin(); it != grammar_.End(); ++it) {
-    FirstSetOf(it->first);
-    FollowSetOf(it->first);
-  }
-  for (auto it = grammar_.Begin(); it != grammar_.End(); ++it) {
-    ResolveDependencies(it->first);
-  }
-}
-
-void ParserGenerator::ConstructTable() {
-  for (auto it = grammar_.Begin(); it != grammar_.End(); ++it) {
-    Symbol lhs = it->first;
-    for (Rhs rhs : it->second) {
-      if (table_.find(lhs) == table_.end()) {
-        table_[lhs] = std::map<Symbol, Production>();
+// Gives every terminal of the grammar a column and every non-terminal a row,
+// and numbers the productions.
+void ParserGenerator::IndexGrammar() {
+  // Intern EPSILON and '$' first, so every id below is in range.
+  Symbol epsilon(SymbolType::EPSILON);
+  Symbol end(SymbolType::END);
+  cols_.assign(Symbol::NumIds(), -1);
+  rows_.assign(Symbol::NumIds(), -1);
+  auto add = [&](Symbol symb) {
+    if (symb.IsTerm() || symb.Type() == SymbolType::END) {
+      if (cols_[symb.Id()] == -1) {
+        cols_[symb.Id()] = terms_.size();
+        terms_.push_back(symb);
       }
-      // If terminal is EPSILON do not add it to the table
-      Rhs rhs_no_actions;
-      std::copy_if(rhs.begin(), rhs.end(), std::back_inserter(rhs_no_actions),
-                   [](Symbol s) { return s.Type() != SymbolType::ACTION; });
-      auto first_rhs = first_sets_rhs_[rhs_no_actions];
-      for (Symbol terminal : first_rhs) {
-        if (terminal.Type() != SymbolType::EPSILON) {
-          table_[lhs][terminal] = std::make_pair(lhs, rhs);
-        }
+    } else if (symb.Type() != SymbolType::ACTION) {
+      if (rows_[symb.Id()] == -1) {
+        rows_[symb.Id()] = non_terms_.size();
+        non_terms_.push_back(symb);
       }
-      if (first_rhs.find(Symbol("EPSILON")) != first_rhs.end()) {
-        for (auto& terminal : follow_sets_[lhs]) {
-          if (terminal.Type() != SymbolType::EPSILON) {
-            table_[lhs][terminal] = std::make_pair(lhs, rhs);
-          }
-        }
+    }
+  };
+  add(epsilon);
+  add(end);
+  for (auto it = grammar_.Begin(); it != grammar_.End(); ++it) {
+    add(it->first);
+    for (const Rhs& rhs : it->second) {
+      prods_.emplace_back(it->first, rhs);
+      rhs_.emplace_back();
+      std::copy_if(rhs.begin(), rhs.end(), std::back_inserter(rhs_.back()),
+                   [](Symbol s) { return s.Type() != SymbolType::ACTION; });
+      for (const Symbol& symb : rhs) {
+        add(symb);
       }
     }
   }
+  epsilon_ = cols_[epsilon.Id()];
+  first_.assign(non_terms_.size(), BitSet(terms_.size()));
+  first_rhs_.assign(prods_.size(), BitSet(terms_.size()));
+  follow_.assign(non_terms_.size(), BitSet(terms_.size()));
+  first_used_.assign(terms_.size(), false);
 }
 
-// Computes the first set of the given symbol
-Set ParserGenerator::FirstSetOf(Symbol symb) {
-  if (first_sets_.find(symb) != first_sets_.end()) {
-    return first_sets_.at(symb);
-  }
-  // If it's a terminal, its first set is itself
-  if (symb.IsTerm()) {
-    first_sets_[symb].insert(symb);
-    return first_sets_[symb];
+// FIRST(A) is the union of FIRST(rhs) over A's productions. Every production
+// starts on the worklist, and whenever FIRST(A) grows the productions with A
+// on their rhs are queued again, until nothing changes.
+void ParserGenerator::CalculateFirstSets() {
+  std::vector<std::vector<int>> users(non_terms_.size());
+  for (std::size_t prod = 0; prod < rhs_.size(); ++prod) {
+    for (const Symbol& symb : rhs_[prod]) {
+      if (rows_[symb.Id()] != -1) {
+        users[rows_[symb.Id()]].push_back(prod);
+      }
+    }
   }
 
-  auto productions_for_symbol = grammar_.GetProductionsForSymbol(symb);
-  for (auto& production : productions_for_symbol) {
-    std::vector<Symbol> rhs = production.second;
-    std::set<Symbol> first_set_rhs = FirstSetOfRhs(rhs);
-    // Add FIRST(X1X2...Xk) to first(A)
-    first_sets_[symb].insert(first_set_rhs.begin(), first_set_rhs.end());
+  std::queue<int> worklist;
+  std::vector<bool> queued(rhs_.size(), true);
+  for (std::size_t prod = 0; prod < rhs_.size(); ++prod) {
+    worklist.push(prod);
   }
-  return first_sets_[symb];
-}
+  while (!worklist.empty()) {
+    int prod = worklist.front();
+    worklist.pop();
+    queued[prod] = false;
 
-// Computes the first set of a rhs
-Set ParserGenerator::FirstSetOfRhs(const std::vector<Symbol>& rhs) {
-  if (first_sets_rhs_.find(rhs) != first_sets_rhs_.end()) {
-    return first_sets_rhs_.at(rhs);
-  }
-  std::set<Symbol> first_set_rhs;
-  for (Symbol symb : rhs) {
-    if (symb.Type() == SymbolType::ACTION) {
+    BitSet& first_rhs = first_rhs_[prod];
+    if (FirstSetOfRhs(rhs_[prod], 0, first_rhs)) {
+      first_rhs.Insert(epsilon_);
+    }
+    int row = rows_[prods_[prod].first.Id()];
+    if (!first_[row].UnionWith(first_rhs)) {
       continue;
     }
-    if (symb.Type() == SymbolType::EPSILON) {
-      first_set_rhs.insert(symb);
-      break;
+    for (int user : users[row]) {
+      if (!queued[user]) {
+        queued[user] = true;
+        worklist.push(user);
+      }
     }
+  }
+}
 
-    auto first_set_of_cur = FirstSetOf(symb);
-    // Add first_set_of_cur to first_set_rhs, excluding EPSILON.
-    Set tmp = first_set_of_cur;
-    tmp.erase(Symbol("EPSILON"));
-    first_set_rhs.insert(tmp.begin(), tmp.end());
+// For every B -> XAY, FOLLOW(A) gets FIRST(Y) and, if Y can derive EPSILON,
+// all of FOLLOW(B). The first part is added right away, the second is kept
+// as an edge from B to A along which a worklist propagates follow sets until
+// nothing changes.
+void ParserGenerator::CalculateFollowSets() {
+  // Start symbol always contains "$" in its follow set.
+  Symbol start(SymbolType::START);
+  follow_[rows_[start.Id()]].Insert(cols_[Symbol(SymbolType::END).Id()]);
 
-    // If there is no EPSILON, we're done
-    if (!std::any_of(
-            first_set_of_cur.begin(), first_set_of_cur.end(),
-            [](Symbol s) { return s.Type() == SymbolType::EPSILON; })) {
-      break;
+  std::vector<std::vector<int>> dependents(non_terms_.size());
+  for (std::size_t prod = 0; prod < rhs_.size(); ++prod) {
+    const Rhs& rhs = rhs_[prod];
+    int lhs_row = rows_[prods_[prod].first.Id()];
+    for (std::size_t i = 0; i < rhs.size(); ++i) {
+      int row = rows_[rhs[i].Id()];
+      // FOLLOW(<START>) is only ever "$".
+      if (row == -1 || rhs[i] == start) {
+        continue;
+      }
+      if (FirstSetOfRhs(rhs, i + 1, follow_[row])) {
+        dependents[lhs_row].push_back(row);
+      }
     }
-    // If all symbols were checked, add EPSILON to the set
-    else if (symb == rhs.at(rhs.size() - 1)) {
-      first_set_rhs.insert(Symbol("EPSILON"));
+  }
+
+  std::queue<int> worklist;
+  std::vector<bool> queued(non_terms_.size(), true);
+  for (std::size_t row = 0; row < non_terms_.size(); ++row) {
+    worklist.push(row);
+  }
+  while (!worklist.empty()) {
+    int row = worklist.front();
+    worklist.pop();
+    queued[row] = false;
+    for (int dependent : dependents[row]) {
+      if (follow_[dependent].UnionWith(follow_[row]) && !queued[dependent]) {
+        queued[dependent] = true;
+        worklist.push(dependent);
+      }
     }
   }
-  first_sets_rhs_[rhs] = first_set_rhs;
-  return first_set_rhs;
 }
 
-// Computes the follow set of the given symbol
-Set ParserGenerator::FollowSetOf(Symbol symb) {
-  if (follow_sets_.find(symb) != follow_sets_.end()) {
-    return follow_sets_.at(symb);
+// Builds the std::set views. FirstSets() holds every non-terminal with
+// rules, and the terminals that some first or follow set was taken from.
+void ParserGenerator::MaterializeSets() {
+  for (std::size_t col = 0; col < terms_.size(); ++col) {
+    if (first_used_[col]) {
+      first_sets_[terms_[col]] = {terms_[col]};
+    }
+  }
+  for (auto it = grammar_.Begin(); it != grammar_.End(); ++it) {
+    int row = rows_[it->first.Id()];
+    first_sets_[it->first] = ToSet(first_[row]);
+    follow_sets_[it->first] = ToSet(follow_[row]);
+  }
+  for (std::size_t prod = 0; prod < rhs_.size(); ++prod) {
+    first_sets_rhs_[rhs_[prod]] = ToSet(first_rhs_[prod]);
   }
-  follow_sets_[symb] = {};
+}
 
-  // Start symbol always contains "$" in its follow set.
-  if (symb.Type() == SymbolType::START) {
-    follow_sets_[symb].emplace("'$'");
-    return follow_sets_[symb];
-  }
-
-  // Check all productions where our symbol appears on the RHS
-  std::vector<Production> productions_with_symbol =
-      grammar_.GetProductionsWithSymbol(symb);
-
-  for (Production production : productions_with_symbol) {
-    std::vector<Symbol> rhs = production.second;
-    size_t symbol_index = std::find(rhs.begin(), rhs.end(), symb) - rhs.begin();
-    // We get the follow symbols of our symbol, e.g.
-    // S -> AaAb, so Follow(A) would be FIRST(aAb) = {a, b}. If it's the last
-    // symbol, it should be FOLLOW(S)
-    while (symbol_index < rhs.size()) {
-      std::vector<Symbol> follow_part =
-          std::vector<Symbol>(rhs.begin() + symbol_index + 1, rhs.end());
-
-      if (follow_part.size() > 0) {
-        while (follow_part.size() > 0) {
-          Symbol production_symbol = follow_part.at(0);
-          Set first_of_follow = FirstSetOf(production_symbol);
-          // Add first_set_of_cur to follow set, excluding EPSILON
-          auto tmp = first_of_follow;
-          tmp.erase(Symbol("EPSILON"));
-          follow_sets_[symb].insert(tmp.begin(), tmp.end());
-
-          // If there is no EPSILON, we're done, otherwise continue
-          if (!std::any_of(
-                  first_of_follow.begin(), first_of_follow.end(),
-                  [](Symbol s) { return s.Type() == SymbolType::EPSILON; })) {
-            break;
-          }
-          follow_part =
-              std::vector<Symbol>(follow_part.begin() + 1, follow_part.end());
-        }
+void ParserGenerator::ConstructTable() {
+  table_.assign(non_terms_.size() * terms_.size(), -1);
+  for (std::size_t prod = 0; prod < prods_.size(); ++prod) {
+    int lhs_row = rows_[prods_[prod].first.Id()];
+    int* row = &table_[lhs_row * terms_.size()];
+    // If terminal is EPSILON do not add it to the table
+    const BitSet& first_rhs = first_rhs_[prod];
+    first_rhs.ForEach([&](std::size_t col) {
+      if (static_cast<int>(col) != epsilon_) {
+        row[col] = prod;
       }
-
-      // For productions of the form B -> XA, FOLLOW(A) is FOLLOW(B)
-      if (follow_part.size() == 0) {
-        auto lhs = production.first;
-        // We add B to our dependency graph, and only on a second
-        // pass we will add FOLLOW(B) to FOLLOW(A) by traversing
-        // the graph to get As dependent FOLLOW sets.
-        if (dep_graph_.find(symb) == dep_graph_.end()) {
-          dep_graph_[symb] = {lhs};
+    });
+    if (first_rhs.Contains(epsilon_)) {
+      follow_[lhs_row].ForEach([&](std::size_t col) {
+        if (static_cast<int>(col) != epsilon_) {
+          row[col] = prod;
         }
-        dep_graph_.at(symb).push_back(lhs);
-      }
-      rhs = follow_part;
-      symbol_index = std::find(rhs.begin(), rhs.end(), symb) - rhs.begin();
+      });
     }
   }
-  return follow_sets_[symb];
 }
 
-// When we calculate FOLLOW(A) for productions of the form B -> XA,
-// we do not add FOLLOW(B) to FOLLOW(A) right away, instead we add it to
-// a dependency graph. This function propagates those changes with a bfs on a
-// second pass, by adding all of As dependencies follow sets to its own follow
-// set.
-void ParserGenerator::ResolveDependencies(Symbol symb) {
-  std::set<Symbol> visited = {symb};
-  std::queue<Symbol> queue;
-  queue.push(symb);
-
-  while (!queue.empty()) {
-    Symbol tmp = queue.front();
-    queue.pop();
-
-    for (auto& neighbor : dep_graph_[tmp]) {
-      if (visited.find(neighbor) == visited.end()) {
-        visited.insert(neighbor);
-        queue.push(neighbor);
-
-        Set nei_follow = follow_sets_[neighbor];
-        follow_sets_[symb].insert(nei_follow.begin(), nei_follow.end());
-      }
+// Adds FIRST(rhs[begin:]) to first, leaving out EPSILON, from the first sets
+// computed so far. Returns true if rhs[begin:] can derive EPSILON.
+bool ParserGenerator::FirstSetOfRhs(const Rhs& rhs, std::size_t begin,
+                                    BitSet& first) {
+  for (std::size_t i = begin; i < rhs.size(); ++i) {
+    Symbol symb = rhs[i];
+    if (symb.Type() == SymbolType::EPSILON) {
+      return true;
+    }
+    // If it's a terminal, its first set is itself
+    if (symb.IsTerm()) {
+      first_used_[cols_[symb.Id()]] = true;
+      first.Insert(cols_[symb.Id()]);
+      return false;
+    }
+    const BitSet& first_of_cur = first_[rows_[symb.Id()]];
+    first.UnionWithout(first_of_cur, epsilon_);
+    // If there is no EPSILON, we're done
+    if (!first_of_cur.Contains(epsilon_)) {
+      return false;
     }
   }
+  return true;
+}
+
+// Returns the terminals in bits.
+Set ParserGenerator::ToSet(const BitSet& bits) const {
+  Set set;
+  bits.ForEach([&](std::size_t col) { set.insert(terms_[col]); });
+  return set;
 }
 
-}  // namespace toy
\ No newline at end of file
+}  // namespace toy
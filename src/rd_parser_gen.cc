@@ -0,0 +1,267 @@
+#include "rd_parser_gen.h"
+
+#include <cctype>
+#include <map>
+#include <vector>
+
+namespace toy {
+
+// Spellings of the TokenType enumerators, by token type.
+static const char* const TOKEN_TYPE_ENUMERATORS[] = {
+    "ID",         "INTNUM",    "FLOATNUM",   "EQ",          "NEQ",
+    "LT",         "GT",        "LEQ",        "GEQ",         "PLUS",
+    "MINUS",      "MULT",      "DIV",        "ASSGN",       "OPEN_PAR",
+    "CLOSE_PAR",  "OPEN_CBR",  "CLOSE_CBR",  "OPEN_SQBR",   "CLOSE_SQBR",
+    "SEMICOLON",  "COMMA",     "DOT",        "COLON",       "SCOPE_RES",
+    "IF",         "THEN",      "ELSE",       "WHILE",       "CLASS",
+    "INTEGER",    "FLOAT",     "DO",         "END",         "PUBLIC",
+    "PRIVATE",    "OR",        "AND",        "NOT",         "READ",
+    "WRITE",      "RETURN",    "MAIN",       "INHERITS",    "LOCAL",
+    "VOID",       "BLOCK_CMT", "INLINE_CMT", "INVALID_ID",  "INVALID_CHAR",
+    "INVALID_NUM", "UNTERMINATED_CMT", "EOS",
+};
+
+static const int NUM_TOKEN_TYPES = static_cast<int>(TokenType::EOS) + 1;
+
+static_assert(sizeof(TOKEN_TYPE_ENUMERATORS) /
+                      sizeof(TOKEN_TYPE_ENUMERATORS[0]) ==
+                  NUM_TOKEN_TYPES,
+              "Every token type needs an enumerator spelling");
+
+// Spellings of the NodeKind enumerators, by kind, NONE included.
+static const char* const NODE_KIND_ENUMERATORS[] = {
+#define TOY_NODE_KIND_ENUMERATOR(Kind, Node, name) #Kind,
+    TOY_AST_NODES(TOY_NODE_KIND_ENUMERATOR)
+#undef TOY_NODE_KIND_ENUMERATOR
+    "NONE",
+};
+
+static std::string NodeKindEnumerator(NodeKind kind) {
+  return std::string("NodeKind::") +
+         NODE_KIND_ENUMERATORS[static_cast<int>(kind)];
+}
+
+static void WriteString(std::ostream& os, const char* s) {
+  os << '"';
+  for (; *s; ++s) {
+    if (*s == '"' || *s == '\\') {
+      os << '\\';
+    }
+    os << *s;
+  }
+  os << '"';
+}
+
+RecursiveDescentGenerator::RecursiveDescentGenerator(const ParseTable& table)
+    : table_(table) {}
+
+void RecursiveDescentGenerator::WriteSource(std::ostream& os) const {
+  int begin = table_.NumTerms();
+  int end = table_.NumTerms() + table_.NumNonTerms();
+  os << "// Generated by gen_rd_parser. Do not edit.\n\n"
+     << "#include \"logger.h\"\n"
+     << "#include \"parser.h\"\n\n"
+     << "namespace toy {\n\n"
+     << "namespace {\n"
+     << "// Thrown to unwind the parse at the first syntax error.\n"
+     << "struct SyntaxError {};\n"
+     << "}  // namespace\n\n"
+     << "// One member function per non-terminal of the grammar, each one\n"
+     << "// parsing the non-terminal from the lookahead on.\n"
+     << "class RecursiveDescentParser {\n"
+     << " public:\n"
+     << "  explicit RecursiveDescentParser(Parser& parser)\n"
+     << "      : parser_(parser), tk_(parser.NextToken()) {}\n\n"
+     << "  void Parse() { " << FunctionName(table_.Start()) << "(); }\n\n"
+     << " private:\n"
+     << "  Parser& parser_;\n"
+     << "  Token tk_;  // Lookahead\n\n"
+     << "  void Next() {\n"
+     << "    parser_.prev_token_ = tk_;\n"
+     << "    tk_ = parser_.NextToken();\n"
+     << "  }\n\n"
+     << "  [[noreturn]] void Expected(const char* symb) {\n"
+     << "    Logger::Err(std::string(\"Expected '\") + symb +\n"
+     << "                    \"', but next token was '\" + tk_.Lexeme() + "
+        "\"'\",\n"
+     << "                tk_.Line(), ErrorType::SYNTAX);\n"
+     << "    throw SyntaxError();\n"
+     << "  }\n\n";
+  for (int non_term = begin; non_term < end; ++non_term) {
+    os << "  void " << FunctionName(non_term) << "();\n";
+  }
+  os << "};\n\n";
+  for (int non_term = begin; non_term < end; ++non_term) {
+    WriteFunction(os, non_term);
+  }
+  os << "std::shared_ptr<ASTNode> Parser::ParseRecursiveDescent() {\n"
+     << "  try {\n"
+     << "    RecursiveDescentParser(*this).Parse();\n"
+     << "  } catch (const SyntaxError&) {\n"
+     << "    ++num_errors_;\n"
+     << "    return nullptr;\n"
+     << "  }\n"
+     << "  if (HasNextToken()) {\n"
+     << "    return nullptr;\n"
+     << "  }\n"
+     << "  return Root();\n"
+     << "}\n\n"
+     << "}  // namespace toy\n";
+}
+
+// <aParamsTail> is parsed by AParamsTail().
+std::string RecursiveDescentGenerator::FunctionName(int non_term) const {
+  std::string name = table_.Name(non_term);
+  name = name.substr(1, name.size() - 2);
+  name[0] = std::toupper(name[0]);
+  return name;
+}
+
+// Productions ending with the non-terminal itself, as the grammar's
+// repetitions do, loop instead of recursing, so long lists do not use up
+// the call stack.
+void RecursiveDescentGenerator::WriteFunction(std::ostream& os,
+                                              int non_term) const {
+  // The lookaheads each production of the row is chosen on, in production
+  // order.
+  std::map<int, std::vector<int>> lookaheads;
+  bool loops = false;
+  for (int term = 0; term < table_.NumTerms(); ++term) {
+    int prod = table_.At(non_term, term);
+    if (prod == -1) {
+      continue;
+    }
+    lookaheads[prod].push_back(term);
+    const int16_t* rhs_end = table_.RhsEnd(prod);
+    loops |= rhs_end != table_.RhsBegin(prod) && rhs_end[-1] == non_term;
+  }
+
+  std::string indent = loops ? "    " : "  ";
+  os << "void RecursiveDescentParser::" << FunctionName(non_term) << "() {\n";
+  if (loops) {
+    os << "  for (;;) {\n";
+  }
+  os << indent << "switch (tk_.Type()) {\n";
+  for (const auto& entry : lookaheads) {
+    for (int term : entry.second) {
+      WriteCaseLabels(os << indent, term);
+    }
+    os << indent << "    // " << table_.Name(non_term) << " ::=";
+    for (const int16_t* s = table_.RhsBegin(entry.first);
+         s != table_.RhsEnd(entry.first); ++s) {
+      os << " " << table_.Name(*s);
+    }
+    os << "\n";
+    WriteProduction(os, indent + "    ", non_term, entry.first);
+  }
+  os << indent << "  default:\n"
+     << indent << "    Expected(";
+  WriteString(os, table_.Name(non_term));
+  os << ");\n"
+     << indent << "}\n";
+  if (loops) {
+    os << "  }\n";
+  }
+  os << "}\n\n";
+}
+
+void RecursiveDescentGenerator::WriteProduction(std::ostream& os,
+                                                const std::string& indent,
+                                                int non_term,
+                                                int prod) const {
+  const int16_t* begin = table_.RhsBegin(prod);
+  const int16_t* end = table_.RhsEnd(prod);
+  bool loops = begin != end && end[-1] == non_term;
+  // Whether no token was consumed yet, so that the lookahead is still the
+  // one the case labels matched.
+  bool at_lookahead = true;
+  for (const int16_t* s = begin; s != (loops ? end - 1 : end); ++s) {
+    if (*s == table_.Epsilon()) {
+      continue;
+    }
+    if (table_.IsTerm(*s)) {
+      if (at_lookahead) {
+        os << indent << "Next();  // " << table_.Name(*s) << "\n";
+      } else {
+        WriteMatch(os, indent, *s);
+      }
+      at_lookahead = false;
+    } else if (table_.IsNonTerm(*s)) {
+      os << indent << FunctionName(*s) << "();\n";
+      at_lookahead = false;
+    } else {
+      WriteAction(os, indent, *s);
+    }
+  }
+  os << indent << (loops ? "continue;\n" : "return;\n");
+}
+
+// Writes a case label for every token type matched by term.
+void RecursiveDescentGenerator::WriteCaseLabels(std::ostream& os,
+                                                int term) const {
+  bool first = true;
+  for (int type = 0; type < NUM_TOKEN_TYPES; ++type) {
+    if (table_.TermOf(static_cast<TokenType>(type)) == term) {
+      os << (first ? "" : "\n") << "  case TokenType::"
+         << TOKEN_TYPE_ENUMERATORS[type] << ":";
+      first = false;
+    }
+  }
+  os << (first ? "  // No token matches " + std::string(table_.Name(term))
+               : std::string())
+     << "\n";
+}
+
+// Writes a check that the lookahead is term, followed by moving past it.
+void RecursiveDescentGenerator::WriteMatch(std::ostream& os,
+                                           const std::string& indent,
+                                           int term) const {
+  std::string cond;
+  for (int type = 0; type < NUM_TOKEN_TYPES; ++type) {
+    if (table_.TermOf(static_cast<TokenType>(type)) == term) {
+      cond += std::string(cond.empty() ? "" : " && ") +
+              "tk_.Type() != TokenType::" + TOKEN_TYPE_ENUMERATORS[type];
+    }
+  }
+  os << indent << "if (" << (cond.empty() ? "true" : cond) << ") {\n"
+     << indent << "  Expected(";
+  WriteString(os, table_.Name(term));
+  os << ");\n"
+     << indent << "}\n"
+     << indent << "Next();\n";
+}
+
+void RecursiveDescentGenerator::WriteAction(std::ostream& os,
+                                            const std::string& indent,
+                                            int action) const {
+  const SemanticAction& act = table_.Action(action);
+  os << indent;
+  switch (act.type) {
+    case ActionType::START:
+      os << "parser_.StartAction();";
+      break;
+    case ActionType::END:
+      os << "parser_.EndAction(" << NodeKindEnumerator(act.node_kind) << ");";
+      break;
+    case ActionType::PUSH:
+      os << "parser_.PushAction(" << NodeKindEnumerator(act.node_kind)
+         << ");";
+      break;
+    case ActionType::OP:
+      os << "parser_.OpAction();";
+      break;
+    case ActionType::END_SIGN:
+      os << "parser_.EndSignAction();";
+      break;
+    case ActionType::END_SCOPERES:
+      os << "parser_.EndScopeResAction("
+         << NodeKindEnumerator(act.node_kind) << ");";
+      break;
+    case ActionType::NONE:
+      break;
+  }
+  os << (act.type == ActionType::NONE ? "// " : "  // ")
+     << table_.Name(action) << "\n";
+}
+
+}  // namespace toy
@@ -0,0 +1,94 @@
+#include "source_buffer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace toy {
+
+SourceBuffer SourceBuffer::FromFile(const std::string& filepath) {
+  int fd = open(filepath.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::runtime_error("Cannot open source file " + filepath);
+  }
+  SourceBuffer buf;
+  struct stat st;
+  long page_size = sysconf(_SC_PAGESIZE);
+  // The bytes between the end of the file and the end of its last page are
+  // zero-filled by mmap, which gives us the sentinel for free. A file that
+  // exactly fills its last page has no room for one, so it is read instead.
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+      page_size > 0 && st.st_size % page_size != 0) {
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map != MAP_FAILED) {
+      buf.map_ = map;
+      buf.map_size_ = st.st_size;
+      buf.data_ = static_cast<const char*>(map);
+      buf.size_ = st.st_size;
+    }
+  }
+  close(fd);
+  if (buf.map_) {
+    return buf;
+  }
+  std::ifstream ifs(filepath, std::ios::binary);
+  if (!ifs.good()) {
+    throw std::runtime_error("Cannot open source file " + filepath);
+  }
+  std::ostringstream oss;
+  oss << ifs.rdbuf();
+  return FromString(oss.str());
+}
+
+SourceBuffer SourceBuffer::FromString(std::string text) {
+  SourceBuffer buf;
+  buf.text_ = std::move(text);
+  buf.data_ = buf.text_.c_str();
+  buf.size_ = buf.text_.size();
+  return buf;
+}
+
+SourceBuffer::SourceBuffer(SourceBuffer&& other) noexcept {
+  *this = std::move(other);
+}
+
+SourceBuffer& SourceBuffer::operator=(SourceBuffer&& other) noexcept {
+  if (this != &other) {
+    Release();
+    map_ = other.map_;
+    map_size_ = other.map_size_;
+    size_ = other.size_;
+    text_ = std::move(other.text_);
+    // Short strings live inside the string object itself, so the data
+    // pointer has to be re-derived after the move.
+    data_ = map_ ? other.data_ : text_.c_str();
+    other.map_ = nullptr;
+    other.map_size_ = 0;
+    other.text_.clear();
+    other.data_ = other.text_.c_str();
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+SourceBuffer::~SourceBuffer() { Release(); }
+
+const char* SourceBuffer::Data() const { return data_; }
+
+std::size_t SourceBuffer::Size() const { return size_; }
+
+void SourceBuffer::Release() {
+  if (map_) {
+    munmap(map_, map_size_);
+    map_ = nullptr;
+    map_size_ = 0;
+  }
+}
+
+}  // namespace toy
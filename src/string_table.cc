@@ -0,0 +1,87 @@
+#include "string_table.h"
+
+#include <cstring>
+
+namespace toy {
+
+static const std::size_t INITIAL_SLOTS = 256;
+
+StringTable::StringTable() : slots_(INITIAL_SLOTS, Slot{0, 0}) {}
+
+const std::string* StringTable::Intern(const char* s, std::size_t len) {
+  uint32_t hash = Hash(s, len);
+  std::size_t mask = slots_.size() - 1;
+  for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+    Slot& slot = slots_[i];
+    if (slot.idx == 0) {
+      strings_.emplace_back(s, len);
+      slot.hash = hash;
+      slot.idx = strings_.size();
+      const std::string* interned = &strings_.back();
+      // Keep the load factor at or below 1/2 so probe sequences stay short.
+      if (strings_.size() * 2 > slots_.size()) {
+        Grow();
+      }
+      return interned;
+    }
+    const std::string& str = strings_[slot.idx - 1];
+    if (slot.hash == hash && str.size() == len &&
+        std::memcmp(str.data(), s, len) == 0) {
+      return &str;
+    }
+  }
+}
+
+const std::string* StringTable::Intern(const std::string& s) {
+  return Intern(s.data(), s.size());
+}
+
+const std::string* StringTable::Find(const std::string& s) const {
+  uint32_t hash = Hash(s.data(), s.size());
+  std::size_t mask = slots_.size() - 1;
+  for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+    const Slot& slot = slots_[i];
+    if (slot.idx == 0) {
+      return nullptr;
+    }
+    const std::string& str = strings_[slot.idx - 1];
+    if (slot.hash == hash && str == s) {
+      return &str;
+    }
+  }
+}
+
+std::size_t StringTable::Size() const { return strings_.size(); }
+
+StringTable& StringTable::Default() {
+  static StringTable table;
+  return table;
+}
+
+// 32-bit FNV-1a.
+uint32_t StringTable::Hash(const char* s, std::size_t len) {
+  uint32_t hash = 2166136261u;
+  for (std::size_t i = 0; i < len; ++i) {
+    hash ^= static_cast<unsigned char>(s[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+void StringTable::Grow() {
+  std::vector<Slot> slots(slots_.size() * 2, Slot{0, 0});
+  std::size_t mask = slots.size() - 1;
+  for (const Slot& slot : slots_) {
+    if (slot.idx == 0) {
+      continue;
+    }
+    std::size_t i = slot.hash & mask;
+    while (slots[i].idx != 0) {
+      i = (i + 1) & mask;
+    }
+    slots[i] = slot;
+  }
+  slots_.swap(slots);
+}
+
+}  // namespace toy
@@ -1,14 +1,45 @@
 #include "symbol_table.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <iomanip>
+#include <stdexcept>
 
 #include "logger.h"
 
 namespace toy {
 
+static const std::size_t INITIAL_SLOTS = 8;
+
+const char* EntryKindName(EntryKind kind) {
+  switch (kind) {
+    case EntryKind::CLASS:
+      return "class";
+    case EntryKind::FUNC:
+      return "func";
+    case EntryKind::INHERIT:
+      return "inherit";
+    case EntryKind::LOCAL:
+      return "local";
+    case EntryKind::MEMBER_FUNC:
+      return "memberFunc";
+    case EntryKind::MEMBER_VAR:
+      return "memberVar";
+  }
+  return "";
+}
+
 SymbolTable::SymbolTable(std::string name, std::shared_ptr<SymbolTable> parent,
                          int level)
-    : name_(name), level_(level), parent_(parent), table_({}){};
+    : name_(name),
+      level_(level),
+      parent_(parent),
+      shared_(parent != nullptr ? parent->shared_ : std::make_shared<Shared>()),
+      slots_(INITIAL_SLOTS, Slot()) {
+  if (parent != nullptr) {
+    parent->has_children_ = true;
+  }
+};
 
 std::string SymbolTable::Name() const { return name_; }
 int SymbolTable::Level() const { return level_; }
@@ -18,62 +49,248 @@ int SymbolTable::ScopeSize() const { return mem_size_; }
 void SymbolTable::SetName(std::string name) { name_ = name; }
 void SymbolTable::SetParent(std::shared_ptr<SymbolTable> parent) {
   parent_ = parent;
+  ++shared_->generation;
+  if (parent == nullptr) {
+    return;
+  }
+  parent->has_children_ = true;
+  // The lookups up the chain of tables need the same interned strings
+  if (parent->shared_ != shared_) {
+    // The keys point into the strings of the old table until re-interned
+    for (auto& key : keys_) {
+      key = parent->shared_->symbols.Intern(*key);
+    }
+    shared_ = parent->shared_;
+    RebuildIndex();
+  }
 }
 void SymbolTable::SetScopeSize(int mem_size) { mem_size_ = mem_size; }
+void SymbolTable::SetConcurrent(bool concurrent) {
+  shared_->concurrent = concurrent;
+}
+void SymbolTable::InternName(const std::string& name) {
+  shared_->symbols.Intern(name);
+}
 void SymbolTable::IncrementLevel() { level_++; }
 
-SymTabIt SymbolTable::Begin() { return table_.begin(); }
-SymTabIt SymbolTable::End() { return table_.end(); }
+SymTabIt SymbolTable::Begin() {
+  Sorted();
+  return sorted_.begin();
+}
+SymTabIt SymbolTable::End() {
+  Sorted();
+  return sorted_.end();
+}
+
+const std::vector<std::shared_ptr<toy::Entry>>& SymbolTable::Sorted() const {
+  if (sorted_.size() == entries_.size()) {
+    return sorted_;
+  }
+  std::vector<uint32_t> order(entries_.size());
+  for (uint32_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+    EntryKind kind_a = entries_[a]->Kind();
+    EntryKind kind_b = entries_[b]->Kind();
+    return kind_a != kind_b ? kind_a < kind_b : *keys_[a] < *keys_[b];
+  });
+  sorted_.clear();
+  for (uint32_t i : order) {
+    sorted_.push_back(entries_[i]);
+  }
+  return sorted_;
+}
 
 void SymbolTable::RemoveMemberFunctionDefinitions() {
-  for (auto it = table_.begin(); it != table_.end();) {
-    auto entry = it->second;
-    if (entry->Kind() == "func" &&
-        std::static_pointer_cast<FreeFuncEntry>(entry)->Scope().length() > 0) {
-      it = table_.erase(it);
-    } else {
-      it++;
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < entries_.size(); ++i) {
+    auto freefunc = EntryCast<FreeFuncEntry>(entries_[i]);
+    if (freefunc == nullptr || freefunc->Scope().length() == 0) {
+      entries_[kept] = entries_[i];
+      keys_[kept] = keys_[i];
+      ++kept;
     }
   }
+  if (kept < entries_.size()) {
+    entries_.resize(kept);
+    keys_.resize(kept);
+    sorted_.clear();
+    RebuildIndex();
+  }
 }
 
 // Get an entry for the given identifier by searching up
 // the chain of tables, starting from the current table
 std::shared_ptr<toy::Entry> SymbolTable::GetEntry(
-    const std::string& kind, const std::string& name) const {
-  auto id = std::make_pair(kind, name);
-  for (auto symtab = shared_from_this(); symtab != nullptr;
-       symtab = symtab->parent_) {
-    if (symtab->table_.find(id) != symtab->table_.end()) {
-      return symtab->table_.at(id);
-    }
+    EntryKind kind, const std::string& name) const {
+  // Whatever was never interned is in none of the tables
+  const std::string* name_sym = shared_->symbols.Find(name);
+  if (name_sym == nullptr) {
+    return nullptr;
   }
-  return nullptr;
+  return Lookup(kind, false, name_sym);
 }
 
 // Get an entry for the given identifier by searching up
 // the chain of tables, starting from the current table
 std::shared_ptr<toy::Entry> SymbolTable::GetEntry(
     const std::string& name) const {
-  for (auto symtab = shared_from_this(); symtab != nullptr;
-       symtab = symtab->parent_) {
-    for (auto p : symtab->table_) {
-      if (p.first.second == name) {
-        return p.second;
-      }
+  const std::string* name_sym = shared_->symbols.Find(name);
+  if (name_sym == nullptr) {
+    return nullptr;
+  }
+  return Lookup(EntryKind(), true, name_sym);
+}
+
+// Returns the own entry for the key, else the one of the enclosing tables,
+// caching where it was found
+std::shared_ptr<toy::Entry> SymbolTable::Lookup(
+    EntryKind kind, bool by_name, const std::string* name) const {
+  bool caching = !shared_->concurrent;
+  if (caching && (num_slots_used_ + 1) * 2 > slots_.size()) {
+    Grow();
+  }
+  Slot& slot = SlotFor(kind, by_name, name);
+  if (slot.name == nullptr || (slot.generation != 0 &&
+                               slot.generation != shared_->generation)) {
+    const Slot* found = nullptr;
+    for (const SymbolTable* symtab = parent_.get();
+         symtab != nullptr && found == nullptr;
+         symtab = symtab->parent_.get()) {
+      found = symtab->FindOwn(kind, by_name, name);
+    }
+    // Only read the tables, other threads may be looking them up too
+    if (!caching) {
+      return found != nullptr ? found->table->entries_[found->index] : nullptr;
+    }
+    if (slot.name == nullptr) {
+      ++num_slots_used_;
+    }
+    slot = found != nullptr ? *found : Slot{name, nullptr, 0, 0, kind, by_name};
+    slot.generation = shared_->generation;
+  }
+  return slot.table != nullptr ? slot.table->entries_[slot.index] : nullptr;
+}
+
+static std::size_t HashKey(EntryKind kind, bool by_name,
+                           const std::string* name) {
+  // Murmur3 finalizer, interned strings are close together in memory
+  uint64_t hash = reinterpret_cast<uintptr_t>(name) * 31 +
+                  (by_name ? 0xff : static_cast<int>(kind));
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// Returns the slot of the own entry for the key, or nullptr
+const SymbolTable::Slot* SymbolTable::FindOwn(EntryKind kind, bool by_name,
+                                              const std::string* name) const {
+  const Slot& slot = SlotFor(kind, by_name, name);
+  return slot.name != nullptr && slot.generation == 0 ? &slot : nullptr;
+}
+
+// Returns the slot of the key, or the empty slot it goes in. The kind is
+// ignored for the name alone.
+SymbolTable::Slot& SymbolTable::SlotFor(EntryKind kind, bool by_name,
+                                        const std::string* name) const {
+  std::size_t mask = slots_.size() - 1;
+  for (std::size_t i = HashKey(kind, by_name, name) & mask;;
+       i = (i + 1) & mask) {
+    Slot& slot = slots_[i];
+    if (slot.name == nullptr ||
+        (slot.name == name && slot.by_name == by_name &&
+         (by_name || slot.kind == kind))) {
+      return slot;
+    }
+  }
+}
+
+bool SymbolTable::Contains(const EntryId& id) const {
+  const std::string* name_sym = shared_->symbols.Find(id.second);
+  return name_sym != nullptr && FindOwn(id.first, false, name_sym) != nullptr;
+}
+
+// Adds the entry unless there is one with the same id already
+void SymbolTable::Insert(const EntryId& id,
+                         std::shared_ptr<toy::Entry> entry) {
+  const std::string* key = shared_->symbols.Find(id.second);
+  if (key != nullptr && FindOwn(id.first, false, key) != nullptr) {
+    return;
+  }
+  if (key == nullptr) {
+    // Interning adds to the strings other threads may be reading
+    if (shared_->concurrent) {
+      throw std::logic_error("Name '" + id.second + "' interned concurrently");
+    }
+    key = shared_->symbols.Intern(id.second);
+  }
+  entries_.push_back(entry);
+  keys_.push_back(key);
+  sorted_.clear();
+  Index(entries_.size() - 1);
+  Changed();
+}
+
+// Adds the slots of the entry at index, by kind and name and by name alone,
+// in place of the cached lookups for them
+void SymbolTable::Index(uint32_t index) {
+  // Keep the load factor at or below 1/2 so probe sequences stay short.
+  if ((num_slots_used_ + 2) * 2 > slots_.size()) {
+    Grow();
+  }
+  EntryKind kind = entries_[index]->Kind();
+  const std::string* name = keys_[index];
+  Slot& by_kind = SlotFor(kind, false, name);
+  if (by_kind.name == nullptr) {
+    ++num_slots_used_;
+  }
+  by_kind = Slot{name, this, 0, index, kind, false};
+  Slot& by_name = SlotFor(kind, true, name);
+  if (by_name.name == nullptr) {
+    ++num_slots_used_;
+  }
+  if (by_name.name == nullptr || by_name.generation != 0 ||
+      kind < by_name.kind) {
+    by_name = Slot{name, this, 0, index, kind, true};
+  }
+}
+
+void SymbolTable::Grow() const {
+  std::vector<Slot> slots(slots_.size() * 2, Slot());
+  slots_.swap(slots);
+  for (const Slot& slot : slots) {
+    if (slot.name != nullptr) {
+      SlotFor(slot.kind, slot.by_name, slot.name) = slot;
     }
   }
-  return nullptr;
+}
+
+// Drops the cached lookups along with the index
+void SymbolTable::RebuildIndex() {
+  slots_.assign(INITIAL_SLOTS, Slot());
+  num_slots_used_ = 0;
+  for (uint32_t i = 0; i < entries_.size(); ++i) {
+    Index(i);
+  }
+  Changed();
+}
+
+void SymbolTable::Changed() {
+  if (has_children_) {
+    ++shared_->generation;
+  }
 }
 
 void SymbolTable::AddEntry(std::shared_ptr<LocalVarEntry> entry) {
   auto id = std::make_pair(entry->Kind(), entry->Name());
-  if (table_.find(id) != table_.end()) {
+  if (Contains(id)) {
     Logger::Err("Variable '" + id.second + "' already declared in scope '" +
                     name_ + "'",
                 entry->Line(), ErrorType::SEMANTIC);
   } else {
-    table_.insert({id, entry});
+    Insert(id, entry);
   }
 }
 
@@ -81,22 +298,20 @@ void SymbolTable::AddEntry(std::shared_ptr<LocalVarEntry> entry) {
 // but also that it doesn't shadow an inherited member
 void SymbolTable::AddEntry(std::shared_ptr<MemberVarEntry> entry) {
   auto id = std::make_pair(entry->Kind(), entry->Name());
-  if (table_.find(id) != table_.end()) {
-    auto found_entry = table_.at(id);
-    std::string class_name =
-        std::dynamic_pointer_cast<MemberVarEntry>(entry)->Class();
+  if (Contains(id)) {
+    std::string class_name = entry->Class();
     if (name_ != class_name) {
       Logger::Warn("Shadowed member variable '" + id.second + "' in '" + name_ +
                        "' already declared in '" + class_name + "'",
                    entry->Line(), WarningType::SEMANTIC);
-      table_.insert({id, entry});
+      Insert(id, entry);
     } else {
       Logger::Err("Member variable '" + id.second + "' already declared in '" +
                       name_ + "'",
                   entry->Line(), ErrorType::SEMANTIC);
     }
   } else {
-    table_.insert({id, entry});
+    Insert(id, entry);
   }
 }
 
@@ -106,7 +321,7 @@ void SymbolTable::AddEntry(std::shared_ptr<FreeFuncEntry> entry) {
   auto id = std::make_pair(entry->Kind(), func_signature);
   if (funcs_.find(func_name) != funcs_.end()) {
     // Found function with same signature
-    if (table_.find(id) != table_.end()) {
+    if (Contains(id)) {
       Logger::Err("Free function '" + func_signature +
                       "' already declared in '" + name_ + "'",
                   entry->Line(), ErrorType::SEMANTIC);
@@ -118,9 +333,9 @@ void SymbolTable::AddEntry(std::shared_ptr<FreeFuncEntry> entry) {
           entry->Line(), WarningType::SEMANTIC);
     }
   }
-  if (table_.find(id) == table_.end()) {
+  if (!Contains(id)) {
     funcs_.insert(func_name);
-    table_.insert({id, entry});
+    Insert(id, entry);
   }
 };
 
@@ -130,15 +345,13 @@ void SymbolTable::AddEntry(std::shared_ptr<MemberFuncEntry> entry) {
 
   auto id = std::make_pair(entry->Kind(), func_signature);
   if (funcs_.find(func_name) != funcs_.end()) {
-    if (table_.find(id) != table_.end()) {
-      auto found_entry = table_.at(id);
-      std::string class_name =
-          std::dynamic_pointer_cast<MemberFuncEntry>(entry)->Class();
+    if (Contains(id)) {
+      std::string class_name = entry->Class();
       if (name_ != class_name) {
         Logger::Warn("Shadowed member function '" + id.second + "' in '" +
                          name_ + "' already declared in '" + class_name + "'",
                      entry->Line(), WarningType::SEMANTIC);
-        table_.insert({id, entry});
+        Insert(id, entry);
       } else {
         Logger::Err("Member function '" + id.second +
                         "' already declared in '" + name_ + "'",
@@ -148,28 +361,28 @@ void SymbolTable::AddEntry(std::shared_ptr<MemberFuncEntry> entry) {
       Logger::Warn("Overloaded member function '" + func_signature + "' in '" +
                        name_ + "'",
                    entry->Line(), WarningType::SEMANTIC);
-      table_.insert({id, entry});
+      Insert(id, entry);
     }
 
   } else {
     funcs_.insert(func_name);
-    table_.insert({id, entry});
+    Insert(id, entry);
   }
 };
 
 void SymbolTable::AddEntry(std::shared_ptr<ClassEntry> entry) {
   auto id = std::make_pair(entry->Kind(), entry->Name());
-  if (table_.find(id) != table_.end()) {
+  if (Contains(id)) {
     Logger::Err("Class '" + id.second + "' already declared in '" + name_ + "'",
                 entry->Line(), ErrorType::SEMANTIC);
   } else {
-    table_.insert({id, entry});
+    Insert(id, entry);
   }
 };
 
 void SymbolTable::AddEntry(std::shared_ptr<InheritEntry> entry) {
   auto id = std::make_pair(entry->Kind(), entry->Name());
-  table_.insert({id, entry});
+  Insert(id, entry);
 };
 
 // A function's signature includes the function's name and the number,
@@ -204,59 +417,77 @@ std::ostream& operator<<(std::ostream& os, const SymbolTable& symtab) {
   os << std::right << std::setw(16) << s2 << std::right << std::setw(3) << "|";
   os << "\n" << prelinespacing + header + "\n";
 
-  for (auto it = symtab.table_.begin(); it != symtab.table_.end(); it++) {
-    os << prelinespacing << *it->second << std::endl;
+  for (auto& entry : symtab.Sorted()) {
+    os << prelinespacing << *entry << std::endl;
   }
   os << prelinespacing + header;
   return os;
 }
 
-Entry::Entry(std::string kind, std::string name, std::string type, int line,
+Entry::Entry(EntryKind kind, std::string name, std::string type, int line,
              std::shared_ptr<SymbolTable> link)
     : kind_(kind), name_(name), type_(type), line_(line), link_(link){};
 
-std::string Entry::Kind() const { return kind_; }
+EntryKind Entry::Kind() const { return kind_; }
 std::string Entry::Name() const { return name_; }
 std::string Entry::Type() const { return type_; }
 int Entry::Line() const { return line_; }
-std::vector<std::string> Entry::Dims() const { return {}; }
 std::shared_ptr<SymbolTable> Entry::Link() const { return link_; }
-void Entry::SetKind(std::string kind) { kind_ = kind; }
 void Entry::SetName(std::string name) { name_ = name; }
 void Entry::SetType(std::string type) { type_ = type; }
 void Entry::SetLink(std::shared_ptr<SymbolTable> link) { link_ = link; }
 
+std::vector<std::string> Entry::Dims() const {
+  switch (kind_) {
+    case EntryKind::LOCAL:
+      return static_cast<const LocalVarEntry*>(this)->Dims();
+    case EntryKind::MEMBER_VAR:
+      return static_cast<const MemberVarEntry*>(this)->Dims();
+    default:
+      return {};
+  }
+}
+
 std::ostream& operator<<(std::ostream& os, const Entry& entry) {
   entry.Print(os);
   return os;
 }
 
 void Entry::Print(std::ostream& os) const {
-  std::string s = "| " + kind_;
-  os << std::left << std::setw(20) << s;
-  s = "| " + name_;
-  os << std::left << std::setw(20) << s;
-  s = "| " + type_;
-  os << std::left << std::setw(20) << s;
-  s = "| " + std::to_string(size);
-  os << std::left << std::setw(5) << s;
-  s = "| " + std::to_string(offset) + " |";
-  os << std::setw(5) << s;
-  if (link_ != nullptr) {
-    os << *link_;
+  switch (kind_) {
+    case EntryKind::CLASS:
+      static_cast<const ClassEntry*>(this)->Print(os);
+      break;
+    case EntryKind::FUNC:
+      static_cast<const FreeFuncEntry*>(this)->Print(os);
+      break;
+    case EntryKind::INHERIT:
+      static_cast<const InheritEntry*>(this)->Print(os);
+      break;
+    case EntryKind::LOCAL:
+      static_cast<const LocalVarEntry*>(this)->Print(os);
+      break;
+    case EntryKind::MEMBER_FUNC:
+      static_cast<const MemberFuncEntry*>(this)->Print(os);
+      break;
+    case EntryKind::MEMBER_VAR:
+      static_cast<const MemberVarEntry*>(this)->Print(os);
+      break;
   }
 }
 
 LocalVarEntry::LocalVarEntry(std::string name, std::string type, int line,
                              std::shared_ptr<SymbolTable> link,
                              std::vector<std::string> dims)
-    : Entry("local", name, type, line, link), dims_(dims) {}
+    : Entry(KIND, name, type, line, link), dims_(dims) {}
 
-std::vector<std::string> LocalVarEntry::Dims() const { return dims_; }
+const std::vector<std::string>& LocalVarEntry::Dims() const {
+  return dims_;
+}
 void LocalVarEntry::SetDims(std::vector<std::string> dims) { dims_ = dims; }
 
 void LocalVarEntry::Print(std::ostream& os) const {
-  std::string s = "| " + kind_;
+  std::string s = std::string("| ") + EntryKindName(kind_);
   os << std::left << std::setw(11) << s;
   s = "| " + name_;
   os << std::left << std::setw(22) << s;
@@ -276,12 +507,14 @@ MemberVarEntry::MemberVarEntry(std::string name, std::string type, int line,
                                std::shared_ptr<SymbolTable> link,
                                std::vector<std::string> dims, std::string cls,
                                std::string visibility)
-    : Entry("memberVar", name, type, line, link),
+    : Entry(KIND, name, type, line, link),
       dims_(dims),
       cls_(cls),
       visibility_(visibility) {}
 
-std::vector<std::string> MemberVarEntry::Dims() const { return dims_; }
+const std::vector<std::string>& MemberVarEntry::Dims() const {
+  return dims_;
+}
 std::string MemberVarEntry::Class() { return cls_; }
 std::string MemberVarEntry::Visibility() { return visibility_; }
 void MemberVarEntry::SetDims(std::vector<std::string> dims) { dims_ = dims; }
@@ -291,7 +524,7 @@ void MemberVarEntry::SetVisibility(std::string visibility) {
 }
 
 void MemberVarEntry::Print(std::ostream& os) const {
-  std::string s = "| " + kind_;
+  std::string s = std::string("| ") + EntryKindName(kind_);
   os << std::left << std::setw(13) << s;
   s = "| " + name_;
   os << std::left << std::setw(15) << s;
@@ -313,7 +546,7 @@ FreeFuncEntry::FreeFuncEntry(
     std::string name, std::string type, int line,
     std::shared_ptr<SymbolTable> link,
     std::vector<std::pair<std::string, std::string>> params, std::string scope)
-    : Entry("func", name, type, line, link), params_(params), scope_(scope) {
+    : Entry(KIND, name, type, line, link), params_(params), scope_(scope) {
   std::vector<std::string> param_types;
   for (auto param : params) {
     param_types.push_back(param.second);
@@ -321,11 +554,12 @@ FreeFuncEntry::FreeFuncEntry(
   signature_ = SymbolTable::GetFuncSignature(scope, name, param_types);
 };
 
-std::vector<std::pair<std::string, std::string>> FreeFuncEntry::Params() {
+const std::vector<std::pair<std::string, std::string>>&
+FreeFuncEntry::Params() const {
   return params_;
 }
 std::string FreeFuncEntry::Scope() { return scope_; }
-std::string FreeFuncEntry::Signature() { return signature_; }
+std::string FreeFuncEntry::Signature() const { return signature_; }
 
 void FreeFuncEntry::SetParams(
     std::vector<std::pair<std::string, std::string>> params) {
@@ -334,7 +568,7 @@ void FreeFuncEntry::SetParams(
 void FreeFuncEntry::SetScope(std::string scope) { scope_ = scope; }
 
 void FreeFuncEntry::Print(std::ostream& os) const {
-  std::string s = "| " + kind_;
+  std::string s = std::string("| ") + EntryKindName(kind_);
   os << std::left << std::setw(8) << s;
   s = "| " + signature_ + " -> " + type_;
   os << std::left << std::setw(61) << s << "|";
@@ -348,7 +582,7 @@ MemberFuncEntry::MemberFuncEntry(
     std::shared_ptr<SymbolTable> link,
     std::vector<std::pair<std::string, std::string>> params, std::string cls,
     std::string visibility)
-    : Entry("memberFunc", name, type, line, link),
+    : Entry(KIND, name, type, line, link),
       params_(params),
       cls_(cls),
       visibility_(visibility) {
@@ -359,7 +593,8 @@ MemberFuncEntry::MemberFuncEntry(
   signature_ = SymbolTable::GetFuncSignature(cls, name, param_types);
 };
 
-std::vector<std::pair<std::string, std::string>> MemberFuncEntry::Params() {
+const std::vector<std::pair<std::string, std::string>>&
+MemberFuncEntry::Params() const {
   return params_;
 }
 std::string MemberFuncEntry::Class() { return cls_; }
@@ -375,7 +610,7 @@ void MemberFuncEntry::SetVisibility(std::string visibility) {
 }
 
 void MemberFuncEntry::Print(std::ostream& os) const {
-  std::string s = "| " + kind_;
+  std::string s = std::string("| ") + EntryKindName(kind_);
   os << std::left << std::setw(15) << s;
   s = "| " + visibility_;
   os << std::left << std::setw(10) << s;
@@ -389,10 +624,10 @@ void MemberFuncEntry::Print(std::ostream& os) const {
 
 ClassEntry::ClassEntry(std::string name, int line,
                        std::shared_ptr<SymbolTable> link)
-    : Entry("class", name, name, line, link){};
+    : Entry(KIND, name, name, line, link){};
 
 void ClassEntry::Print(std::ostream& os) const {
-  std::string s = "| " + kind_;
+  std::string s = std::string("| ") + EntryKindName(kind_);
   os << std::left << std::setw(8) << s;
   s = "| " + name_;
   os << std::left << std::setw(22) << s;
@@ -404,13 +639,13 @@ void ClassEntry::Print(std::ostream& os) const {
 }
 
 InheritEntry::InheritEntry(std::vector<std::string> inherit_list)
-    : Entry("inherit", "inherit", "", 0, nullptr),
+    : Entry(KIND, "inherit", "", 0, nullptr),
       inherit_list_(inherit_list){};
 
 std::vector<std::string> InheritEntry::InheritList() { return inherit_list_; }
 
 void InheritEntry::Print(std::ostream& os) const {
-  std::string s = "| " + kind_;
+  std::string s = std::string("| ") + EntryKindName(kind_);
   os << std::left << std::setw(15) << s;
   s = "";
   if (inherit_list_.size() == 0) {
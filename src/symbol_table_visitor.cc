@@ -68,7 +68,7 @@ std::vector<std::string> SymbolTableVisitor::TSort() {
 void SymbolTableVisitor::CheckUndefinedMemberFunctions(
     SymbolTable& symtab, std::vector<std::string> sorted_classes) {
   for (auto& class_name : sorted_classes) {
-    auto class_entry = symtab.GetEntry("class", class_name);
+    auto class_entry = symtab.GetEntry(EntryKind::CLASS, class_name);
     if (!class_entry) {
       Logger::Err("Inherited class '" + class_name + "' not defined",
                   ErrorType::SEMANTIC);
@@ -77,14 +77,14 @@ void SymbolTableVisitor::CheckUndefinedMemberFunctions(
     auto class_tab = class_entry->Link();
     for (auto it = class_tab->Begin(); it != class_tab->End(); ++it) {
       // Link to the corresponding function
-      if (it->first.first == "memberFunc") {
-        auto entry = std::dynamic_pointer_cast<MemberFuncEntry>(it->second);
+      if ((*it)->Kind() == EntryKind::MEMBER_FUNC) {
+        auto entry = std::static_pointer_cast<MemberFuncEntry>(*it);
         std::string func_signature = entry->Signature();
-        auto found_entry = symtab.GetEntry("func", func_signature);
+        auto found_entry = symtab.GetEntry(EntryKind::FUNC, func_signature);
         if (!found_entry) {
           Logger::Err(
               "Declared function '" + func_signature + "' has no definition",
-              it->second->Line(), ErrorType::SEMANTIC);
+              (*it)->Line(), ErrorType::SEMANTIC);
         }
       }
     }
@@ -94,19 +94,20 @@ void SymbolTableVisitor::CheckUndefinedMemberFunctions(
 void SymbolTableVisitor::LinkMemberFunctionDefsToDecl(
     SymbolTable& symtab, std::vector<std::string> sorted_classes) {
   for (auto it = symtab.Begin(); it != symtab.End(); ++it) {
-    auto entry = it->second;
-    if (entry->Kind() == "func" && entry->Name() != "main") {
+    auto entry = *it;
+    if (entry->Kind() == EntryKind::FUNC && entry->Name() != "main") {
       auto freefunc = std::static_pointer_cast<FreeFuncEntry>(entry);
       std::string scoperes = freefunc->Scope();
       if (scoperes != "") {
         // Attempt to find the class that matches the scoperes.
-        auto class_entry = symtab.GetEntry("class", scoperes);
+        auto class_entry = symtab.GetEntry(EntryKind::CLASS, scoperes);
         if (class_entry) {
           auto func_entry = class_entry->Link()->GetEntry(
-              "memberFunc", freefunc->Signature());
+              EntryKind::MEMBER_FUNC, freefunc->Signature());
           if (func_entry) {
             freefunc->Link()->SetParent(class_entry->Link());
             func_entry->SetLink(freefunc->Link());
+            func_entry->func = freefunc->func;
             func_entry->Link()->IncrementLevel();
             entry = nullptr;
           } else {
@@ -128,7 +129,7 @@ void SymbolTableVisitor::LinkMemberFunctionDefsToDecl(
 void SymbolTableVisitor::GetInheritedEntries(SymbolTable& symtab,
                                              std::vector<std::string> classes) {
   for (auto& class_name : classes) {
-    auto class_entry = symtab.GetEntry("class", class_name);
+    auto class_entry = symtab.GetEntry(EntryKind::CLASS, class_name);
     if (class_entry == nullptr) {
       Logger::Err(
           "Attempt to inherit a class that doesn't exist '" + class_name + "'",
@@ -136,11 +137,12 @@ void SymbolTableVisitor::GetInheritedEntries(SymbolTable& symtab,
       continue;
     }
     auto class_symtab = class_entry->Link();
-    auto inherited_classes = std::dynamic_pointer_cast<InheritEntry>(
-                                 class_symtab->GetEntry("inherit", "inherit"))
-                                 ->InheritList();
+    auto inherited_classes =
+        EntryCast<InheritEntry>(
+            class_symtab->GetEntry(EntryKind::INHERIT, "inherit"))
+            ->InheritList();
     for (auto inh_class : inherited_classes) {
-      auto inh_entry = symtab.GetEntry("class", inh_class);
+      auto inh_entry = symtab.GetEntry(EntryKind::CLASS, inh_class);
       if (!inh_entry) {
         Logger::Err(
             "Attempt to inherit a class that doesn't exist '" + inh_class + "'",
@@ -149,9 +151,8 @@ void SymbolTableVisitor::GetInheritedEntries(SymbolTable& symtab,
       }
       auto inh_symtab = inh_entry->Link();
       for (auto it = inh_symtab->Begin(); it != inh_symtab->End(); ++it) {
-        if (it->first.first == "memberVar") {
-          class_symtab->AddEntry(
-              std::dynamic_pointer_cast<MemberVarEntry>(it->second));
+        if ((*it)->Kind() == EntryKind::MEMBER_VAR) {
+          class_symtab->AddEntry(std::static_pointer_cast<MemberVarEntry>(*it));
         }
       }
     }
@@ -252,10 +253,11 @@ void SymbolTableVisitor::Visit(FuncDefNode& node) {
   if (scope_res.size() > 0) {
     scope = scope_res.at(0)->Val();
   }
-  node.symtab_entry = std::make_shared<FreeFuncEntry>(
+  auto entry = std::make_shared<FreeFuncEntry>(
       name, return_type, node.ChildAt(0)->Line(), func_table, params, scope);
-  node.symtab->AddEntry(
-      std::static_pointer_cast<FreeFuncEntry>(node.symtab_entry));
+  node.Funcs().Add(entry);
+  node.symtab_entry = entry;
+  node.symtab->AddEntry(entry);
   node.symtab = func_table;
   return_found_ = false;
   DFS(node);
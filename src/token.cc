@@ -1,13 +1,24 @@
 #include "token.h"
 
+#include "string_table.h"
+
 namespace toy {
 
-Token::Token(TokenType type, std::string lexeme, int line)
+static const std::string EMPTY_LEXEME;
+
+Token::Token() : lexeme_(&EMPTY_LEXEME) {}
+
+Token::Token(TokenType type, const std::string& lexeme, int line)
+    : type_(type),
+      lexeme_(StringTable::Default().Intern(lexeme)),
+      line_(line) {}
+
+Token::Token(TokenType type, const std::string* lexeme, int line)
     : type_(type), lexeme_(lexeme), line_(line) {}
 
 TokenType Token::Type() const { return type_; }
 
-std::string Token::Lexeme() const { return lexeme_; }
+const std::string& Token::Lexeme() const { return *lexeme_; }
 
 int Token::Line() const { return line_; }
 
@@ -16,17 +27,18 @@ bool Token::IsComment() const {
 }
 
 std::ostream& operator<<(std::ostream& os, const Token& tk) {
-  os << "[" << TokenTypeToString(tk.type_) << ", " << tk.lexeme_ << ", "
+  os << "[" << TokenTypeToString(tk.type_) << ", " << *tk.lexeme_ << ", "
      << tk.line_ << "]";
   return os;
 }
 
 bool operator==(const Token& tk1, const Token& tk2) {
-  return tk1.type_ == tk2.type_ && tk1.lexeme_ == tk2.lexeme_ &&
-         tk1.line_ == tk2.line_;
+  // Lexemes interned in the same table compare by address.
+  return tk1.type_ == tk2.type_ && tk1.line_ == tk2.line_ &&
+         (tk1.lexeme_ == tk2.lexeme_ || *tk1.lexeme_ == *tk2.lexeme_);
 }
 
-inline std::string TokenTypeToString(const TokenType& type) {
+std::string TokenTypeToString(const TokenType& type) {
   switch (type) {
     case TokenType::ID:
       return "id";
@@ -0,0 +1,59 @@
+#include "token_array.h"
+
+#include <algorithm>
+
+namespace toy {
+
+std::size_t TokenArray::Size() const { return types.size(); }
+
+Token TokenArray::At(std::size_t i) const {
+  return Token(types[i], lexemes[i], lines[i]);
+}
+
+void TokenArray::Reserve(std::size_t n) {
+  types.reserve(n);
+  offsets.reserve(n);
+  lengths.reserve(n);
+  lines.reserve(n);
+  lexemes.reserve(n);
+}
+
+void TokenArray::PushBack(TokenType type, uint32_t offset, uint32_t length,
+                          int line, const std::string* lexeme) {
+  types.push_back(type);
+  offsets.push_back(offset);
+  lengths.push_back(length);
+  lines.push_back(line);
+  lexemes.push_back(lexeme);
+}
+
+// Replaces v[first, last) with the elements of with.
+template <typename T>
+static void SpliceVector(std::vector<T>& v, std::size_t first,
+                         std::size_t last, const std::vector<T>& with) {
+  std::size_t common = std::min(last - first, with.size());
+  std::copy(with.begin(), with.begin() + common, v.begin() + first);
+  if (common < with.size()) {
+    v.insert(v.begin() + first + common, with.begin() + common, with.end());
+  } else {
+    v.erase(v.begin() + first + common, v.begin() + last);
+  }
+}
+
+void TokenArray::Splice(std::size_t first, std::size_t last,
+                        const TokenArray& with) {
+  SpliceVector(types, first, last, with.types);
+  SpliceVector(offsets, first, last, with.offsets);
+  SpliceVector(lengths, first, last, with.lengths);
+  SpliceVector(lines, first, last, with.lines);
+  SpliceVector(lexemes, first, last, with.lexemes);
+}
+
+void TokenArray::Shift(std::size_t first, long offset_delta, int line_delta) {
+  for (std::size_t i = first; i < Size(); ++i) {
+    offsets[i] += offset_delta;
+    lines[i] += line_delta;
+  }
+}
+
+}  // namespace toy
@@ -0,0 +1,18 @@
+#include "trace_sink.h"
+
+namespace toy {
+
+TraceSink::TraceSink(std::string filepath) : filepath_(filepath) {}
+
+TraceSink::~TraceSink() { Flush(); }
+
+void TraceSink::Flush() {
+  if (!ofs_.is_open()) {
+    ofs_.open(filepath_);
+  }
+  ofs_ << buf_.str();
+  ofs_.flush();
+  buf_.str("");
+}
+
+}  // namespace toy
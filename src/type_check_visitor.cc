@@ -5,27 +5,32 @@
 
 namespace toy {
 
-bool IsClassType(const std::string& type) {
-  return type != "integer" && type != "float" && type != "typeerror";
+const char* const TypeCheckVisitor::UNDECLARED_MEMBER_TYPE = "typerror";
+
+static bool IsClassType(TypeId type) {
+  return type != TypeTable::INTEGER && type != TypeTable::FLOAT &&
+         type != TypeTable::TYPE_ERROR;
 }
 
 void TypeCheckVisitor::Visit(AddOpNode& node) {
   DFS(node);
-  auto left_type = node.Children().at(0)->Type();
+  TypeId left_type = node.ChildAt(0)->TypeID();
+  const std::string& left_name = node.Types().Name(left_type);
   if (IsClassType(left_type)) {
-    Logger::Err("Add operators not allowed on objects ('" + left_type + "')",
+    Logger::Err("Add operators not allowed on objects ('" + left_name + "')",
                 node.Line(), ErrorType::SEMANTIC);
   }
-  auto right_type = node.Children().at(1)->Type();
+  TypeId right_type = node.ChildAt(1)->TypeID();
+  const std::string& right_name = node.Types().Name(right_type);
   if (IsClassType(right_type)) {
-    Logger::Err("Add operators not allowed on objects ('" + right_type + "')",
+    Logger::Err("Add operators not allowed on objects ('" + right_name + "')",
                 node.Line(), ErrorType::SEMANTIC);
   }
   if (left_type == right_type) {
-    node.SetType(left_type);
+    node.SetTypeID(left_type);
   } else {
-    node.SetType("typeerror");
-    Logger::Err("Mismatching types '" + left_type + "' and '" + right_type +
+    node.SetTypeID(TypeTable::TYPE_ERROR);
+    Logger::Err("Mismatching types '" + left_name + "' and '" + right_name +
                     "' in add operation",
                 node.Line(), ErrorType::SEMANTIC);
   }
@@ -33,21 +38,23 @@ void TypeCheckVisitor::Visit(AddOpNode& node) {
 
 void TypeCheckVisitor::Visit(MultOpNode& node) {
   DFS(node);
-  auto left_type = node.Children().at(0)->Type();
+  TypeId left_type = node.ChildAt(0)->TypeID();
+  const std::string& left_name = node.Types().Name(left_type);
   if (IsClassType(left_type)) {
-    Logger::Err("Mult operators not allowed on objects ('" + left_type + "')",
+    Logger::Err("Mult operators not allowed on objects ('" + left_name + "')",
                 node.Line(), ErrorType::SEMANTIC);
   }
-  auto right_type = node.Children().at(1)->Type();
+  TypeId right_type = node.ChildAt(1)->TypeID();
+  const std::string& right_name = node.Types().Name(right_type);
   if (IsClassType(right_type)) {
-    Logger::Err("Mult operators not allowed on objects ('" + right_type + "')",
+    Logger::Err("Mult operators not allowed on objects ('" + right_name + "')",
                 node.Line(), ErrorType::SEMANTIC);
   }
   if (left_type == right_type) {
-    node.SetType(left_type);
+    node.SetTypeID(left_type);
   } else {
-    node.SetType("typeerror");
-    Logger::Err("Mismatching types '" + left_type + "' and '" + right_type +
+    node.SetTypeID(TypeTable::TYPE_ERROR);
+    Logger::Err("Mismatching types '" + left_name + "' and '" + right_name +
                     "' in mult operation",
                 node.Line(), ErrorType::SEMANTIC);
   }
@@ -55,13 +62,14 @@ void TypeCheckVisitor::Visit(MultOpNode& node) {
 
 void TypeCheckVisitor::Visit(AssignNode& node) {
   DFS(node);
-  auto left_type = node.Children().at(0)->Type();
-  auto right_type = node.Children().at(1)->Type();
+  TypeId left_type = node.ChildAt(0)->TypeID();
+  TypeId right_type = node.ChildAt(1)->TypeID();
   if (left_type == right_type) {
-    node.SetType(left_type);
+    node.SetTypeID(left_type);
   } else {
-    node.SetType("typeerror");
-    Logger::Err("Mismatching types '" + left_type + "' and '" + right_type +
+    node.SetTypeID(TypeTable::TYPE_ERROR);
+    Logger::Err("Mismatching types '" + node.Types().Name(left_type) +
+                    "' and '" + node.Types().Name(right_type) +
                     "' in assign operation",
                 node.Line(), ErrorType::SEMANTIC);
   }
@@ -69,21 +77,23 @@ void TypeCheckVisitor::Visit(AssignNode& node) {
 
 void TypeCheckVisitor::Visit(RelExprNode& node) {
   DFS(node);
-  auto left_type = node.ChildAt(0)->Type();
+  TypeId left_type = node.ChildAt(0)->TypeID();
+  const std::string& left_name = node.Types().Name(left_type);
   if (IsClassType(left_type)) {
-    Logger::Err("Rel operators not allowed on objects ('" + left_type + "')",
+    Logger::Err("Rel operators not allowed on objects ('" + left_name + "')",
                 node.ChildAt(1)->Line(), ErrorType::SEMANTIC);
   }
-  auto right_type = node.Children().at(2)->Type();
+  TypeId right_type = node.ChildAt(2)->TypeID();
+  const std::string& right_name = node.Types().Name(right_type);
   if (IsClassType(right_type)) {
-    Logger::Err("Rel operators not allowed on objects ('" + right_type + "')",
+    Logger::Err("Rel operators not allowed on objects ('" + right_name + "')",
                 node.ChildAt(1)->Line(), ErrorType::SEMANTIC);
   }
   if (left_type == right_type) {
-    node.SetType(left_type);
+    node.SetTypeID(left_type);
   } else {
-    node.SetType("typeerror");
-    Logger::Err("Mismatching types '" + left_type + "' and '" + right_type +
+    node.SetTypeID(TypeTable::TYPE_ERROR);
+    Logger::Err("Mismatching types '" + left_name + "' and '" + right_name +
                     "' in rel expression",
                 node.ChildAt(1)->Line(), ErrorType::SEMANTIC);
   }
@@ -95,25 +105,27 @@ void TypeCheckVisitor::Visit(DataMemberNode& node) {
   int line = node.ChildAt(0)->Line();
 
   // dot operator should only be used for class types
-  std::string class_name = node.Type();
-  if (!IsClassType(class_name)) {
+  TypeId class_type = node.TypeID();
+  const std::string& class_name = node.Type();
+  if (!IsClassType(class_type)) {
     Logger::Err("dot operator can only be used on variables of class type",
                 line, ErrorType::SEMANTIC);
-    node.SetType("typeerror");
+    node.SetTypeID(TypeTable::TYPE_ERROR);
     return;
   }
-  node.cls = class_name;
+  node.cls = class_type;
 
-  std::shared_ptr<Entry> entry = node.symtab->GetEntry("memberVar", var_name);
+  std::shared_ptr<Entry> entry =
+      node.symtab->GetEntry(EntryKind::MEMBER_VAR, var_name);
   if (!entry) {
     if (class_name == "") {
-      entry = node.symtab->GetEntry("local", var_name);
+      entry = node.symtab->GetEntry(EntryKind::LOCAL, var_name);
     } else {
-      auto classentry = node.symtab->GetEntry("class", class_name);
+      auto classentry = node.symtab->GetEntry(EntryKind::CLASS, class_name);
       if (classentry) {
-        entry = classentry->Link()->GetEntry("memberVar", var_name);
+        entry = classentry->Link()->GetEntry(EntryKind::MEMBER_VAR, var_name);
         if (entry) {
-          if (std::dynamic_pointer_cast<MemberVarEntry>(entry)->Visibility() ==
+          if (std::static_pointer_cast<MemberVarEntry>(entry)->Visibility() ==
               "private") {
             Logger::Err("Can't access private variables from outside the class",
                         line, ErrorType::SEMANTIC);
@@ -123,12 +135,12 @@ void TypeCheckVisitor::Visit(DataMemberNode& node) {
           Logger::Err("Undeclared data member '" + var_name +
                           "' not found in '" + class_name + "'",
                       line, ErrorType::SEMANTIC);
-          node.SetType("typerror");
+          node.SetType(UNDECLARED_MEMBER_TYPE);
           return;
         }
       } else {
         Logger::Err("Undefined class " + class_name, line, ErrorType::SEMANTIC);
-        node.SetType("typerror");
+        node.SetType(UNDECLARED_MEMBER_TYPE);
         return;
       }
     }
@@ -139,7 +151,7 @@ void TypeCheckVisitor::Visit(DataMemberNode& node) {
     auto dimlist = entry->Dims();
     auto indicelist = node.ChildAt(1)->Children();
     for (auto indice : indicelist) {
-      if (indice->Type() != "integer") {
+      if (indice->TypeID() != TypeTable::INTEGER) {
         Logger::Err("Expresions used as an index must be of integer type", line,
                     ErrorType::SEMANTIC);
       }
@@ -156,10 +168,10 @@ void TypeCheckVisitor::Visit(DataMemberNode& node) {
                       std::to_string(dimlist.size()) + " with " +
                       std::to_string(indicelist.size()) + " indices",
                   line, ErrorType::SEMANTIC);
-      node.SetType("typeerror");
+      node.SetTypeID(TypeTable::TYPE_ERROR);
     }
   } else {
-    node.SetType("typeerror");
+    node.SetTypeID(TypeTable::TYPE_ERROR);
     Logger::Err("Use of undeclared variable '" + var_name + "'", line,
                 ErrorType::SEMANTIC);
   }
@@ -168,6 +180,7 @@ void TypeCheckVisitor::Visit(DataMemberNode& node) {
 void TypeCheckVisitor::Visit(FuncCallNode& node) {
   DFS(node);
   // We check for the type given from our lhs when dot operator is used
+  TypeId class_type = node.TypeID();
   std::string class_name = node.Type();
   std::string func_name = node.ChildAt(0)->Val();
   int line = node.ChildAt(0)->Line();
@@ -179,25 +192,26 @@ void TypeCheckVisitor::Visit(FuncCallNode& node) {
       class_name, node.ChildAt(0)->Val(), fparams);
 
   // dot operator should only be used for class types
-  if (!IsClassType(class_name)) {
+  if (!IsClassType(class_type)) {
     Logger::Err("dot operator can only be used on variables of class type",
                 line, ErrorType::SEMANTIC);
-    node.SetType("typeerror");
+    node.SetTypeID(TypeTable::TYPE_ERROR);
     return;
   }
-  node.cls = class_name;
+  node.cls = class_type;
 
   std::shared_ptr<Entry> entry =
-      node.symtab->GetEntry("memberFunc", func_signature);
+      node.symtab->GetEntry(EntryKind::MEMBER_FUNC, func_signature);
   if (!entry) {
     if (class_name == "") {
-      entry = node.symtab->GetEntry("func", func_signature);
+      entry = node.symtab->GetEntry(EntryKind::FUNC, func_signature);
     } else {
-      auto classentry = node.symtab->GetEntry("class", class_name);
+      auto classentry = node.symtab->GetEntry(EntryKind::CLASS, class_name);
       if (classentry) {
-        entry = classentry->Link()->GetEntry("memberFunc", func_signature);
+        entry = classentry->Link()->GetEntry(EntryKind::MEMBER_FUNC,
+                                             func_signature);
         if (entry) {
-          if (std::dynamic_pointer_cast<MemberFuncEntry>(entry)->Visibility() ==
+          if (std::static_pointer_cast<MemberFuncEntry>(entry)->Visibility() ==
               "private") {
             Logger::Err("Can't access private functions from outside the class",
                         line, ErrorType::SEMANTIC);
@@ -207,24 +221,26 @@ void TypeCheckVisitor::Visit(FuncCallNode& node) {
           Logger::Err("Undeclared member function '" + func_signature +
                           "' not found in '" + class_name + "'",
                       line, ErrorType::SEMANTIC);
-          node.SetType("typerror");
+          node.SetType(UNDECLARED_MEMBER_TYPE);
           return;
         }
       } else {
         Logger::Err("Undefined class " + class_name, line, ErrorType::SEMANTIC);
-        node.SetType("typerror");
+        node.SetType(UNDECLARED_MEMBER_TYPE);
         return;
       }
     }
   }
 
   if (entry) {
+    // Resolved once for all, later passes use the id
+    node.func = entry->func;
     std::string type = entry->Type();
     node.SetType(type);
   } else {
     Logger::Err("Use of undeclared free function '" + func_signature + "'",
                 line, ErrorType::SEMANTIC);
-    node.SetType("typeerror");
+    node.SetTypeID(TypeTable::TYPE_ERROR);
   }
 }
 
@@ -233,18 +249,20 @@ void TypeCheckVisitor::Visit(VarNode& node) {
   // the type information from left to right
   auto num_children = node.Children().size();
   for (uint i = 0; i < num_children; i++) {
-    node.ChildAt(i)->Accept(*this);
+    VisitChild(*node.ChildAt(i));
     if (i < num_children - 1) {
-      node.ChildAt(i + 1)->SetType(node.ChildAt(i)->Type());
+      node.ChildAt(i + 1)->SetTypeID(node.ChildAt(i)->TypeID());
     }
   }
-  node.SetType(node.ChildAt(num_children - 1)->Type());
+  node.SetTypeID(node.ChildAt(num_children - 1)->TypeID());
 }
 
+void TypeCheckVisitor::VisitChild(ASTNode& child) { child.Accept(*this); }
+
 void TypeCheckVisitor::Visit(ReturnNode& node) {
   DFS(node);
   std::string expected_return = node.symtab_entry->Type();
-  std::string actual_return = node.ChildAt(0)->Type();
+  const std::string& actual_return = node.ChildAt(0)->Type();
   if (expected_return != actual_return) {
     Logger::Err("Function '" + node.symtab->Name() + "' has return type '" +
                     expected_return + "' but returns '" + actual_return + "'",
@@ -254,24 +272,24 @@ void TypeCheckVisitor::Visit(ReturnNode& node) {
 
 void TypeCheckVisitor::Visit(SignNode& node) {
   DFS(node);
-  node.SetType(node.ChildAt(0)->Type());
+  node.SetTypeID(node.ChildAt(0)->TypeID());
 }
 void TypeCheckVisitor::Visit(NotNode& node) {
   DFS(node);
-  node.SetType(node.ChildAt(0)->Type());
+  node.SetTypeID(node.ChildAt(0)->TypeID());
 }
 
 void TypeCheckVisitor::Visit(ArithExprNode& node) {
   DFS(node);
   node.SetLine(node.ChildAt(0)->Line());
-  node.SetType(node.ChildAt(0)->Type());
+  node.SetTypeID(node.ChildAt(0)->TypeID());
 }
 
 void TypeCheckVisitor::Visit(MemberVarDeclNode& node) {
   DFS(node);
   std::string type = node.ChildAt(1)->Val();
   if (type != "integer" && type != "float") {
-    if (!node.symtab->GetEntry("class", type)) {
+    if (!node.symtab->GetEntry(EntryKind::CLASS, type)) {
       Logger::Err("Undefined type " + type, node.ChildAt(0)->Line(),
                   ErrorType::SEMANTIC);
     }
@@ -282,7 +300,7 @@ void TypeCheckVisitor::Visit(VarDeclNode& node) {
   DFS(node);
   std::string type = node.ChildAt(0)->Val();
   if (type != "integer" && type != "float") {
-    if (!node.symtab->GetEntry("class", type)) {
+    if (!node.symtab->GetEntry(EntryKind::CLASS, type)) {
       Logger::Err("Undefined type " + type, node.ChildAt(0)->Line(),
                   ErrorType::SEMANTIC);
     }
@@ -291,12 +309,12 @@ void TypeCheckVisitor::Visit(VarDeclNode& node) {
 
 void TypeCheckVisitor::Visit(IntNumNode& node) {
   DFS(node);
-  node.SetType("integer");
+  node.SetTypeID(TypeTable::INTEGER);
 }
 
 void TypeCheckVisitor::Visit(FloatNumNode& node) {
   DFS(node);
-  node.SetType("float");
+  node.SetTypeID(TypeTable::FLOAT);
 }
 
 // Just dfs
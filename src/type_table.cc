@@ -0,0 +1,39 @@
+#include "type_table.h"
+
+#include <stdexcept>
+
+namespace toy {
+
+const TypeId TypeTable::NONE;
+const TypeId TypeTable::INTEGER;
+const TypeId TypeTable::FLOAT;
+const TypeId TypeTable::TYPE_ERROR;
+
+TypeTable::TypeTable() {
+  // In the order of their ids
+  for (const char* name : {"", "integer", "float", "typeerror"}) {
+    Intern(name);
+  }
+}
+
+TypeId TypeTable::Intern(const std::string& name) {
+  // Finding a type only reads the table
+  auto found = ids_.find(name);
+  if (found != ids_.end()) {
+    return found->second;
+  }
+  if (concurrent_) {
+    throw std::logic_error("Type '" + name + "' interned concurrently");
+  }
+  TypeId id = static_cast<TypeId>(names_.size());
+  names_.push_back(&ids_.emplace(name, id).first->first);
+  return id;
+}
+
+const std::string& TypeTable::Name(TypeId id) const { return *names_.at(id); }
+
+std::size_t TypeTable::Size() const { return names_.size(); }
+
+void TypeTable::SetConcurrent(bool concurrent) { concurrent_ = concurrent; }
+
+}  // namespace toy
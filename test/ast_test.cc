@@ -1,7 +1,11 @@
 #include "ast.h"
 
+#include <fstream>
+#include <functional>
+
 #include "gtest/gtest.h"
 #include "parser.h"
+#include "static_ast_visitor.h"
 
 namespace asttest {
 
@@ -18,9 +22,7 @@ class ASTTest : public ::testing::Test {
 TEST_F(ASTTest, TestBubblesort) {
   std::ifstream prog_stream("../test/fixtures/parser/bubblesort.src");
   Lexer lexer(prog_stream);
-  Grammar grammar;
-  ParserGenerator pgen(grammar);
-  Parser parser(lexer, pgen);
+  Parser parser(lexer);
   auto ast = parser.Parse();
   ast->ToDotFile("../test/fixtures/ast/test.gv");
 
@@ -38,9 +40,7 @@ TEST_F(ASTTest, TestBubblesort) {
 TEST_F(ASTTest, TestPolynomial) {
   std::ifstream prog_stream("../test/fixtures/parser/polynomial.src");
   Lexer lexer(prog_stream);
-  Grammar grammar;
-  ParserGenerator pgen(grammar);
-  Parser parser(lexer, pgen);
+  Parser parser(lexer);
   auto ast = parser.Parse();
   ast->ToDotFile("../test/fixtures/ast/test.gv");
 
@@ -58,9 +58,7 @@ TEST_F(ASTTest, TestPolynomial) {
 TEST_F(ASTTest, TestSimpleMain) {
   std::ifstream prog_stream("../test/fixtures/parser/simplemain.src");
   Lexer lexer(prog_stream);
-  Grammar grammar;
-  ParserGenerator pgen(grammar);
-  Parser parser(lexer, pgen);
+  Parser parser(lexer);
   auto ast = parser.Parse();
   ast->ToDotFile("../test/fixtures/ast/test.gv");
 
@@ -75,4 +73,161 @@ TEST_F(ASTTest, TestSimpleMain) {
   EXPECT_EQ(expected_str, actual_str);
 }
 
-}  // namespace asttest
\ No newline at end of file
+// The recursive-descent parser builds every fixture's AST byte for byte.
+TEST_F(ASTTest, TestRecursiveDescent) {
+  for (const char* name : {"bubblesort", "polynomial", "simplemain"}) {
+    std::ifstream prog_stream(std::string("../test/fixtures/parser/") + name +
+                              ".src");
+    Lexer lexer(prog_stream);
+    Parser parser(lexer);
+    parser.SetMode(ParserMode::RECURSIVE_DESCENT);
+    auto ast = parser.Parse();
+    ASSERT_NE(nullptr, ast) << name;
+    ast->ToDotFile("../test/fixtures/ast/test.gv");
+
+    std::ifstream expected_stream(std::string("../test/fixtures/ast/") +
+                                  name + ".gv");
+    std::string expected_str(
+        (std::istreambuf_iterator<char>(expected_stream)),
+        std::istreambuf_iterator<char>());
+
+    std::ifstream actual_stream("../test/fixtures/ast/test.gv");
+    std::string actual_str((std::istreambuf_iterator<char>(actual_stream)),
+                           std::istreambuf_iterator<char>());
+
+    EXPECT_EQ(expected_str, actual_str) << name;
+  }
+}
+
+// Every kind builds through the factory tables, and the spellings used by
+// semantic actions and token types build the same kinds.
+TEST_F(ASTTest, TestMakeNodeKinds) {
+  for (int i = 0; i < static_cast<int>(FIRST_LEAF_KIND); ++i) {
+    NodeKind kind = static_cast<NodeKind>(i);
+    std::string name = NodeKindToString(kind);
+    EXPECT_EQ(kind, StringToNodeKind(name));
+    EXPECT_EQ(ASTNode::MakeNode(name)->ToStr(),
+              ASTNode::MakeNode(kind)->ToStr());
+  }
+  EXPECT_EQ("funcDef", ASTNode::MakeNode(NodeKind::FUNC_DEF)->ToStr());
+  EXPECT_EQ("addOp | +", ASTNode::MakeNode(NodeKind::ADD_OP, "+", 1)->ToStr());
+  EXPECT_EQ(NodeKind::ADD_OP, ASTNode::LeafKindOf(TokenType::OR));
+  EXPECT_EQ(NodeKind::MULT_OP, ASTNode::LeafKindOf(TokenType::AND));
+  EXPECT_EQ(NodeKind::ID, ASTNode::LeafKindOf(TokenType::INTEGER));
+  EXPECT_EQ(NodeKind::REL_OP, ASTNode::LeafKindOf(TokenType::LEQ));
+  EXPECT_EQ(NodeKind::NONE, ASTNode::LeafKindOf(TokenType::SEMICOLON));
+  EXPECT_THROW(ASTNode::MakeNode(NodeKind::SIGN), std::invalid_argument);
+  EXPECT_THROW(ASTNode::MakeNode(NodeKind::NONE, "", 1),
+               std::invalid_argument);
+  EXPECT_THROW(ASTNode::MakeNode("bogus"), std::invalid_argument);
+}
+
+// Children are stored in order in the arena of their parent, which may grow
+// them past any reservation.
+TEST_F(ASTTest, TestArenaChildren) {
+  ASTArena arena;
+  ASTNode* list = arena.MakeNode(NodeKind::STAT_LIST);
+  EXPECT_TRUE(list->Children().empty());
+  list->ReserveChildren(2);
+  std::vector<ASTNode*> children;
+  for (int i = 0; i < 5; ++i) {
+    children.push_back(arena.MakeNode(NodeKind::ID, std::to_string(i), i));
+    list->AddChild(children.back());
+  }
+  EXPECT_EQ(6u, arena.NumNodes());
+  EXPECT_GT(arena.BytesReserved(), 0u);
+  ChildSpan span = list->Children();
+  EXPECT_EQ(children, std::vector<ASTNode*>(span.begin(), span.end()));
+  EXPECT_EQ("4", list->ChildAt(4)->Val());
+  EXPECT_THROW(list->ChildAt(5), std::out_of_range);
+}
+
+TEST_F(ASTTest, TestTypesAndOperators) {
+  ASTArena arena;
+  TypeTable& types = arena.Types();
+  EXPECT_EQ(TypeTable::INTEGER, types.Intern("integer"));
+  EXPECT_EQ("typeerror", types.Name(TypeTable::TYPE_ERROR));
+  TypeId cls = types.Intern("POLYNOMIAL");
+  EXPECT_EQ(cls, types.Intern("POLYNOMIAL"));
+  EXPECT_EQ(5u, types.Size());
+  // Only the types interned beforehand while concurrent
+  types.SetConcurrent(true);
+  EXPECT_EQ(cls, types.Intern("POLYNOMIAL"));
+  EXPECT_THROW(types.Intern("POLYNOMIAL[]"), std::logic_error);
+  types.SetConcurrent(false);
+  EXPECT_EQ(5u, types.Size());
+
+  ASTNode* op = arena.MakeNode(NodeKind::REL_OP, "<>", 1);
+  EXPECT_EQ(Operator::NEQ, op->Op());
+  EXPECT_EQ(Operator::OR, arena.MakeNode(NodeKind::ADD_OP, "or", 1)->Op());
+  EXPECT_EQ(Operator::NONE, arena.MakeNode(NodeKind::ID, "or", 1)->Op());
+  EXPECT_EQ("", op->Type());
+  op->SetType("POLYNOMIAL");
+  EXPECT_EQ(cls, op->TypeID());
+  op->SetTypeID(TypeTable::FLOAT);
+  EXPECT_EQ("float", op->Type());
+  EXPECT_EQ(0, op->regist);
+}
+
+// Checks that every node is dispatched to the overload for its class.
+class KindChecker : public StaticASTVisitor<KindChecker> {
+ public:
+  std::vector<NodeKind> kinds;
+
+  template <typename T>
+  void Visit(T& node) {
+    EXPECT_NE(nullptr, dynamic_cast<T*>(static_cast<ASTNode*>(&node)))
+        << node.ToStr();
+    kinds.push_back(node.Kind());
+    DFS(node);
+  }
+};
+
+// Counts the ids, and the nodes through the default overloads.
+class IdCounter : public StaticASTVisitor<IdCounter> {
+ public:
+  using StaticASTVisitor<IdCounter>::Visit;
+  int ids = 0;
+  int nodes = 0;
+
+  void Visit(IdNode&) { ++ids; }
+
+  void DFS(ASTNode& node) {
+    ++nodes;
+    StaticASTVisitor<IdCounter>::DFS(node);
+  }
+};
+
+TEST_F(ASTTest, TestStaticVisitor) {
+  ASTArena arena;
+  ASTNode* list = arena.MakeNode(NodeKind::STAT_LIST);
+  std::vector<NodeKind> kinds = {NodeKind::STAT_LIST};
+  for (int i = 0; i < static_cast<int>(NodeKind::NONE); ++i) {
+    NodeKind kind = static_cast<NodeKind>(i);
+    list->AddChild(kind < FIRST_LEAF_KIND ? arena.MakeNode(kind)
+                                          : arena.MakeNode(kind, "+", 1));
+    EXPECT_EQ(kind, list->Children()[i]->Kind());
+    kinds.push_back(kind);
+  }
+  KindChecker checker;
+  checker.Dispatch(*list);
+  EXPECT_EQ(kinds, checker.kinds);
+
+  std::ifstream file_stream("../test/fixtures/parser/bubblesort.src");
+  Lexer lexer(file_stream);
+  auto ast = Parser(lexer).Parse();
+  IdCounter counter;
+  counter.Dispatch(*ast);
+  std::function<int(const ASTNode&, NodeKind)> count =
+      [&](const ASTNode& node, NodeKind kind) {
+        int n = node.Kind() == kind || kind == NodeKind::NONE;
+        for (ASTNode* child : node.Children()) {
+          n += count(*child, kind);
+        }
+        return n;
+      };
+  EXPECT_EQ(count(*ast, NodeKind::ID), counter.ids);
+  EXPECT_EQ(count(*ast, NodeKind::NONE) - counter.ids, counter.nodes);
+}
+
+}  // namespace asttest
@@ -1,8 +1,10 @@
 #include "ast.h"
 #include "code_gen_visitor.h"
+#include "fused_semantic_visitor.h"
 #include "gtest/gtest.h"
 #include "logger.h"
 #include "mem_size_visitor.h"
+#include "parallel_semantic_pass.h"
 #include "parser.h"
 #include "symbol_table_visitor.h"
 #include "type_check_visitor.h"
@@ -21,9 +23,7 @@ class CodeGenTest : public ::testing::Test {
 std::vector<std::string> CompileAndRunCode(std::string filepath) {
   std::ifstream prog_stream(filepath);
   toy::Lexer lexer(prog_stream);
-  toy::Grammar grammar;
-  toy::ParserGenerator pgen(grammar);
-  toy::Parser parser(lexer, pgen);
+  toy::Parser parser(lexer);
   auto ast = parser.Parse();
   toy::SymbolTableVisitor symtab_visitor;
   ast->Accept(symtab_visitor);
@@ -40,6 +40,52 @@ std::vector<std::string> CompileAndRunCode(std::string filepath) {
   return res;
 }
 
+static std::string ReadFile(const std::string& filepath) {
+  std::ifstream ifs(filepath);
+  return std::string((std::istreambuf_iterator<char>(ifs)),
+                     std::istreambuf_iterator<char>());
+}
+
+enum class SemanticPass { SEPARATE, FUSED, PARALLEL };
+
+// The fixtures the fused and parallel passes are checked against the
+// separate ones on
+static const char* const CODEGEN_FIXTURES[] = {
+    "Test1", "Test2", "Test3", "Test4", "Test5", "Test6", "Test7",
+    "Test8", "Test9", "Test10", "Test11", "Test12", "Test13", "Test14",
+    "Test15", "Test16", "factorial", "fibonacci", "maintest",
+    "maintest2", "simplemain"};
+
+// Compile the given file, type checking and sizing it with the given pass,
+// and return the symbol table and the generated code
+std::string CompileCode(const std::string& filepath, SemanticPass pass) {
+  toy::Logger::Clear();
+  std::ifstream prog_stream(filepath);
+  toy::Lexer lexer(prog_stream);
+  toy::Parser parser(lexer);
+  auto ast = parser.Parse();
+  toy::SymbolTableVisitor symtab_visitor;
+  ast->Accept(symtab_visitor);
+  if (pass == SemanticPass::FUSED) {
+    toy::FusedSemanticVisitor fused_visitor;
+    ast->Accept(fused_visitor);
+    EXPECT_TRUE(fused_visitor.Sized());
+  } else if (pass == SemanticPass::PARALLEL) {
+    toy::ParallelSemanticPass parallel_pass(4);
+    parallel_pass.Run(*ast);
+    EXPECT_TRUE(parallel_pass.Sized());
+  } else {
+    toy::TypeCheckVisitor typecheck_visitor;
+    ast->Accept(typecheck_visitor);
+    toy::MemSizeVisitor memsize_visitor;
+    ast->Accept(memsize_visitor);
+  }
+  EXPECT_FALSE(toy::Logger::HasErrors()) << filepath;
+  toy::CodeGenVisitor codegen_visitor;
+  ast->Accept(codegen_visitor);
+  return ReadFile("../out/outsymboltable") + ReadFile("../out/outcode.m");
+}
+
 // Basic test (assign, add, write)
 TEST_F(CodeGenTest, TestCodeGen1) {
   std::vector<std::string> actual_res =
@@ -194,4 +240,22 @@ TEST_F(CodeGenTest, TestCodeGen16) {
   EXPECT_EQ(actual_res, expected_res);
 }
 
+// The fused semantic pass sizes everything like the separate passes.
+TEST_F(CodeGenTest, TestFusedSemanticPass) {
+  for (const char* name : CODEGEN_FIXTURES) {
+    std::string path = std::string("../test/fixtures/codegen/") + name + ".src";
+    std::string expected = CompileCode(path, SemanticPass::SEPARATE);
+    EXPECT_EQ(expected, CompileCode(path, SemanticPass::FUSED)) << path;
+  }
+}
+
+// So does the parallel one, numbering the temps and literals the same way.
+TEST_F(CodeGenTest, TestParallelSemanticPass) {
+  for (const char* name : CODEGEN_FIXTURES) {
+    std::string path = std::string("../test/fixtures/codegen/") + name + ".src";
+    std::string expected = CompileCode(path, SemanticPass::SEPARATE);
+    EXPECT_EQ(expected, CompileCode(path, SemanticPass::PARALLEL)) << path;
+  }
+}
+
 }  // namespace codegentest
\ No newline at end of file
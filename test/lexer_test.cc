@@ -1,9 +1,18 @@
 #include "lexer.h"
 
+#include <dirent.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
 #include <vector>
 
+#include "char_scan.h"
 #include "gtest/gtest.h"
+#include "source_buffer.h"
 #include "token.h"
+#include "trace_sink.h"
 
 namespace lexertest {
 
@@ -15,6 +24,112 @@ class LexerTest : public ::testing::Test {
   virtual ~LexerTest() {}
   virtual void SetUp() {}
   virtual void TearDown() {}
+
+  // Returns every token up to and including the first EOS. The lexer's string
+  // table is kept alive for the rest of the test, along with the lexemes.
+  std::vector<Token> LexAll(Lexer& lexer) {
+    tables_.push_back(lexer.Strings());
+    std::vector<Token> tks;
+    while (lexer.HasNext()) {
+      tks.push_back(lexer.NextToken());
+    }
+    tks.push_back(lexer.NextToken());
+    return tks;
+  }
+
+  std::vector<Token> LexStream(const std::string& src) {
+    std::istringstream is(src);
+    Lexer lexer(is);
+    return LexAll(lexer);
+  }
+
+  std::vector<Token> LexBuffer(const std::string& src,
+                               LexerMode mode = LexerMode::HAND_WRITTEN) {
+    SourceBuffer buf = SourceBuffer::FromString(src);
+    Lexer lexer(buf, mode);
+    return LexAll(lexer);
+  }
+
+  // Recursively collects the paths of all regular files under dir.
+  static void ListFiles(const std::string& dir,
+                        std::vector<std::string>& paths) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+      return;
+    }
+    while (dirent* entry = readdir(d)) {
+      std::string name = entry->d_name;
+      if (name == "." || name == "..") {
+        continue;
+      }
+      std::string path = dir + "/" + name;
+      if (DIR* sub = opendir(path.c_str())) {
+        closedir(sub);
+        ListFiles(path, paths);
+      } else {
+        paths.push_back(path);
+      }
+    }
+    closedir(d);
+  }
+
+  // Returns the tokens of the array, keeping its lexemes alive.
+  std::vector<Token> ArrayTokens(const TokenArray& tokens) {
+    tables_.push_back(tokens.strings);
+    std::vector<Token> tks;
+    for (std::size_t i = 0; i < tokens.Size(); ++i) {
+      tks.push_back(tokens.At(i));
+    }
+    return tks;
+  }
+
+  static std::vector<Token> StripComments(const std::vector<Token>& tks) {
+    std::vector<Token> stripped;
+    for (const auto& tk : tks) {
+      if (!tk.IsComment()) {
+        stripped.push_back(tk);
+      }
+    }
+    return stripped;
+  }
+
+  // Applies random edits to src one after the other, checking after each
+  // one that relexing gives the same tokens as lexing the edited text anew.
+  void CheckRandomEdits(std::string src, LexerMode mode, int num_edits,
+                        std::mt19937& rng) {
+    static const std::vector<std::string> pieces = {
+        "a",  "x1", " ",  "\n",  "0",    "12", ".",    "5e",
+        "+",  "=",  "<",  ">",   ":",    "/",  "*",    "/*",
+        "*/", "//", ";",  "(",   "if",   "e",  "@",    "1.0",
+        "_",  "\t", "}",  "*\n", "\n\n", "x",  "12.5", std::string("\0", 1)};
+    SourceBuffer buf = SourceBuffer::FromString(src);
+    Lexer lexer(buf, mode);
+    TokenArray tokens = lexer.TokenizeAll();
+    for (int i = 0; i < num_edits; ++i) {
+      std::size_t offset = rng() % (src.size() + 1);
+      std::size_t removed = rng() % 4 == 0 ? 0 : rng() % 5;
+      removed = std::min(removed, src.size() - offset);
+      std::string inserted;
+      for (int n = rng() % 3; n > 0; --n) {
+        inserted += pieces[rng() % pieces.size()];
+      }
+      src.replace(offset, removed, inserted);
+      lexer.Relex(tokens, offset, removed, inserted);
+
+      SourceBuffer expected_buf = SourceBuffer::FromString(src);
+      Lexer expected_lexer(expected_buf, mode);
+      TokenArray expected = expected_lexer.TokenizeAll();
+      ASSERT_EQ(expected.types, tokens.types) << src;
+      ASSERT_EQ(expected.offsets, tokens.offsets) << src;
+      ASSERT_EQ(expected.lengths, tokens.lengths) << src;
+      ASSERT_EQ(expected.lines, tokens.lines) << src;
+      for (std::size_t j = 0; j < tokens.Size(); ++j) {
+        ASSERT_EQ(*expected.lexemes[j], *tokens.lexemes[j]) << src;
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<StringTable>> tables_;
 };
 
 TEST_F(LexerTest, Test1) {
@@ -437,4 +552,261 @@ TEST_F(LexerTest, Test42) {
   EXPECT_EQ(expected_tks, actual_tks);
 }
 
+TEST_F(LexerTest, TestBufferMatchesStreamOnFixtures) {
+  std::vector<std::string> paths;
+  ListFiles("../test/fixtures", paths);
+  ASSERT_FALSE(paths.empty());
+  for (const auto& path : paths) {
+    std::ifstream ifs(path);
+    Lexer stream_lexer(ifs);
+    SourceBuffer buf = SourceBuffer::FromFile(path);
+    Lexer buffer_lexer(buf);
+    EXPECT_EQ(LexAll(stream_lexer), LexAll(buffer_lexer)) << path;
+  }
+}
+
+// Sources exercising the corner cases of every token rule.
+static const std::vector<std::string> EDGE_CASE_SRCS = {
+    "",        "\n\n",      "abc",       "_abc def",   "_",
+    "0",       "00",        "0.",        "01.23",      "1.",
+    "1.0",     "1.00",      "1.50e",     "1.5e+",      "1.5e-0",
+    "1.5e07",  "1.5e10",    "12abc",     "12.5.3",     "120.340e10",
+    "=",       "==",        "<>",        "<",          ">=",
+    ":",       "::",        "/",         "//",         "// c\nx",
+    "/*",      "/* a */",   "/* a **/",  "/* a\n*\n/", "/* a *",
+    "@#$",     "a\tb\rc",   "x=1;",      "f(a[2],b)",  "if then else",
+    "integer", "1.5e0)",    "1.5e0x",    "_a\nb",      "0 1 2.",
+    std::string("a\0b", 3), std::string("_a\0b c", 6),
+    std::string("12\0", 3), std::string("/*\0*/", 6)};
+
+TEST_F(LexerTest, TestBufferMatchesStreamOnEdgeCases) {
+  for (const auto& src : EDGE_CASE_SRCS) {
+    EXPECT_EQ(LexStream(src), LexBuffer(src)) << src;
+  }
+}
+
+TEST_F(LexerTest, TestDfaMatchesStreamOnFixtures) {
+  std::vector<std::string> paths;
+  ListFiles("../test/fixtures", paths);
+  ASSERT_FALSE(paths.empty());
+  for (const auto& path : paths) {
+    std::ifstream ifs(path);
+    Lexer stream_lexer(ifs);
+    SourceBuffer buf = SourceBuffer::FromFile(path);
+    Lexer dfa_lexer(buf, LexerMode::DFA);
+    EXPECT_EQ(LexAll(stream_lexer), LexAll(dfa_lexer)) << path;
+  }
+}
+
+TEST_F(LexerTest, TestDfaMatchesStreamOnEdgeCases) {
+  for (const auto& src : EDGE_CASE_SRCS) {
+    EXPECT_EQ(LexStream(src), LexBuffer(src, LexerMode::DFA)) << src;
+  }
+  // Every three char sequence over one char of each char class.
+  std::string chars = "aez09_. =<>:/*+-(){}[];,@\n";
+  for (char c1 : chars) {
+    for (char c2 : chars) {
+      for (char c3 : chars) {
+        std::string src = {c1, c2, c3};
+        EXPECT_EQ(LexStream(src), LexBuffer(src, LexerMode::DFA)) << src;
+      }
+    }
+  }
+}
+
+TEST_F(LexerTest, TestTokenizeAllMatchesNextToken) {
+  for (const auto& src : EDGE_CASE_SRCS) {
+    std::vector<Token> expected_tks = StripComments(LexStream(src));
+    for (LexerMode mode : {LexerMode::HAND_WRITTEN, LexerMode::DFA}) {
+      SourceBuffer buf = SourceBuffer::FromString(src);
+      Lexer lexer(buf, mode);
+      TokenArray tokens = lexer.TokenizeAll();
+      EXPECT_EQ(expected_tks, ArrayTokens(tokens)) << src;
+      // Every token spans exactly its lexeme, and EOS sits at the end. The
+      // lexeme of an unterminated comment is rewritten, like a comment's.
+      for (std::size_t i = 0; i + 1 < tokens.Size(); ++i) {
+        if (tokens.types[i] == TokenType::UNTERMINATED_CMT) {
+          continue;
+        }
+        EXPECT_EQ(tokens.lexemes[i]->size(), tokens.lengths[i]) << src;
+        EXPECT_EQ(src.substr(tokens.offsets[i], tokens.lengths[i]),
+                  *tokens.lexemes[i])
+            << src;
+      }
+      EXPECT_EQ(src.size(), tokens.offsets.back()) << src;
+      EXPECT_EQ(0u, tokens.lengths.back()) << src;
+    }
+    std::istringstream is(src);
+    Lexer stream_lexer(is);
+    EXPECT_EQ(expected_tks, ArrayTokens(stream_lexer.TokenizeAll())) << src;
+  }
+}
+
+TEST_F(LexerTest, TestTokenizeAllOnFixtures) {
+  std::vector<std::string> paths;
+  ListFiles("../test/fixtures", paths);
+  ASSERT_FALSE(paths.empty());
+  for (const auto& path : paths) {
+    std::ifstream ifs(path);
+    Lexer stream_lexer(ifs);
+    SourceBuffer buf = SourceBuffer::FromFile(path);
+    Lexer dfa_lexer(buf, LexerMode::DFA);
+    EXPECT_EQ(StripComments(LexAll(stream_lexer)),
+              ArrayTokens(dfa_lexer.TokenizeAll()))
+        << path;
+  }
+}
+
+TEST_F(LexerTest, TestTokenizeAllAfterNextToken) {
+  std::istringstream is("a /* b */ c\nd");
+  Lexer lexer(is);
+  EXPECT_EQ(Token(TokenType::ID, "a", 1), lexer.NextToken());
+  TokenArray tokens = lexer.TokenizeAll();
+  std::vector<Token> expected_tks = {Token(TokenType::ID, "c", 1),
+                                     Token(TokenType::ID, "d", 2),
+                                     Token(TokenType::EOS, "$", 2)};
+  EXPECT_EQ(expected_tks, ArrayTokens(tokens));
+  // Offsets count from where the stream was when TokenizeAll was called.
+  EXPECT_EQ(9u, tokens.offsets[0]);
+}
+
+TEST_F(LexerTest, TestRelexMatchesFullLexOnEdgeCases) {
+  std::mt19937 rng(42);
+  for (const auto& src : EDGE_CASE_SRCS) {
+    CheckRandomEdits(src, LexerMode::HAND_WRITTEN, 20, rng);
+    CheckRandomEdits(src, LexerMode::DFA, 20, rng);
+  }
+}
+
+TEST_F(LexerTest, TestRelexMatchesFullLexOnFixtures) {
+  std::mt19937 rng(7);
+  std::vector<std::string> paths;
+  ListFiles("../test/fixtures", paths);
+  ASSERT_FALSE(paths.empty());
+  for (const auto& path : paths) {
+    std::ifstream ifs(path);
+    std::string src((std::istreambuf_iterator<char>(ifs)),
+                    std::istreambuf_iterator<char>());
+    CheckRandomEdits(src, LexerMode::DFA, 10, rng);
+  }
+}
+
+TEST_F(LexerTest, TestRelexKeepsTokensAroundEdit) {
+  SourceBuffer buf = SourceBuffer::FromString("a = b;\n// c\nd = e;\nf;");
+  Lexer lexer(buf);
+  TokenArray tokens = lexer.TokenizeAll();
+  const std::string* d_lexeme = tokens.lexemes[4];
+  // "b" becomes "b2 +\n1", which moves everything after it down a line.
+  lexer.Relex(tokens, 5, 0, "2 +\n1");
+  std::vector<Token> expected_tks = {
+      Token(TokenType::ID, "a", 1),        Token(TokenType::ASSGN, "=", 1),
+      Token(TokenType::ID, "b2", 1),       Token(TokenType::PLUS, "+", 1),
+      Token(TokenType::INTNUM, "1", 2),    Token(TokenType::SEMICOLON, ";", 2),
+      Token(TokenType::ID, "d", 4),        Token(TokenType::ASSGN, "=", 4),
+      Token(TokenType::ID, "e", 4),        Token(TokenType::SEMICOLON, ";", 4),
+      Token(TokenType::ID, "f", 5),        Token(TokenType::SEMICOLON, ";", 5),
+      Token(TokenType::EOS, "$", 5)};
+  EXPECT_EQ(expected_tks, ArrayTokens(tokens));
+  EXPECT_EQ(d_lexeme, tokens.lexemes[6]);
+  EXPECT_EQ(17u, tokens.offsets[6]);
+  EXPECT_THROW(lexer.Relex(tokens, 100, 0, "x"), std::out_of_range);
+}
+
+TEST_F(LexerTest, TestBufferKeepsLineNumbers) {
+  std::vector<Token> expected_tks = {
+      Token(TokenType::ID, "a", 1), Token(TokenType::BLOCK_CMT, "/*\\n*/", 2),
+      Token(TokenType::ID, "b", 4), Token(TokenType::EOS, "$", 5)};
+  EXPECT_EQ(expected_tks, LexBuffer("a\n/*\n*/\nb\n"));
+}
+
+TEST_F(LexerTest, TestSkipWhitespace) {
+  // Whitespace runs of every length up to a few vectors, with newlines at
+  // varying positions, followed by a non-whitespace char or the end.
+  std::string ws = " \t\n\v\f\r";
+  for (std::size_t len = 0; len < 100; ++len) {
+    for (std::size_t shift = 0; shift < ws.size(); ++shift) {
+      std::string src;
+      int expected_lines = 0;
+      for (std::size_t i = 0; i < len; ++i) {
+        src += ws[(i * 7 + shift) % ws.size()];
+        expected_lines += src.back() == '\n';
+      }
+      for (const std::string& tail : {std::string(), std::string("x  \n")}) {
+        std::string text = src + tail;
+        int lines = 0;
+        const char* p = scan::SkipWhitespace(text.data(),
+                                             text.data() + text.size(), lines);
+        EXPECT_EQ(len, static_cast<std::size_t>(p - text.data()));
+        EXPECT_EQ(expected_lines, lines);
+      }
+    }
+  }
+}
+
+TEST_F(LexerTest, TestFindChar) {
+  for (std::size_t len = 0; len < 100; ++len) {
+    std::string src;
+    int expected_lines = 0;
+    for (std::size_t i = 0; i < len; ++i) {
+      src += (i % 5 == 3) ? '\n' : static_cast<char>('a' + i % 26);
+      expected_lines += src.back() == '\n';
+    }
+    for (const std::string& tail : {std::string(), std::string("*/\n*")}) {
+      std::string text = src + tail;
+      int lines = 0;
+      const char* p = scan::FindChar(text.data(), text.data() + text.size(),
+                                     '*', lines);
+      EXPECT_EQ(len, static_cast<std::size_t>(p - text.data()));
+      EXPECT_EQ(expected_lines, lines);
+    }
+  }
+}
+
+TEST_F(LexerTest, TestReservedWords) {
+  std::vector<std::string> reserved = {
+      "if",     "then",    "else", "while",  "class",   "integer", "float",
+      "do",     "end",     "public", "private", "or",   "and",     "not",
+      "read",   "write",   "return", "main",  "inherits", "local", "void"};
+  for (const auto& word : reserved) {
+    EXPECT_TRUE(Lexer::IsReserved(word)) << word;
+  }
+  std::vector<std::string> ids = {"",     "i",     "If",     "iff",
+                                  "whil", "writes", "wrote", "inherit",
+                                  "voids", "localx", "en",   "integer1"};
+  for (const auto& word : ids) {
+    EXPECT_FALSE(Lexer::IsReserved(word)) << word;
+  }
+}
+
+TEST_F(LexerTest, TestTokenLog) {
+  const std::string path = "../out/outlextokens";
+  std::remove(path.c_str());
+  {
+    TraceSink sink(path);
+    std::istringstream is("x = 1;");
+    Lexer lexer(is);
+    lexer.SetTokenLog(&sink);
+    LexAll(lexer);
+    // Nothing is written until the sink is flushed or destroyed.
+    EXPECT_FALSE(std::ifstream(path).good());
+  }
+  std::ifstream ifs(path);
+  std::stringstream actual;
+  actual << ifs.rdbuf();
+  EXPECT_EQ("[id, x, 1]\n[=, =, 1]\n[intNum, 1, 1]\n[;, ;, 1]\n[$, $, 1]\n",
+            actual.str());
+}
+
+TEST_F(LexerTest, TestLexemesAreInterned) {
+  SourceBuffer buf = SourceBuffer::FromString("abc x abc;abc");
+  Lexer lexer(buf);
+  std::vector<Token> tks = LexAll(lexer);
+  ASSERT_EQ(6u, tks.size());
+  EXPECT_EQ(&tks[0].Lexeme(), &tks[2].Lexeme());
+  EXPECT_EQ(&tks[0].Lexeme(), &tks[4].Lexeme());
+  EXPECT_NE(&tks[0].Lexeme(), &tks[1].Lexeme());
+  // "abc", "x", ";" and "$"
+  EXPECT_EQ(4u, lexer.Strings()->Size());
+}
+
 }  // namespace lexertest
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "parse_table.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "lexer.h"
+#include "logger.h"
+#include "parser.h"
+
+namespace parsetabletest {
+
+using namespace toy;
+
+class ParseTableTest : public ::testing::Test {
+ protected:
+  ParseTableTest() {}
+  virtual ~ParseTableTest() {}
+  virtual void SetUp() { Logger::Clear(); }
+  virtual void TearDown() {}
+  Grammar grammar;
+  ParserGenerator pgen = ParserGenerator(grammar);
+  const ParseTable& embedded = ParseTable::Embedded();
+
+  // Returns the id of the symbol spelled name in the table, or -1.
+  static int IdOf(const ParseTable& table, const std::string& name) {
+    for (int i = 0; i < table.NumSymbols(); ++i) {
+      if (table.Name(i) == name) {
+        return i;
+      }
+    }
+    return -1;
+  }
+};
+
+// The compiled in table must be the one the grammar file gives today.
+TEST_F(ParseTableTest, TestEmbeddedMatchesGrammar) {
+  ParseTable built(grammar, pgen);
+  ASSERT_EQ(built.NumTerms(), embedded.NumTerms());
+  ASSERT_EQ(built.NumNonTerms(), embedded.NumNonTerms());
+  ASSERT_EQ(built.NumActions(), embedded.NumActions());
+  ASSERT_EQ(built.NumProductions(), embedded.NumProductions());
+  EXPECT_EQ(built.Start(), embedded.Start());
+  EXPECT_EQ(built.End(), embedded.End());
+  for (int i = 0; i < built.NumSymbols(); ++i) {
+    EXPECT_STREQ(built.Name(i), embedded.Name(i));
+  }
+  for (int nt = built.NumTerms(); nt < built.NumTerms() + built.NumNonTerms();
+       ++nt) {
+    for (int t = 0; t < built.NumTerms(); ++t) {
+      EXPECT_EQ(built.At(nt, t), embedded.At(nt, t));
+    }
+  }
+  for (int p = 0; p < built.NumProductions(); ++p) {
+    EXPECT_EQ(std::vector<int16_t>(built.RhsBegin(p), built.RhsEnd(p)),
+              std::vector<int16_t>(embedded.RhsBegin(p), embedded.RhsEnd(p)));
+    EXPECT_EQ(std::vector<int16_t>(built.ExpansionBegin(p),
+                                   built.ExpansionEnd(p)),
+              std::vector<int16_t>(embedded.ExpansionBegin(p),
+                                   embedded.ExpansionEnd(p)));
+  }
+  for (int type = 0; type <= static_cast<int>(TokenType::EOS); ++type) {
+    EXPECT_EQ(built.TermOf(static_cast<TokenType>(type)),
+              embedded.TermOf(static_cast<TokenType>(type)));
+  }
+}
+
+// Every entry must expand to the production the generator's table holds.
+TEST_F(ParseTableTest, TestEntriesMatchParserGenerator) {
+  for (auto it = grammar.Begin(); it != grammar.End(); ++it) {
+    int nt = IdOf(embedded, it->first.Str());
+    ASSERT_TRUE(embedded.IsNonTerm(nt)) << it->first;
+    for (int t = 0; t < embedded.NumTerms(); ++t) {
+      Symbol term(embedded.Name(t));
+      int prod = embedded.At(nt, t);
+      ASSERT_EQ(pgen.TableValid(it->first, term), prod != -1)
+          << it->first << ", " << term;
+      if (prod == -1) {
+        continue;
+      }
+      std::vector<std::string> expected_rhs;
+      for (const Symbol& symb : pgen.TableAt(it->first, term).second) {
+        expected_rhs.push_back(symb.Str());
+      }
+      std::vector<std::string> actual_rhs;
+      for (const int16_t* s = embedded.RhsBegin(prod);
+           s != embedded.RhsEnd(prod); ++s) {
+        actual_rhs.push_back(embedded.Name(*s));
+      }
+      EXPECT_EQ(expected_rhs, actual_rhs) << it->first << ", " << term;
+    }
+  }
+}
+
+// Expansions are the rhs reversed, without EPSILON.
+TEST_F(ParseTableTest, TestExpansions) {
+  for (int p = 0; p < embedded.NumProductions(); ++p) {
+    std::vector<int16_t> expected;
+    for (const int16_t* s = embedded.RhsEnd(p); s != embedded.RhsBegin(p);) {
+      if (*--s != embedded.Epsilon()) {
+        expected.push_back(*s);
+      }
+    }
+    EXPECT_EQ(expected, std::vector<int16_t>(embedded.ExpansionBegin(p),
+                                             embedded.ExpansionEnd(p)));
+  }
+  // <prog> ::= !sem_start_prog! ... 'main' <funcBody> !sem_end_main!
+  //            !sem_end_prog!
+  int prod = embedded.At(IdOf(embedded, "<prog>"), IdOf(embedded, "'main'"));
+  ASSERT_NE(-1, prod);
+  const int16_t* expansion = embedded.ExpansionBegin(prod);
+  ASSERT_EQ(12, embedded.ExpansionEnd(prod) - expansion);
+  EXPECT_EQ(IdOf(embedded, "!sem_end_prog!"), expansion[0]);
+  EXPECT_EQ(IdOf(embedded, "!sem_end_main!"), expansion[1]);
+  EXPECT_EQ(IdOf(embedded, "<funcBody>"), expansion[2]);
+  EXPECT_EQ(IdOf(embedded, "'main'"), expansion[3]);
+  EXPECT_EQ(IdOf(embedded, "!sem_start_prog!"), expansion[11]);
+}
+
+TEST_F(ParseTableTest, TestActions) {
+  auto action = [&](const std::string& name) {
+    return embedded.Action(IdOf(embedded, name));
+  };
+  EXPECT_EQ(ActionType::END_SIGN, action("!sem_end_sign!").type);
+  EXPECT_EQ(ActionType::END_SCOPERES, action("!sem_end_scoperes!").type);
+  EXPECT_EQ(NodeKind::SCOPE_RES, action("!sem_end_scoperes!").node_kind);
+  EXPECT_EQ(ActionType::START, action("!sem_start_datamemorfcall!").type);
+  EXPECT_EQ(ActionType::END, action("!sem_end_funcdef!").type);
+  EXPECT_EQ(NodeKind::FUNC_DEF, action("!sem_end_funcdef!").node_kind);
+  EXPECT_EQ(ActionType::PUSH, action("!sem_push_type!").type);
+  EXPECT_EQ(NodeKind::TYPE, action("!sem_push_type!").node_kind);
+  EXPECT_EQ(NodeKind::DIM, action("!sem_push_dim!").node_kind);
+  EXPECT_EQ(NodeKind::NONE, action("!sem_push_id!").node_kind);
+  EXPECT_EQ(ActionType::OP, action("!sem_op_addop!").type);
+  for (int symb = 0; symb < embedded.NumSymbols(); ++symb) {
+    if (embedded.IsAction(symb)) {
+      EXPECT_NE(ActionType::NONE, embedded.Action(symb).type)
+          << embedded.Name(symb);
+    }
+  }
+}
+
+// The synchronization sets are the generator's first and follow sets.
+TEST_F(ParseTableTest, TestSyncSets) {
+  for (auto it = grammar.Begin(); it != grammar.End(); ++it) {
+    int nt = IdOf(embedded, it->first.Str());
+    const Set& first = pgen.FirstSets().at(it->first);
+    const Set& follow = pgen.FollowSets().at(it->first);
+    for (int t = 0; t < embedded.NumTerms(); ++t) {
+      Symbol term(embedded.Name(t));
+      if (term.Type() == SymbolType::EPSILON) {
+        continue;
+      }
+      EXPECT_EQ(first.count(term) == 1, embedded.InFirst(nt, t))
+          << it->first << ", " << term;
+      EXPECT_EQ(follow.count(term) == 1, embedded.InFollow(nt, t))
+          << it->first << ", " << term;
+    }
+  }
+  EXPECT_TRUE(embedded.InFollow(embedded.Start(), embedded.End()));
+  EXPECT_FALSE(embedded.InFirst(embedded.Start(), -1));
+}
+
+TEST_F(ParseTableTest, TestSymbolKinds) {
+  EXPECT_TRUE(embedded.IsNonTerm(embedded.Start()));
+  EXPECT_STREQ("<START>", embedded.Name(embedded.Start()));
+  EXPECT_TRUE(embedded.IsTerm(embedded.End()));
+  EXPECT_STREQ("'$'", embedded.Name(embedded.End()));
+  EXPECT_STREQ("EPSILON", embedded.Name(embedded.Epsilon()));
+  EXPECT_TRUE(embedded.IsAction(IdOf(embedded, "!sem_end_prog!")));
+  EXPECT_EQ(IdOf(embedded, "'id'"), embedded.TermOf(TokenType::ID));
+  EXPECT_EQ(embedded.End(), embedded.TermOf(TokenType::EOS));
+  EXPECT_EQ(-1, embedded.TermOf(TokenType::INVALID_CHAR));
+  EXPECT_EQ(-1, embedded.At(embedded.Start(), -1));
+}
+
+TEST_F(ParseTableTest, TestParseWithBuiltTable) {
+  ParseTable built(grammar, pgen);
+  std::ifstream file_stream("../test/fixtures/parser/polynomial-errors.src");
+  Lexer lexer(file_stream);
+  Parser parser(lexer, built);
+  parser.Parse();
+  std::vector<std::string> expected_errors = {
+      "SyntaxError: Expected '';'', but next token was '}' (line 20) \n"};
+  EXPECT_EQ(expected_errors, Logger::GetErrors());
+}
+
+}  // namespace parsetabletest
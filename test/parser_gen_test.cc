@@ -1,5 +1,7 @@
 #include "parser_gen.h"
 
+#include <sstream>
+
 #include "gtest/gtest.h"
 
 namespace pgentest {
@@ -805,4 +807,53 @@ TEST_F(ParserGenTest, TestMemberVarDeclFactor) {
   EXPECT_EQ(expected_follow_set, actual_follow_set);
 }
 
+// A chain of thousands of productions, each non-terminal's sets depending on
+// the next one's:
+//   <nI> ::= <mI> <nI+1> 'tJ' | EPSILON
+//   <mI> ::= 'aJ' | EPSILON
+// with J = I % 50, so FIRST(<nI>) holds every 'aJ' and 'tJ' from I on.
+TEST_F(ParserGenTest, TestLongChainGrammar) {
+  const int N = 1000;
+  const int K = 50;
+  auto n = [](int i) { return "<n" + std::to_string(i) + ">"; };
+  auto m = [](int i) { return "<m" + std::to_string(i) + ">"; };
+  auto a = [](int i) { return Symbol("'a" + std::to_string(i % K) + "'"); };
+  auto t = [](int i) { return Symbol("'t" + std::to_string(i % K) + "'"); };
+  std::stringstream ss;
+  ss << "<START> ::= " << n(0) << "\n";
+  for (int i = 0; i < N; ++i) {
+    ss << n(i) << " ::= " << m(i) << " " << n(i + 1) << " " << t(i) << "\n";
+    ss << n(i) << " ::= EPSILON\n";
+    ss << m(i) << " ::= " << a(i) << "\n";
+    ss << m(i) << " ::= EPSILON\n";
+  }
+  ss << n(N) << " ::= EPSILON\n";
+  Grammar grammar(ss);
+  ParserGenerator chain_pgen(grammar);
+  const Sets& first_sets = chain_pgen.FirstSets();
+  const Sets& follow_sets = chain_pgen.FollowSets();
+
+  Symbol epsilon(SymbolType::EPSILON);
+  Set expected_first_n = {epsilon};
+  Set expected_follow_n = {t(N - 1)};
+  EXPECT_EQ(expected_first_n, first_sets.at(Symbol(n(N))));
+  EXPECT_EQ(expected_follow_n, follow_sets.at(Symbol(n(N))));
+  for (int i = N - 1; i >= 0; --i) {
+    Set expected_follow_m = expected_first_n;
+    expected_follow_m.erase(epsilon);
+    expected_follow_m.insert(t(i));
+    expected_first_n.insert(a(i));
+    expected_first_n.insert(t(i));
+    expected_follow_n = {i == 0 ? Symbol(SymbolType::END) : t(i - 1)};
+    Set expected_first_m = {a(i), epsilon};
+
+    ASSERT_EQ(expected_first_n, first_sets.at(Symbol(n(i)))) << n(i);
+    ASSERT_EQ(expected_follow_n, follow_sets.at(Symbol(n(i)))) << n(i);
+    ASSERT_EQ(expected_first_m, first_sets.at(Symbol(m(i)))) << m(i);
+    ASSERT_EQ(expected_follow_m, follow_sets.at(Symbol(m(i)))) << m(i);
+  }
+  // Every non-terminal, and every terminal as each follows a non-terminal
+  EXPECT_EQ(2 * N + 2 + 2 * K, static_cast<int>(first_sets.size()));
+}
+
 }  // namespace pgentest
\ No newline at end of file
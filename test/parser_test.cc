@@ -1,8 +1,11 @@
 #include "parser.h"
 
+#include <cstdio>
+
 #include "gtest/gtest.h"
 #include "lexer.h"
 #include "logger.h"
+#include "source_buffer.h"
 
 namespace parsertest {
 
@@ -14,14 +17,22 @@ class ParserTest : public ::testing::Test {
   virtual ~ParserTest() {}
   virtual void SetUp() { Logger::Clear(); }
   virtual void TearDown() {}
+
+  static std::string ToDot(std::shared_ptr<ASTNode> ast) {
+    if (!ast) {
+      return "";
+    }
+    ast->ToDotFile("../test/fixtures/ast/test.gv");
+    std::ifstream ifs("../test/fixtures/ast/test.gv");
+    return std::string((std::istreambuf_iterator<char>(ifs)),
+                       std::istreambuf_iterator<char>());
+  }
 };
 
 TEST_F(ParserTest, Test1) {
   std::ifstream file_stream("../test/fixtures/parser/minProg.src");
   Lexer lexer(file_stream);
-  Grammar grammar;
-  ParserGenerator pgen(grammar);
-  Parser parser(lexer, pgen);
+  Parser parser(lexer);
   parser.Parse();
   EXPECT_FALSE(Logger::HasErrors());
 }
@@ -29,9 +40,7 @@ TEST_F(ParserTest, Test1) {
 TEST_F(ParserTest, Test2) {
   std::ifstream file_stream("../test/fixtures/parser/bubblesort.src");
   Lexer lexer(file_stream);
-  Grammar grammar;
-  ParserGenerator pgen(grammar);
-  Parser parser(lexer, pgen);
+  Parser parser(lexer);
   parser.Parse();
   EXPECT_FALSE(Logger::HasErrors());
 }
@@ -39,9 +48,7 @@ TEST_F(ParserTest, Test2) {
 TEST_F(ParserTest, Test3) {
   std::ifstream file_stream("../test/fixtures/parser/polynomial-errors.src");
   Lexer lexer(file_stream);
-  Grammar grammar;
-  ParserGenerator pgen(grammar);
-  Parser parser(lexer, pgen);
+  Parser parser(lexer);
   parser.Parse();
   std::vector<std::string> actual_errors = Logger::GetErrors();
   std::vector<std::string> expected_errors = {
@@ -50,4 +57,129 @@ TEST_F(ParserTest, Test3) {
   EXPECT_EQ(actual_errors, expected_errors);
 }
 
+// Each error is reported once, parsing resuming at the next statement.
+TEST_F(ParserTest, TestRecovery) {
+  SourceBuffer buf = SourceBuffer::FromString(
+      "main\n"
+      "  local\n"
+      "    integer x;\n"
+      "  do\n"
+      "    x = 1\n"
+      "    write(x);\n"
+      "    x = x + ;\n"
+      "    write(x);\n"
+      "  end\n");
+  Lexer lexer(buf, LexerMode::DFA);
+  TokenArray tokens = lexer.TokenizeAll();
+  Parser parser(tokens);
+  EXPECT_EQ(nullptr, parser.Parse());
+  std::vector<std::string> expected_errors = {
+      "SyntaxError: Expected '<termRightRec>', but next token was 'write' "
+      "(line 6) \n",
+      "SyntaxError: Expected '<term>', but next token was ';' (line 7) \n"};
+  EXPECT_EQ(expected_errors, Logger::GetErrors());
+  ASSERT_EQ(2u, parser.RecoveryPoints().size());
+  EXPECT_EQ(6, parser.RecoveryPoints()[0].error_line);
+  EXPECT_EQ(6, parser.RecoveryPoints()[0].resume_line);
+  EXPECT_EQ(0, parser.RecoveryPoints()[0].skipped);
+  EXPECT_EQ(7, parser.RecoveryPoints()[1].error_line);
+}
+
+TEST_F(ParserTest, TestMaxErrors) {
+  std::string text = "main\n  do\n";
+  for (int i = 0; i < 10; ++i) {
+    text += "    write(1)\n";
+  }
+  text += "  end\n";
+  SourceBuffer buf = SourceBuffer::FromString(text);
+  Lexer lexer(buf, LexerMode::DFA);
+  TokenArray tokens = lexer.TokenizeAll();
+  Parser parser(tokens);
+  parser.SetMaxErrors(3);
+  EXPECT_EQ(nullptr, parser.Parse());
+  EXPECT_EQ(3u, Logger::GetErrors().size());
+  EXPECT_EQ(3u, parser.RecoveryPoints().size());
+  std::vector<std::string> warnings = Logger::GetWarnings();
+  ASSERT_FALSE(warnings.empty());
+  EXPECT_NE(std::string::npos,
+            warnings.back().find("Too many syntax errors"));
+}
+
+// Both modes build the same AST and report the same first syntax error.
+TEST_F(ParserTest, TestRecursiveDescentMatchesTable) {
+  for (const char* name :
+       {"astSimple", "astsimple2", "bubblesort", "conditionals", "demo",
+        "minProg", "multRelexpr", "polynomial-errors", "polynomial",
+        "polynomial2", "simpleFuncs", "simplemain"}) {
+    std::string path = std::string("../test/fixtures/parser/") + name + ".src";
+    SourceBuffer buf = SourceBuffer::FromFile(path);
+    Lexer lexer(buf, LexerMode::DFA);
+    TokenArray tokens = lexer.TokenizeAll();
+    Logger::Clear();
+    Parser table_parser(tokens);
+    std::string expected_ast = ToDot(table_parser.Parse());
+    std::vector<std::string> expected_errors = Logger::GetErrors();
+    Logger::Clear();
+
+    Parser rd_parser(tokens);
+    rd_parser.SetMode(ParserMode::RECURSIVE_DESCENT);
+    EXPECT_EQ(expected_ast, ToDot(rd_parser.Parse())) << path;
+    std::vector<std::string> actual_errors = Logger::GetErrors();
+    if (expected_errors.empty()) {
+      EXPECT_TRUE(actual_errors.empty()) << path;
+    } else {
+      ASSERT_EQ(1u, actual_errors.size()) << path;
+      EXPECT_EQ(expected_errors.front(), actual_errors.front()) << path;
+    }
+  }
+}
+
+TEST_F(ParserTest, TestDerivationLog) {
+  const std::string path = "../out/outderivation";
+  std::remove(path.c_str());
+  SourceBuffer buf = SourceBuffer::FromString("main do end");
+  Lexer lexer(buf, LexerMode::DFA);
+  TokenArray tokens = lexer.TokenizeAll();
+  // Nothing is logged by default.
+  Parser(tokens).Parse();
+  EXPECT_FALSE(std::ifstream(path).good());
+  {
+    TraceSink sink(path);
+    Parser parser(tokens);
+    parser.SetDerivationLog(&sink);
+    parser.Parse();
+    EXPECT_FALSE(std::ifstream(path).good());
+  }
+  std::ifstream ifs(path);
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(ifs, line);) {
+    lines.push_back(line);
+  }
+  ASSERT_FALSE(lines.empty());
+  EXPECT_EQ("<START>", lines.front());
+  EXPECT_EQ("<prog>", lines[1]);
+  EXPECT_EQ("# Parsing ok", lines.back());
+}
+
+TEST_F(ParserTest, TestTokenArrayMatchesLexer) {
+  for (const char* name :
+       {"minProg", "bubblesort", "polynomial-errors"}) {
+    std::string path = std::string("../test/fixtures/parser/") + name + ".src";
+    std::ifstream file_stream(path);
+    Lexer stream_lexer(file_stream);
+    Parser stream_parser(stream_lexer);
+    std::string expected_ast = ToDot(stream_parser.Parse());
+    std::vector<std::string> expected_errors = Logger::GetErrors();
+    Logger::Clear();
+
+    SourceBuffer buf = SourceBuffer::FromFile(path);
+    Lexer buffer_lexer(buf, LexerMode::DFA);
+    TokenArray tokens = buffer_lexer.TokenizeAll();
+    Parser array_parser(tokens);
+    EXPECT_EQ(expected_ast, ToDot(array_parser.Parse())) << path;
+    EXPECT_EQ(expected_errors, Logger::GetErrors()) << path;
+    Logger::Clear();
+  }
+}
+
 }  // namespace parsertest
\ No newline at end of file
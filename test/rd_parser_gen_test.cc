@@ -0,0 +1,59 @@
+#include "rd_parser_gen.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+namespace rdparsergentest {
+
+using namespace toy;
+
+class RecursiveDescentGeneratorTest : public ::testing::Test {
+ protected:
+  RecursiveDescentGeneratorTest() {}
+  virtual ~RecursiveDescentGeneratorTest() {}
+  virtual void SetUp() {}
+  virtual void TearDown() {}
+  Grammar grammar;
+  ParserGenerator pgen = ParserGenerator(grammar);
+  ParseTable table{grammar, pgen};
+
+  std::string Generate() const {
+    std::ostringstream oss;
+    RecursiveDescentGenerator(table).WriteSource(oss);
+    return oss.str();
+  }
+};
+
+// The compiled in parser must be the one the grammar file gives today. Tests
+// run from the build directory, which the parser is generated into.
+TEST_F(RecursiveDescentGeneratorTest, TestCompiledMatchesGrammar) {
+  std::ifstream ifs("rd_parser.cc");
+  ASSERT_TRUE(ifs.good());
+  std::string compiled((std::istreambuf_iterator<char>(ifs)),
+                       std::istreambuf_iterator<char>());
+  EXPECT_EQ(compiled, Generate());
+}
+
+TEST_F(RecursiveDescentGeneratorTest, TestFunctions) {
+  std::string src = Generate();
+  // One function per non-terminal
+  EXPECT_NE(std::string::npos,
+            src.find("void RecursiveDescentParser::Prog() {"));
+  EXPECT_NE(std::string::npos,
+            src.find("void RecursiveDescentParser::AParamsTail() {"));
+  // Repetitions loop rather than recurse
+  std::size_t rept =
+      src.find("void RecursiveDescentParser::StatementRept0() {");
+  ASSERT_NE(std::string::npos, rept);
+  std::size_t next = src.find("void RecursiveDescentParser::", rept + 1);
+  EXPECT_LT(src.find("for (;;)", rept), next);
+  EXPECT_LT(src.find("continue;", rept), next);
+  // Actions are direct calls
+  EXPECT_NE(std::string::npos,
+            src.find("parser_.EndAction(NodeKind::FUNC_DEF);"));
+  EXPECT_NE(std::string::npos, src.find("case TokenType::SEMICOLON:"));
+}
+
+}  // namespace rdparsergentest
@@ -1,7 +1,14 @@
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+
 #include "ast.h"
+#include "fused_semantic_visitor.h"
 #include "gtest/gtest.h"
 #include "logger.h"
+#include "parallel_semantic_pass.h"
 #include "parser.h"
+#include "symbol_table.h"
 #include "symbol_table_visitor.h"
 #include "type_check_visitor.h"
 
@@ -15,16 +22,27 @@ class SemanticTest : public ::testing::Test {
   virtual void TearDown() {}
 };
 
-// Lex, parse and detect semantic errors for the given file
-void SemanticTestHelper(const std::string& filepath) {
+// The fixtures the fused and parallel passes are checked against the type
+// checker on
+static const char* const SEMANTIC_FIXTURES[] = {
+    "Test1", "Test2", "Test3", "Test4", "Test5", "Test6", "Test7",
+    "Test8", "Test9", "Test10", "Test11", "Test12", "Test13",
+    "bubblesort", "bubblesorttest"};
+
+// Lex, parse and build the symbol tables for the given file
+std::shared_ptr<toy::ASTNode> BuildSymbolTables(const std::string& filepath) {
   std::ifstream prog_stream(filepath);
   toy::Lexer lexer(prog_stream);
-  toy::Grammar grammar;
-  toy::ParserGenerator pgen(grammar);
-  toy::Parser parser(lexer, pgen);
+  toy::Parser parser(lexer);
   auto ast = parser.Parse();
   toy::SymbolTableVisitor symtab_visitor;
   ast->Accept(symtab_visitor);
+  return ast;
+}
+
+// Lex, parse and detect semantic errors for the given file
+void SemanticTestHelper(const std::string& filepath) {
+  auto ast = BuildSymbolTables(filepath);
   toy::TypeCheckVisitor typecheck_visitor;
   ast->Accept(typecheck_visitor);
 }
@@ -279,4 +297,196 @@ TEST_F(SemanticTest, TestSemantic13) {
   EXPECT_EQ(expected_errors, actual_errors);
 }
 
+// The fused semantic pass reports the same errors and warnings, in the same
+// order, and does not size programs with symbol table errors.
+TEST_F(SemanticTest, TestFusedSemanticPass) {
+  for (const char* name : SEMANTIC_FIXTURES) {
+    std::string path =
+        std::string("../test/fixtures/semantic/") + name + ".src";
+    toy::Logger::Clear();
+    SemanticTestHelper(path);
+    std::vector<std::string> expected_errors = toy::Logger::GetErrors();
+    std::vector<std::string> expected_warnings = toy::Logger::GetWarnings();
+    toy::Logger::Clear();
+
+    auto ast = BuildSymbolTables(path);
+    bool symtab_errors = toy::Logger::HasErrors();
+    toy::FusedSemanticVisitor fused_visitor;
+    ast->Accept(fused_visitor);
+    EXPECT_EQ(expected_errors, toy::Logger::GetErrors()) << path;
+    EXPECT_EQ(expected_warnings, toy::Logger::GetWarnings()) << path;
+    EXPECT_EQ(!symtab_errors, fused_visitor.Sized()) << path;
+  }
+}
+
+// So does the parallel one, whatever the number of threads, sizing only the
+// programs without errors.
+TEST_F(SemanticTest, TestParallelSemanticPass) {
+  for (const char* name : SEMANTIC_FIXTURES) {
+    std::string path =
+        std::string("../test/fixtures/semantic/") + name + ".src";
+    toy::Logger::Clear();
+    SemanticTestHelper(path);
+    std::vector<std::string> expected_errors = toy::Logger::GetErrors();
+    std::vector<std::string> expected_warnings = toy::Logger::GetWarnings();
+
+    for (unsigned num_threads : {1, 4}) {
+      toy::Logger::Clear();
+      auto ast = BuildSymbolTables(path);
+      toy::ParallelSemanticPass parallel_pass(num_threads);
+      parallel_pass.Run(*ast);
+      EXPECT_EQ(expected_errors, toy::Logger::GetErrors()) << path;
+      EXPECT_EQ(expected_warnings, toy::Logger::GetWarnings()) << path;
+      EXPECT_EQ(expected_errors.empty(), parallel_pass.Sized()) << path;
+    }
+  }
+}
+
+TEST_F(SemanticTest, TestSymbolTableLookup) {
+  auto global = std::make_shared<toy::SymbolTable>("global", nullptr, 0);
+  auto classtab = std::make_shared<toy::SymbolTable>("A", global, 1);
+  global->AddEntry(std::make_shared<toy::ClassEntry>("A", 1, classtab));
+  auto functab = std::make_shared<toy::SymbolTable>("f", nullptr, 1);
+  functab->AddEntry(std::make_shared<toy::LocalVarEntry>(
+      "x", "integer", 2, nullptr, std::vector<std::string>()));
+  for (int i = 1; i <= 1000; ++i) {
+    functab->AddEntry(std::make_shared<toy::LocalVarEntry>(
+        "temp" + std::to_string(i), "integer", 3, nullptr,
+        std::vector<std::string>()));
+  }
+  // Linked after its entries were added, with strings of its own
+  functab->SetParent(global);
+
+  EXPECT_EQ("x", functab->GetEntry(toy::EntryKind::LOCAL, "x")->Name());
+  EXPECT_EQ("temp1000", functab->GetEntry("temp1000")->Name());
+  EXPECT_EQ(global->GetEntry("A"),
+            functab->GetEntry(toy::EntryKind::CLASS, "A"));
+  EXPECT_EQ(nullptr, functab->GetEntry(toy::EntryKind::LOCAL, "A"));
+  EXPECT_EQ(nullptr, functab->GetEntry("temp1001"));
+  EXPECT_EQ(nullptr, global->GetEntry("x"));
+
+  // By name alone, the first kind in order comes first, class before local
+  classtab->AddEntry(std::make_shared<toy::LocalVarEntry>(
+      "A", "integer", 4, nullptr, std::vector<std::string>()));
+  classtab->AddEntry(std::make_shared<toy::ClassEntry>("A", 4, nullptr));
+  EXPECT_EQ(toy::EntryKind::CLASS, classtab->GetEntry("A")->Kind());
+  EXPECT_EQ(toy::EntryKind::LOCAL,
+            classtab->GetEntry(toy::EntryKind::LOCAL, "A")->Kind());
+
+  // The member function definitions are no longer found once removed
+  global->AddEntry(std::make_shared<toy::FreeFuncEntry>(
+      "g", "integer", 5, nullptr,
+      std::vector<std::pair<std::string, std::string>>(), "A"));
+  EXPECT_NE(nullptr, global->GetEntry(toy::EntryKind::FUNC, "A::g()"));
+  global->RemoveMemberFunctionDefinitions();
+  EXPECT_EQ(nullptr, global->GetEntry(toy::EntryKind::FUNC, "A::g()"));
+  EXPECT_EQ(nullptr, functab->GetEntry("A::g()"));
+  EXPECT_NE(nullptr, functab->GetEntry(toy::EntryKind::CLASS, "A"));
+}
+
+TEST_F(SemanticTest, TestSymbolTableLookupCache) {
+  auto global = std::make_shared<toy::SymbolTable>("global", nullptr, 0);
+  auto classtab = std::make_shared<toy::SymbolTable>("A", global, 1);
+  auto functab = std::make_shared<toy::SymbolTable>("f", global, 1);
+  auto local = [](const std::string& name, int line) {
+    return std::make_shared<toy::LocalVarEntry>(name, "integer", line, nullptr,
+                                                std::vector<std::string>());
+  };
+  global->AddEntry(local("x", 1));
+  classtab->AddEntry(local("y", 2));
+
+  // Cached, found and not found, until the tables change
+  EXPECT_EQ(1, functab->GetEntry(toy::EntryKind::LOCAL, "x")->Line());
+  EXPECT_EQ(nullptr, functab->GetEntry(toy::EntryKind::LOCAL, "y"));
+  EXPECT_EQ(1, functab->GetEntry(toy::EntryKind::LOCAL, "x")->Line());
+  EXPECT_EQ(nullptr, functab->GetEntry("y"));
+
+  // Re-parented under the class
+  functab->SetParent(classtab);
+  EXPECT_EQ(2, functab->GetEntry(toy::EntryKind::LOCAL, "y")->Line());
+  EXPECT_EQ(2, functab->GetEntry("y")->Line());
+  EXPECT_EQ(1, functab->GetEntry("x")->Line());
+
+  // An ancestor gets an entry
+  EXPECT_EQ(nullptr, functab->GetEntry(toy::EntryKind::LOCAL, "z"));
+  global->AddEntry(local("z", 3));
+  EXPECT_EQ(3, functab->GetEntry(toy::EntryKind::LOCAL, "z")->Line());
+
+  // The table itself gets entries hiding the cached ones
+  functab->AddEntry(local("x", 4));
+  functab->AddEntry(local("w", 5));
+  EXPECT_EQ(4, functab->GetEntry(toy::EntryKind::LOCAL, "x")->Line());
+  EXPECT_EQ(4, functab->GetEntry("x")->Line());
+  EXPECT_EQ(5, functab->GetEntry("w")->Line());
+  EXPECT_EQ(1, classtab->GetEntry("x")->Line());
+
+  // A cached lookup is no entry of the table
+  functab->AddEntry(local("y", 6));
+  EXPECT_TRUE(toy::Logger::GetErrors().empty());
+  EXPECT_EQ(6, functab->GetEntry("y")->Line());
+
+  // While concurrent, the lookups still find the entries, and only names
+  // interned beforehand may be added
+  global->SetConcurrent(true);
+  EXPECT_EQ(3, functab->GetEntry("z")->Line());
+  EXPECT_EQ(nullptr, functab->GetEntry("v"));
+  EXPECT_THROW(functab->AddEntry(local("v", 7)), std::logic_error);
+  functab->InternName("u");
+  functab->AddEntry(local("u", 8));
+  EXPECT_EQ(8, functab->GetEntry("u")->Line());
+  global->SetConcurrent(false);
+  functab->AddEntry(local("v", 7));
+  EXPECT_EQ(7, functab->GetEntry("v")->Line());
+}
+
+TEST_F(SemanticTest, TestFuncCallResolution) {
+  std::istringstream src(
+      "class A {\n"
+      "  public get(integer x) : integer;\n"
+      "};\n"
+      "A::get(integer x) : integer\n"
+      "  do\n"
+      "    return (x);\n"
+      "  end\n"
+      "f(float y) : integer\n"
+      "  do\n"
+      "    return (1);\n"
+      "  end\n"
+      "main\n"
+      "  local\n"
+      "    A a;\n"
+      "    integer r;\n"
+      "  do\n"
+      "    r = a.get(2) + f(1.5);\n"
+      "  end\n");
+  toy::Lexer lexer(src);
+  toy::Parser parser(lexer);
+  auto ast = parser.Parse();
+  toy::SymbolTableVisitor symtab_visitor;
+  ast->Accept(symtab_visitor);
+  toy::TypeCheckVisitor typecheck_visitor;
+  ast->Accept(typecheck_visitor);
+  EXPECT_TRUE(toy::Logger::GetErrors().empty());
+
+  // Each call resolves to the definition of the function it calls
+  std::vector<toy::FuncCallNode*> calls;
+  std::function<void(toy::ASTNode*)> find_calls = [&](toy::ASTNode* node) {
+    if (node->Kind() == toy::NodeKind::FCALL) {
+      calls.push_back(static_cast<toy::FuncCallNode*>(node));
+    }
+    for (auto child : node->Children()) {
+      find_calls(child);
+    }
+  };
+  find_calls(ast.get());
+  toy::FuncTable& funcs = ast->Funcs();
+  ASSERT_EQ(2u, funcs.Size());
+  ASSERT_EQ(2u, calls.size());
+  EXPECT_EQ("A::get(integer)", funcs.Func(calls[0]->func).Signature());
+  EXPECT_EQ("Agetinteger", funcs.Label(calls[0]->func));
+  EXPECT_EQ("::f(float)", funcs.Func(calls[1]->func).Signature());
+  EXPECT_EQ("ffloat", funcs.Label(calls[1]->func));
+  EXPECT_THROW(funcs.Label(toy::FuncTable::NONE), std::out_of_range);
+}
+
 }  // namespace semantictest
\ No newline at end of file
@@ -0,0 +1,32 @@
+// Generates the C++ source of the recursive-descent parser compiled into the
+// toy library.
+// Usage: gen_rd_parser <grammar file> <output file>
+
+#include <fstream>
+#include <iostream>
+
+#include "grammar.h"
+#include "parse_table.h"
+#include "parser_gen.h"
+#include "rd_parser_gen.h"
+
+using namespace toy;
+
+int main(int argc, char* argv[]) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <grammar file> <output file>"
+              << std::endl;
+    return 1;
+  }
+  std::ifstream grammar_file(argv[1]);
+  if (!grammar_file.good()) {
+    std::cerr << "No such file " << argv[1] << std::endl;
+    return 1;
+  }
+  Grammar grammar(argv[1]);
+  ParserGenerator pgen(grammar);
+  ParseTable table(grammar, pgen);
+  std::ofstream ofs(argv[2]);
+  RecursiveDescentGenerator(table).WriteSource(ofs);
+  return ofs.good() ? 0 : 1;
+}